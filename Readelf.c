@@ -17,10 +17,38 @@ char *programName;
 
 bool fileHeaderOpt = false;
 bool sectionHeaderOpt = false;
+bool programHeaderOpt = false;
+bool symbolOpt = false;
+bool relocationOpt = false;
+bool relocSummaryOpt = false;
+bool startupCostOpt = false;
+bool depsOpt = false;
+bool unresolvedOpt = false;
+
+char *addressFile = NULL;
+char *lookupSymbol = NULL;
+const char *sysrootDir = NULL;
+char **libPaths;
+int libPathCount = 0;
+char **scanDirs;
+int scanDirCount = 0;
 bool hexDumpOpt = false;
+bool decompressOpt = false;
 
 int hexDumpSection;
 
+int workerCount = 0; // 0 until -j is given
+int poolWorkerCount = 0;
+bool uringOpt = true;
+
+char *cacheDir = NULL;
+uint64_t cacheLimit = (uint64_t)CACHE_DEFAULT_LIMIT_MB << 20;
+
+char *servePath = NULL;
+uint64_t serverMemoryLimit = (uint64_t)SERVER_DEFAULT_MEMORY_MB << 20;
+
+int outputFormat = OUTPUT_TEXT;
+
 /**
  * The main driver for the lab05 ReadELF program. It takes the '-h'
  * option to specify header reading for the second argument - a file name.
@@ -30,7 +58,8 @@ int hexDumpSection;
 int main(int argc, char *argv[]) {
 
    int i;
-   char ch;
+   int ch;
+   char *end;
    bool *hexDumpArgs;
 
    // Set global program name
@@ -38,14 +67,35 @@ int main(int argc, char *argv[]) {
 
    // Allocate memory for arg bool array
    hexDumpArgs = malloc(argc);
+   libPaths = malloc(argc * sizeof(char *));
+   scanDirs = malloc(argc * sizeof(char *));
 
    // Intialize hexDumpArgs bools
    for (i = 0; i < argc; i++) {
       hexDumpArgs[i] = false;
    }
 
+   // Long options
+   static const struct option longOptions[] = {
+      { "lookup-symbol", required_argument, NULL, OPT_LOOKUP_SYMBOL },
+      { "reloc-summary", no_argument,       NULL, OPT_RELOC_SUMMARY },
+      { "startup-cost",  no_argument,       NULL, OPT_STARTUP_COST },
+      { "deps",          no_argument,       NULL, OPT_DEPS },
+      { "sysroot",       required_argument, NULL, OPT_SYSROOT },
+      { "lib-path",      required_argument, NULL, OPT_LIB_PATH },
+      { "unresolved",    no_argument,       NULL, OPT_UNRESOLVED },
+      { "no-uring",      no_argument,       NULL, OPT_NO_URING },
+      { "cache",         required_argument, NULL, OPT_CACHE },
+      { "cache-limit",   required_argument, NULL, OPT_CACHE_LIMIT },
+      { "serve",         required_argument, NULL, OPT_SERVE },
+      { "serve-memory",  required_argument, NULL, OPT_SERVE_MEMORY },
+      { "output",        required_argument, NULL, OPT_OUTPUT },
+      { "decompress",    no_argument,       NULL, 'z' },
+      { NULL, 0, NULL, 0 }
+   };
+
    // Process arg opts
-   while ((ch = getopt(argc, argv, "hxt")) != -1) {
+   while ((ch = getopt_long(argc, argv, "hxtlsrzy:j:R:", longOptions, NULL)) != -1) {
       switch(ch) {
          case 'h':
             fileHeaderOpt = true;
@@ -53,40 +103,171 @@ int main(int argc, char *argv[]) {
          case 't':
             sectionHeaderOpt = true;
             break;
+         case 'l':
+            programHeaderOpt = true;
+            break;
+         case 's':
+            symbolOpt = true;
+            break;
+         case 'r':
+            relocationOpt = true;
+            break;
+         case OPT_RELOC_SUMMARY:
+            relocationOpt = true;
+            relocSummaryOpt = true;
+            break;
+         case OPT_STARTUP_COST:
+            startupCostOpt = true;
+            break;
+         case OPT_DEPS:
+            depsOpt = true;
+            break;
+         case OPT_SYSROOT:
+            sysrootDir = optarg;
+            break;
+         case OPT_LIB_PATH:
+            libPaths[libPathCount++] = optarg;
+            break;
+         case OPT_UNRESOLVED:
+            unresolvedOpt = true;
+            break;
+         case OPT_NO_URING:
+            uringOpt = false;
+            break;
+         case OPT_CACHE:
+            cacheDir = optarg;
+            break;
+         case OPT_CACHE_LIMIT:
+            cacheLimit = strtoull(optarg, &end, 10) << 20;
+            if (*end != '\0' || cacheLimit == 0) {
+               printUsage(programName);
+               exit(EXIT_FAILURE);
+            }
+            break;
+         case 'y':
+            addressFile = optarg;
+            break;
          case 'x':
             hexDumpOpt = true;
             hexDumpArgs[optind++] = true;
             break;
+         case 'z':
+            decompressOpt = true;
+            break;
+         case OPT_LOOKUP_SYMBOL:
+            lookupSymbol = optarg;
+            break;
+         case 'R':
+            scanDirs[scanDirCount++] = optarg;
+            break;
+         case 'j':
+            workerCount = strtol(optarg, &end, 10);
+            if (*end != '\0' || workerCount < 1) {
+               printUsage(programName);
+               exit(EXIT_FAILURE);
+            }
+            break;
+         case OPT_SERVE:
+            servePath = optarg;
+            break;
+         case OPT_SERVE_MEMORY:
+            serverMemoryLimit = strtoull(optarg, &end, 10) << 20;
+            if (*end != '\0' || serverMemoryLimit == 0) {
+               printUsage(programName);
+               exit(EXIT_FAILURE);
+            }
+            break;
+         case OPT_OUTPUT:
+            if (strcmp(optarg, "text") == 0) {
+               outputFormat = OUTPUT_TEXT;
+            } else if (strcmp(optarg, "json") == 0) {
+               outputFormat = OUTPUT_JSON;
+            } else if (strcmp(optarg, "bin") == 0) {
+               outputFormat = OUTPUT_BIN;
+            } else {
+               printUsage(programName);
+               exit(EXIT_FAILURE);
+            }
+            break;
          default:
             printUsage(programName);
       }
    }
 
+   // Structured output only covers the header, sections and hex dumps
+   if (outputFormat != OUTPUT_TEXT && (programHeaderOpt || symbolOpt || relocationOpt || startupCostOpt || depsOpt ||
+                                       unresolvedOpt || decompressOpt || addressFile != NULL || lookupSymbol != NULL)) {
+      fprintf(stderr, "%s: Error: --output=json and --output=bin only cover -h, -t and -x\n", programName);
+      exit(EXIT_FAILURE);
+   }
+
+   // If serving queries, do nothing else
+   if (servePath != NULL) {
+      if (!runServer(servePath)) {
+         exit(EXIT_FAILURE);
+      }
+   }
+
    // If no opt was entered, exit
-   if (optind == 1) {
+   else if (optind == 1) {
       printUsage(programName);
    }
 
+   // If scanning directories, process every ELF file under them
+   else if (scanDirCount > 0) {
+      if (!processTrees(scanDirs, scanDirCount, argv + optind, argc - optind, hexDumpArgs, argc, argv)) {
+         exit(EXIT_FAILURE);
+      }
+   }
+
    // If no file was entered, exit
    else if (optind >= argc) {
       printUsage(programName);
    }
 
+   // If checking symbols across the files, check them as one set
+   else if (unresolvedOpt) {
+      if (!printUnresolvedSymbols(argv + optind, argc - optind, stdout, stderr)) {
+         exit(EXIT_FAILURE);
+      }
+   }
+
    // If only one file, process it
    else if (optind == argc-1) {
-      processFile(argv[optind], hexDumpArgs, argc, argv);
+      if (!processFile(argv[optind], hexDumpArgs, argc, argv, stdout, stderr)) {
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   // If there are multiple files and workers, process them in parallel
+   else if (workerCount > 1) {
+      if (!processFilesParallel(argv + optind, argc - optind, workerCount, NULL, hexDumpArgs, argc, argv)) {
+         exit(EXIT_FAILURE);
+      }
    }
 
    // If there are multiple files, process each one
    else {
       for (i=optind; i < argc; i++) {
-         printf("\nFile: %s\n", argv[i]);
-         processFile(argv[i], hexDumpArgs, argc, argv);
+         if (outputFormat == OUTPUT_TEXT) {
+            printf("\nFile: %s\n", argv[i]);
+         }
+         if (!processFile(argv[i], hexDumpArgs, argc, argv, stdout, stderr)) {
+            exit(EXIT_FAILURE);
+         }
       }
    }
 
-   // Free hexDumpArgs memory
+   // Keep the cache in bounds and report how it did
+   if (cacheDir != NULL) {
+      trimCache();
+      printCacheReport(stderr);
+   }
+
+   // Free hexDumpArgs, libPaths and scanDirs memory
    free(hexDumpArgs);
+   free(libPaths);
+   free(scanDirs);
 
    return EXIT_SUCCESS;
 }
@@ -99,93 +280,280 @@ int main(int argc, char *argv[]) {
  *          boolean array for hex dump args one-hot-encoding
  *          number of args
  *          args (pointer to string arr)
+ *          stream to print results to
+ *          stream to print errors and warnings to
  *    
- * OUTPUT:  none
+ * OUTPUT:  true if the file was processed
+ *          false if an error stopped it
  */
-void processFile(const char *fileName, bool *hexDumpArgs, int argc, char *argv[]) {
+bool processFile(const char *fileName, bool *hexDumpArgs, int argc, char *argv[], FILE *out, FILE *err) {
 
-   int i;
-   bool *hexDumpNodes;
-   FILE * file;
+   bool cached = false;
+   bool needSections;
+   struct hexDumpSlice *hexDumpSlices;
+   struct fileImage image;
    union fileHeader_union fileHeader;
-   struct sectionNode *startSecLL = NULL;
+   struct sectionTable secTable = {0};
+   struct segmentTable segTable = {0};
+   struct outputBuffer buffer;
+
+   // Attempt to open the file, otherwise fail
+   if (!openFileImage(fileName, &image)) {
+      fprintf(err, "%s: %s: Error: No such file\n", programName, fileName);
+      return false;
+   }
 
-   // Attempt to open the file, otherwise exit
-   if ( (file = fopen(fileName, "r")) == NULL ) {
-      fprintf(stderr, "%s: %s: Error: No such file\n", programName, fileName);
-      exit(EXIT_FAILURE);
+   // Only some options need the section table
+   needSections = sectionHeaderOpt || hexDumpOpt || programHeaderOpt || symbolOpt || relocationOpt || startupCostOpt || depsOpt ||
+                  addressFile != NULL || lookupSymbol != NULL;
+
+   // Use the cached header and sections if the file hasn't changed
+   if (cacheDir != NULL) {
+      cached = loadCacheEntry(fileName, &fileHeader, &secTable, &image);
    }
 
    // Grab data from file header
-   if (!readFileHeader(&fileHeader, file)) { // not an ELF if false
-      fprintf(stderr, "%s: %s: Error: Not an ELF file - ", programName, fileName);
-      fprintf(stderr, "it has the wrong magic bytes at the start\n");
-      exit(EXIT_FAILURE);
+   if (!cached && !readFileHeader(&fileHeader, &image)) { // not an ELF if false
+      if (hasElfMagic(&image)) {
+         fprintf(err, "%s: %s: Error: Failed to read file header - ", programName, fileName);
+         fprintf(err, "the file is too short\n");
+      } else {
+         fprintf(err, "%s: %s: Error: Not an ELF file - ", programName, fileName);
+         fprintf(err, "it has the wrong magic bytes at the start\n");
+      }
+      closeFileImage(&image);
+      return false;
    }
 
-   // Grab Data from section headers
-   if (sectionHeaderOpt || hexDumpOpt) {
-      readSectionHeaders(&fileHeader, &startSecLL, file);
+   // Under extended numbering -h needs section 0 for the real counts
+   if (fileHeaderOpt && ((fileHeader.Struct.e_shnum == 0 && fileHeader.Struct.e_shoff != 0) ||
+                         fileHeader.Struct.e_shstrndx == SHN_XINDEX)) {
+      needSections = true;
+   }
+
+   // Grab Data from section headers, also reading them to fill the cache
+   if (!cached && (needSections || cacheDir != NULL)) {
+      if (readSectionHeaders(&fileHeader, &secTable, &image)) {
+         if (cacheDir != NULL) {
+            storeCacheEntry(fileName, &fileHeader, &secTable);
+         }
+      } else if (needSections) {
+         fprintf(err, "%s: %s: Error: The section header table ", programName, fileName);
+         fprintf(err, "is truncated or corrupt\n");
+         freeSectionTable(&secTable);
+         closeFileImage(&image);
+         return false;
+      }
+   }
+
+   // Grab data from program headers
+   if (programHeaderOpt) {
+      if (!readProgramHeaders(&fileHeader, &segTable, &image)) {
+         fprintf(err, "%s: %s: Error: The program header table ", programName, fileName);
+         fprintf(err, "is truncated or corrupt\n");
+         freeSectionTable(&secTable);
+         closeFileImage(&image);
+         return false;
+      }
+   }
+
+   // Everything for this file is printed through one buffer
+   openOutputBuffer(&buffer, out);
+
+   // === [--output] OPT ============================================================
+   if (outputFormat != OUTPUT_TEXT) {
+      // Write the header, and the sections and hex dumps if asked for
+      hexDumpSlices = hexDumpOpt ? selectHexSlices(fileName, &secTable, hexDumpArgs, argc, argv, err) : NULL;
+      serializeFile(fileName, &fileHeader, &secTable, sectionHeaderOpt, hexDumpSlices, &image, outputFormat, &buffer);
+      free(hexDumpSlices);
+
+      closeOutputBuffer(&buffer);
+      freeSectionTable(&secTable);
+      closeFileImage(&image);
+      return true;
    }
 
    // === [-h] OPT ===================================================================
    if (fileHeaderOpt) {
       // Print file headers
-      printFileHeader(&fileHeader);
+      printFileHeader(&fileHeader, &secTable, &buffer);
    }
 
    // === [-t] OPT ===================================================================
    if (sectionHeaderOpt) {
       // Print header info if ELF header not printed
       if (!fileHeaderOpt) {
-         printSectionInfo(&fileHeader);
+         printSectionInfo(&fileHeader, &secTable, &buffer);
       }
       // Print section headers
-      printSectionHeaders(startSecLL);
+      printSectionHeaders(&fileHeader, &secTable, &image, &buffer);
    }
 
-   // === [-x] OPT ===================================================================
-   if (hexDumpOpt) {
+   // === [-l] OPT ===================================================================
+   if (programHeaderOpt) {
+      // Print segment info if ELF header not printed
+      if (!fileHeaderOpt) {
+         printSegmentInfo(&fileHeader, &buffer);
+      }
+      // Print program headers and the sections in each
+      printProgramHeaders(&segTable, &image, &buffer);
+      printSegmentMapping(&segTable, &secTable, &buffer);
+   }
 
-      // Allocate memory for hexDumpNodes one-hot-encoding
-      hexDumpNodes = malloc(fileHeader.Struct.e_shnum);
+   // === [-s] OPT ===================================================================
+   if (symbolOpt) {
+      // Print every symbol table
+      printSymbolTables(&fileHeader, &secTable, &image, &buffer);
+   }
 
-      // Initialize hexDumpNodes to false
-      for (i=0; i < fileHeader.Struct.e_shnum; i++) {
-         hexDumpNodes[i] = false;
-      }
+   // === [-r] OPT ===================================================================
+   if (relocationOpt) {
+      // Print every relocation section, or just its type counts
+      printRelocations(&fileHeader, &secTable, &image, relocSummaryOpt, &buffer);
+   }
 
-      // Iterate over each arg
-      for (i=0; i < argc; i++) {
+   // === [--startup-cost] OPT =====================================================
+   if (startupCostOpt) {
+      // Print the dynamic loader's work for this file
+      printStartupCost(&fileHeader, &secTable, &image, &buffer);
+   }
 
-         // Check for args associated with [-x] opt
-         if (hexDumpArgs[i]) {
+   // === [--deps] OPT =============================================================
+   if (depsOpt) {
+      // Print the tree of needed libraries
+      printDependencies(fileName, &fileHeader, &secTable, &image, &buffer);
+   }
 
-            // Update one-hot-encoding, or print error if invalid section
-            if (!findNode(startSecLL, argv[i], hexDumpNodes)) {
-               fprintf(stderr, "%s: %s: Warning: Section '%s' was not dumped because it does not exist!\n",
-                     programName, fileName, argv[i]);
-            }
-         }
+   // === [-y] OPT ===================================================================
+   if (addressFile != NULL) {
+      // Print the function holding each address
+      if (!printAddressLookups(&fileHeader, &secTable, &image, addressFile, &buffer)) {
+         closeOutputBuffer(&buffer);
+         fprintf(err, "%s: %s: Error: Cannot open address file '%s'\n", programName, fileName, addressFile);
+         freeSegmentTable(&segTable);
+         freeSectionTable(&secTable);
+         closeFileImage(&image);
+         return false;
       }
+   }
 
-      // Print hex dump for all args associated with [-x] opt
-      printHexDump(startSecLL, file, hexDumpNodes); 
+   // === [--lookup-symbol] OPT ====================================================
+   if (lookupSymbol != NULL) {
+      // Look the symbol up through the hash section
+      printSymbolLookup(&fileHeader, &secTable, &image, lookupSymbol, &buffer);
+   }
+
+   // === [-x] OPT ===================================================================
+   if (hexDumpOpt) {
+
+      // Pick the sections and slices to dump, keeping warnings in order
+      flushOutputBuffer(&buffer);
+      hexDumpSlices = selectHexSlices(fileName, &secTable, hexDumpArgs, argc, argv, err);
+
+      // Print hex dump for all args associated with [-x] opt, decompressing with [-z]
+      if (decompressOpt) {
+         printDecompressedDump(&fileHeader, &secTable, &image, hexDumpSlices, &buffer);
+      } else {
+         printHexDump(&secTable, &image, hexDumpSlices, &buffer);
+      }
 
-      // Unallocate memory for hexDumpNodes one-hot-encoding
-      free(hexDumpNodes);
+      // Unallocate memory for hexDumpSlices
+      free(hexDumpSlices);
    }
    // ================================================================================
 
-   // Free LL memory
-   if (sectionHeaderOpt || hexDumpOpt) {
-      freeSecLL(&startSecLL);
-   }
+   // Write out what is left of the output
+   closeOutputBuffer(&buffer);
 
-   // Attempt to close file, otherwise exit
-   if (fclose(file) == EOF) {
-      fprintf(stderr, "%s: Can't close [%s]\n", programName, fileName);
-      exit(EXIT_FAILURE);
+   // Free section and segment table memory
+   freeSectionTable(&secTable);
+   freeSegmentTable(&segTable);
+
+   // Release the file image
+   closeFileImage(&image);
+
+   return true;
+}
+
+/**
+ * A function that turns the [-x] args into one hex dump slice per
+ * section.  Sections that don't exist are warned about and skipped.
+ *
+ * INPUT:   name of file being processed
+ *          pointer to the section table
+ *          boolean array for hex dump args one-hot-encoding
+ *          number of args
+ *          args (pointer to string arr)
+ *          stream to print warnings to
+ *
+ * OUTPUT:  array of hex dump slices, for the caller to free
+ */
+struct hexDumpSlice *selectHexSlices(const char *fileName, const struct sectionTable *secTable, bool *hexDumpArgs, int argc, char *argv[], FILE *err) {
+
+   int i;
+   struct hexDumpSlice *hexDumpSlices;
+
+   // Allocate memory for hexDumpSlices, with no section selected
+   hexDumpSlices = calloc(secTable->count > 0 ? secTable->count : 1, sizeof(struct hexDumpSlice));
+
+   // Iterate over each arg
+   for (i=0; i < argc; i++) {
+
+      // Check for args associated with [-x] opt
+      if (hexDumpArgs[i]) {
+
+         // Update one-hot-encoding, or print error if invalid section
+         if (!findNode(secTable, argv[i], hexDumpSlices)) {
+            fprintf(err, "%s: %s: Warning: Section '%s' was not dumped because it does not exist!\n",
+                  programName, fileName, argv[i]);
+         }
+      }
    }
+
+   return hexDumpSlices;
 }
 
+/**
+ * A utility function that prints the usage of this program.
+ * This function is called when given poor user input.
+ *
+ * INPUT:   string, the program name
+ *
+ * OUTPUT:  none
+ */
+void printUsage(char *programName) {
+   fprintf(stderr, "%s: Warning: Nothing to do.\n", programName);
+   fprintf(stderr, "Usage: %s <option(s)> elf-file(s)\n", programName);
+   fprintf(stderr, " Display information about the contents of ELF format files\n");
+   fprintf(stderr, " Options are:\n");
+   fprintf(stderr, "  -h\t\t\tDisplay the ELF file header\n");
+   fprintf(stderr, "  -l\t\t\tDisplay the program headers\n");
+   fprintf(stderr, "  -t\t\t\tDisplay the section details\n");
+   fprintf(stderr, "  -s\t\t\tDisplay the symbol tables\n");
+   fprintf(stderr, "  -r\t\t\tDisplay the relocations\n");
+   fprintf(stderr, "  --reloc-summary\tDisplay the number of relocations of each type\n");
+   fprintf(stderr, "  --startup-cost\tEstimate the dynamic loader's work at startup\n");
+   fprintf(stderr, "  --deps\t\tDisplay the tree of needed shared libraries\n");
+   fprintf(stderr, "  --sysroot <dir>\tFind needed libraries under <dir> instead of /\n");
+   fprintf(stderr, "  --lib-path <dirs>\tSearch <dirs> for needed libraries, like LD_LIBRARY_PATH\n");
+   fprintf(stderr, "  --unresolved\t\tList undefined symbols no file in the set exports\n");
+   fprintf(stderr, "  -y <file>");
+   fprintf(stderr, "\t\tPrint the function holding each address in <file> (- for stdin)\n");
+   fprintf(stderr, "  --lookup-symbol <name>\n");
+   fprintf(stderr, "\t\t\tLook up the exported symbol <name> through .gnu.hash or .hash\n");
+   fprintf(stderr, "  -x <name>");
+   fprintf(stderr, "\t\tDump the contents of the section <name> as bytes\n");
+   fprintf(stderr, "  -x <name>@<offset>+<len>\n");
+   fprintf(stderr, "\t\t\tDump <len> bytes of section <name> from <offset>\n");
+   fprintf(stderr, "  -z --decompress\tDecompress compressed sections before dumping them\n");
+   fprintf(stderr, "  -R <dir>");
+   fprintf(stderr, "\t\tProcess every ELF file under <dir>, skipping other files\n");
+   fprintf(stderr, "  -j <count>");
+   fprintf(stderr, "\t\tProcess multiple files on <count> worker threads\n");
+   fprintf(stderr, "  --output <format>\tWrite -h, -t and -x as text, json or bin\n");
+   fprintf(stderr, "  --cache <dir>\t\tReuse decoded headers of unchanged files from <dir>\n");
+   fprintf(stderr, "  --cache-limit <MiB>\tKeep the cache under <MiB> (default 256)\n");
+   fprintf(stderr, "  --serve <socket>\tAnswer queries on a Unix socket, keeping files parsed\n");
+   fprintf(stderr, "  --serve-memory <MiB>\tMemory for the server's parsed files (default 512)\n");
+   fprintf(stderr, "  --no-uring\t\tRead ahead with threads instead of io_uring\n");
+}
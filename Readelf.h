@@ -15,24 +15,88 @@
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <getopt.h>
 
 #include "customDataTypes.h"
 
 // Local Prototypes
-void processFile(const char *fileName, bool *hexDumpArgs, int argc, char *argv[]);
+bool processFile(const char *fileName, bool *hexDumpArgs, int argc, char *argv[], FILE *out, FILE *err);
+struct hexDumpSlice *selectHexSlices(const char *fileName, const struct sectionTable *secTable, bool *hexDumpArgs, int argc, char *argv[], FILE *err);
+void printUsage(char *programName);
 
 // Other Prototypes
-void printUsage(char *programName);
+bool hasElfMagic(const struct fileImage *image);
+
+bool processFilesParallel(char *fileNames[], int fileCount, int workers, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]);
+bool processTrees(char *scanDirs[], int scanDirCount, char *fileNames[], int fileCount, bool *hexDumpArgs, int argc, char *argv[]);
+bool printUnresolvedSymbols(char *fileNames[], int fileCount, FILE *out, FILE *err);
+
+bool openFileImage(const char *fileName, struct fileImage *image);
+void closeFileImage(struct fileImage *image);
+
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+void printFileHeader(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void printSectionInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+void printSectionHeaders(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+
+bool readProgramHeaders(const union fileHeader_union *fileHeader, struct segmentTable *segTable, const struct fileImage *image);
+void printSegmentInfo(const union fileHeader_union *fileHeader, struct outputBuffer *out);
+void printProgramHeaders(const struct segmentTable *segTable, const struct fileImage *image, struct outputBuffer *out);
+void printSegmentMapping(const struct segmentTable *segTable, const struct sectionTable *secTable, struct outputBuffer *out);
+
+void printSymbolTables(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+void printRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, bool summary, struct outputBuffer *out);
+
+void printStartupCost(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+void printDependencies(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+
+bool printAddressLookups(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *queryFile, struct outputBuffer *out);
+void printSymbolLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *symName, struct outputBuffer *out);
+
+bool findNode(const struct sectionTable *secTable, const char *secName, struct hexDumpSlice *hexDumpSlices);
+void printHexDump(const struct sectionTable *secTable, const struct fileImage *image, struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+void printDecompressedDump(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image,
+                           struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+
+void serializeFile(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, bool sections,
+                   const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image, int format, struct outputBuffer *out);
+
+bool loadCacheEntry(const char *fileName, union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void storeCacheEntry(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+void trimCache(void);
+
+bool runServer(const char *socketPath);
+void printCacheReport(FILE *err);
+
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out);
+void closeOutputBuffer(struct outputBuffer *buffer);
+void flushOutputBuffer(struct outputBuffer *buffer);
 
-bool readFileHeader(union fileHeader_union *fileHeader, FILE *file);
-void printFileHeader(const union fileHeader_union *fileHeader);
+void freeSectionTable(struct sectionTable *secTable);
+void freeSegmentTable(struct segmentTable *segTable);
 
-void readSectionHeaders(union fileHeader_union *fileHeader, struct sectionNode **startSecLL, FILE *file);
-void printSectionInfo(const union fileHeader_union *fileHeader);
-void printSectionHeaders(struct sectionNode *startSecLL);
+// Defines
+#define OPT_LOOKUP_SYMBOL 256
+#define OPT_RELOC_SUMMARY 257
+#define OPT_STARTUP_COST  258
+#define OPT_DEPS          259
+#define OPT_SYSROOT       260
+#define OPT_LIB_PATH      261
+#define OPT_UNRESOLVED    262
+#define OPT_NO_URING      263
+#define OPT_CACHE         264
+#define OPT_CACHE_LIMIT   265
+#define OPT_SERVE         266
+#define OPT_SERVE_MEMORY  267
+#define OPT_OUTPUT        268
 
-bool findNode(struct sectionNode *startSecLL, const char *secName, bool *hexDumpNodes);
-void printHexDump(struct sectionNode *startSecLL, FILE *file, bool *hexDumpNodes);
+#define CACHE_DEFAULT_LIMIT_MB 256
+#define SERVER_DEFAULT_MEMORY_MB 512
 
-void freeSecLL(struct sectionNode **startSecLL);
+#define OUTPUT_TEXT 0
+#define OUTPUT_JSON 1
+#define OUTPUT_BIN  2
 
+#define SHN_XINDEX 0xffff
@@ -0,0 +1,273 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file addressIndex.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "addressIndex.h"
+
+/**
+ * A function that reads a list of addresses and prints the function
+ * each one falls in.  The function symbols are read and indexed once,
+ * then every address is answered from the index, so a run can handle
+ * millions of addresses.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          name of the file holding the addresses ("-" for stdin)
+ *          output buffer to print to
+ *
+ * OUTPUT:  true if the addresses were read
+ *          false if the address file couldn't be opened
+ */
+bool printAddressLookups(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *queryFile, struct outputBuffer *out) {
+
+   FILE *in;
+   struct symbolTable symTable;
+   struct addressIndex index;
+
+   // Open the addresses
+   if (strcmp(queryFile, "-") == 0) {
+      in = stdin;
+   } else if ( (in = fopen(queryFile, "r")) == NULL ) {
+      return false;
+   }
+
+   // Index the function symbols, if there are any
+   if (!readFunctionSymbols(fileHeader, secTable, image, &symTable)) {
+      writeText(out, "\n");
+      writeText(out, "There are no symbols in this file.\n");
+   }
+   buildAddressIndex(&symTable, &index);
+
+   // Answer every address
+   writeText(out, "\n");
+   writeText(out, "Symbols for addresses in '");
+   writeText(out, queryFile);
+   writeText(out, "':\n");
+   symbolizeAddresses(&index, in, out);
+
+   freeAddressIndex(&index);
+   freeSymbolTable(&symTable);
+
+   if (in != stdin) {
+      fclose(in);
+   }
+
+   return true;
+}
+
+/**
+ * A function that builds an address index over a symbol table.  The
+ * symbols are sorted by address and symbols sharing an address are
+ * merged into the first one, then the start addresses are copied into
+ * Eytzinger order.
+ *
+ * INPUT:   pointer to the symbol table (sorted in place)
+ *          pointer to the index to fill in
+ *
+ * OUTPUT:  none
+ */
+void buildAddressIndex(struct symbolTable *symTable, struct addressIndex *index) {
+
+   uint64_t iter;
+   uint64_t kept = 0;
+   uint64_t rank = 0;
+
+   // Sort by address, then drop the aliases
+   qsort(symTable->symbols, symTable->count, sizeof(struct symbolEntry), compareSymbolEntries);
+   for (iter=0; iter < symTable->count; iter++) {
+      if (kept == 0 || symTable->symbols[kept-1].value != symTable->symbols[iter].value) {
+         symTable->symbols[kept++] = symTable->symbols[iter];
+      }
+   }
+   symTable->count = kept;
+
+   // Lay the addresses out from slot 1
+   index->symbols = symTable->symbols;
+   index->count   = kept;
+   index->keys    = malloc((kept + 1) * sizeof(uint64_t));
+   index->ranks   = malloc((kept + 1) * sizeof(uint64_t));
+
+   fillAddressIndex(index, &rank, 1);
+}
+
+/**
+ * A utility function that fills the Eytzinger layout with an in-order
+ * walk of the implicit tree: slot k has children 2k and 2k+1, so
+ * visiting left, self, right hands out the sorted addresses in order.
+ *
+ * INPUT:   pointer to the index being filled
+ *          pointer to the next sorted position to hand out
+ *          slot to fill
+ *
+ * OUTPUT:  none
+ */
+void fillAddressIndex(struct addressIndex *index, uint64_t *rank, uint64_t slot) {
+
+   if (slot > index->count) {
+      return;
+   }
+
+   fillAddressIndex(index, rank, 2 * slot);
+
+   index->keys[slot]  = index->symbols[*rank].value;
+   index->ranks[slot] = *rank;
+   (*rank)++;
+
+   fillAddressIndex(index, rank, 2 * slot + 1);
+}
+
+/**
+ * A function that finds the function holding an address.  The search
+ * walks down the Eytzinger array to the first symbol starting after
+ * the address; the symbol before it is the only candidate.  Symbols
+ * with a size only cover that many bytes, while symbols without one
+ * cover everything up to the next symbol or the end of their section,
+ * whichever comes first.
+ *
+ * INPUT:   pointer to the index
+ *          address to look up
+ *
+ * OUTPUT:  pointer to the symbol holding the address
+ *          NULL if no symbol holds it
+ */
+const struct symbolEntry *lookupAddress(const struct addressIndex *index, uint64_t addr) {
+
+   uint64_t slot = 1;
+   uint64_t rank;
+   const struct symbolEntry *symbol;
+
+   // Walk down the tree, going right past every start <= addr
+   while (slot <= index->count) {
+      slot = 2 * slot + (index->keys[slot] <= addr);
+   }
+
+   // Undo the final right turns to reach the first start > addr
+   slot >>= __builtin_ffsll(~slot);
+   rank = (slot == 0) ? index->count : index->ranks[slot];
+
+   // The candidate is the last start <= addr
+   if (rank == 0) {
+      return NULL;
+   }
+   symbol = &index->symbols[rank - 1];
+
+   // Sized symbols end where their size says, the rest at their section's end
+   if (symbol->size != 0 && addr - symbol->value >= symbol->size) {
+      return NULL;
+   }
+   if (symbol->size == 0 && addr >= symbol->limit) {
+      return NULL;
+   }
+
+   return symbol;
+}
+
+/**
+ * A function that reads one hex address per line and prints the
+ * symbol and offset for each.  Lines that aren't addresses are echoed
+ * back with ?? as are addresses outside every function.
+ *
+ * INPUT:   pointer to the index
+ *          stream to read addresses from
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void symbolizeAddresses(const struct addressIndex *index, FILE *in, struct outputBuffer *out) {
+
+   char *line = NULL;
+   char *text;
+   char *end;
+   size_t capacity = 0;
+   ssize_t length;
+   uint64_t addr;
+
+   const struct symbolEntry *symbol;
+
+   while ( (length = getline(&line, &capacity, in)) != -1 ) {
+
+      // Trim the whitespace around the address
+      while (length > 0 && isspace((unsigned char)line[length-1])) {
+         line[--length] = '\0';
+      }
+      text = line;
+      while (isspace((unsigned char)*text)) {
+         text++;
+      }
+      if (*text == '\0') {
+         continue;
+      }
+
+      // Echo anything that isn't a hex address
+      addr = strtoull(text, &end, 16);
+      if (end == text || *end != '\0') {
+         writeText(out, text);
+         writeText(out, " ??\n");
+         continue;
+      }
+
+      // Print the symbol and offset
+      symbol = lookupAddress(index, addr);
+      writeText(out, "0x");
+      writeHex(out, addr, 16);
+      if (symbol == NULL) {
+         writeText(out, " ??\n");
+      } else {
+         writeChar(out, ' ');
+         writeText(out, symbol->name);
+         writeText(out, "+0x");
+         writeHex(out, addr - symbol->value, 1);
+         writeChar(out, '\n');
+      }
+   }
+
+   free(line);
+}
+
+/**
+ * A utility function to unallocate the memory used by an address
+ * index.  The symbols themselves belong to the symbol table.
+ *
+ * INPUT:   pointer to the index
+ *
+ * OUTPUT:  none
+ */
+void freeAddressIndex(struct addressIndex *index) {
+
+   free(index->keys);
+   free(index->ranks);
+
+   index->keys    = NULL;
+   index->ranks   = NULL;
+   index->symbols = NULL;
+   index->count   = 0;
+}
+
+/**
+ * A qsort comparator for symbol entries.  Orders by address; among
+ * symbols at the same address the larger one comes first, then the
+ * one with the smaller name, so the alias that is kept doesn't depend
+ * on the order of the symbol table.
+ */
+int compareSymbolEntries(const void *a, const void *b) {
+
+   const struct symbolEntry *left  = a;
+   const struct symbolEntry *right = b;
+
+   if (left->value != right->value) {
+      return (left->value < right->value) ? -1 : 1;
+   }
+   if (left->size != right->size) {
+      return (left->size > right->size) ? -1 : 1;
+   }
+   return strcmp(left->name, right->name);
+}
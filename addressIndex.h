@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file addressIndex.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+bool printAddressLookups(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *queryFile, struct outputBuffer *out);
+void buildAddressIndex(struct symbolTable *symTable, struct addressIndex *index);
+void fillAddressIndex(struct addressIndex *index, uint64_t *rank, uint64_t slot);
+const struct symbolEntry *lookupAddress(const struct addressIndex *index, uint64_t addr);
+void symbolizeAddresses(const struct addressIndex *index, FILE *in, struct outputBuffer *out);
+void freeAddressIndex(struct addressIndex *index);
+int compareSymbolEntries(const void *a, const void *b);
+
+// Other Prototypes
+bool readFunctionSymbols(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct symbolTable *symTable);
+void freeSymbolTable(struct symbolTable *symTable);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
@@ -10,7 +10,13 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 // Includes
+#include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
 
 /**
  * Holds the content of an ELF file header.
@@ -130,15 +136,743 @@ union sectionHeader_union
    char arr[64];
 };
 
-/** A node for the section header LL.
- *  Used to dynamically store section info.
+/**
+ * Holds the content of a program header.
+ *  - Can take in data from 32bit or 64bit, but
+ *    should get translated to 64bit for use.
+ *  - Can take little endian or big endian, but
+ *    should get translated to local endian
+ *    for use.
+ */
+union programHeader_union
+{
+   // Struct for 32bit machines
+   struct programHeader_struct32
+   {
+      uint32_t p_type;
+      uint32_t p_offset;
+      uint32_t p_vaddr;
+      uint32_t p_paddr;
+      uint32_t p_filesz;
+      uint32_t p_memsz;
+      uint32_t p_flags;
+      uint32_t p_align;
+   }Struct32;
+
+   // Struct for 64bit machines
+   struct programHeader_struct64
+   {
+      uint32_t p_type;
+      uint32_t p_flags;
+      uint64_t p_offset;
+      uint64_t p_vaddr;
+      uint64_t p_paddr;
+      uint64_t p_filesz;
+      uint64_t p_memsz;
+      uint64_t p_align;
+   }Struct;
+
+   // Array version of structs
+   char arr[56];
+};
+
+/** Symbol table entry union.
+ *  - Can take 32bit or 64bit symbols, but 32bit
+ *    symbols should be translated to 64bit for use.
+ *  - Can take little endian or big endian, but
+ *    should get translated to local endian
+ *    for use.
+ */
+union symbol_union
+{
+   // Struct for 32bit machines
+   struct symbol_struct32
+   {
+      uint32_t st_name;
+      uint32_t st_value;
+      uint32_t st_size;
+      uint8_t  st_info;
+      uint8_t  st_other;
+      uint16_t st_shndx;
+   }Struct32;
+
+   // Struct for 64bit machines
+   struct symbol_struct64
+   {
+      uint32_t st_name;
+      uint8_t  st_info;
+      uint8_t  st_other;
+      uint16_t st_shndx;
+      uint64_t st_value;
+      uint64_t st_size;
+   }Struct;
+
+   // Array version of structs
+   char arr[24];
+};
+
+/** Relocation entry union.
+ *  - Can take 32bit or 64bit relocations, with or
+ *    without an addend (REL entries are the first
+ *    two fields of RELA entries).
+ *  - Can take little endian or big endian.
+ */
+union relocation_union
+{
+   // Struct for 32bit machines
+   struct relocation_struct32
+   {
+      uint32_t r_offset;
+      uint32_t r_info;
+      int32_t  r_addend;
+   }Struct32;
+
+   // Struct for 64bit machines
+   struct relocation_struct64
+   {
+      uint64_t r_offset;
+      uint64_t r_info;
+      int64_t  r_addend;
+   }Struct;
+
+   // Array version of structs
+   char arr[24];
+};
+
+/** A decoded relocation.
+ *  The info word is kept as it was in the file,
+ *  and also split into its symbol and type.
+ */
+struct relocationEntry
+{
+   uint64_t offset;
+   uint64_t info;
+   uint32_t symbol;
+   uint32_t type;
+   int64_t addend;
+};
+
+/** Dynamic section entry union.
+ *  - Can take 32bit or 64bit entries, but 32bit
+ *    entries should be translated to 64bit for use.
+ *  - Can take little endian or big endian.
+ */
+union dynamic_union
+{
+   // Struct for 32bit machines
+   struct dynamic_struct32
+   {
+      int32_t  d_tag;
+      uint32_t d_val;
+   }Struct32;
+
+   // Struct for 64bit machines
+   struct dynamic_struct64
+   {
+      int64_t  d_tag;
+      uint64_t d_val;
+   }Struct;
+
+   // Array version of structs
+   char arr[16];
+};
+
+/** An entry in the section table.
+ *  Used to store one section's info.  The name
+ *  points into the file image's string table.
  */
-struct sectionNode
+struct sectionEntry
 {
    int index;
-   char name[128];
+   const char *name;
    union sectionHeader_union data;
-   struct sectionNode* next;
 };
 
+/** The section table for a file.
+ *  Sections are stored contiguously in file order,
+ *  with an open-addressing hash index from section
+ *  name to section index (-1 marks an empty bucket).
+ */
+struct sectionTable
+{
+   struct sectionEntry *sections;
+   int count;
+   int *nameIndex;
+   int bucketCount;
+};
+
+
+
+/** The part of a section picked for a hex dump.
+ *  The dump covers length bytes from start, cut
+ *  off at the end of the section.
+ */
+struct hexDumpSlice
+{
+   bool selected;
+   uint64_t start;
+   uint64_t length;
+};
+
+/** The program header table for a file.
+ *  Segments are stored contiguously in file order.
+ */
+struct segmentTable
+{
+   union programHeader_union *segments;
+   int count;
+};
+
+/** A sort key for one section.
+ *  Used to sort sections by file offset or
+ *  address without moving the table itself.
+ */
+struct sectionKey
+{
+   uint64_t key;
+   int index;
+};
+
+/** The decoders for one ELF class/endianness combination.
+ *  Picked once per file, so the decode loops themselves
+ *  never check the class or endianness.
+ */
+struct elfDecoder
+{
+   int fileHeaderSize;
+   int sectionHeaderSize;
+   int programHeaderSize;
+   int symbolSize;
+   int relSize;
+   int relaSize;
+   int dynamicSize;
+   void (*decodeFileHeader)(const unsigned char *raw, union fileHeader_union *fileHeader);
+   void (*decodeSectionHeaders)(const unsigned char *table, int count, int entSize, struct sectionEntry *sections);
+   void (*decodeProgramHeaders)(const unsigned char *table, int count, int entSize, union programHeader_union *segments);
+   void (*decodeSymbols)(const unsigned char *table, int count, int entSize, union symbol_union *symbols);
+   void (*decodeRelocations)(const unsigned char *table, int count, int entSize, bool rela, struct relocationEntry *relocations);
+   void (*decodeDynamic)(const unsigned char *table, int count, int entSize, union dynamic_union *entries);
+   uint32_t (*decodeWord)(const unsigned char *raw);
+   uint64_t (*decodeAddress)(const unsigned char *raw);
+};
+
+/** A read-only image of an ELF file.
+ *  Either a private mapping of the whole file or,
+ *  when the file can't be mapped, a heap copy filled
+ *  with large pread calls.
+ */
+struct fileImage
+{
+   const unsigned char *data;
+   uint64_t size;
+   bool mapped;
+};
+
+/** One file handed to the parallel worker pool.
+ *  Holds the file's buffered output until the main
+ *  thread writes it out in argument order.
+ */
+struct fileJob
+{
+   const char *fileName;
+   char *outText;
+   size_t outSize;
+   char *errText;
+   size_t errSize;
+   bool success;
+   bool done;
+   int status;
+};
+
+/** Shared state for the parallel worker pool.
+ *  Workers claim jobs in order and may only run a
+ *  fixed window ahead of the output written so far.
+ */
+struct filePool
+{
+   struct fileJob *jobs;
+   int jobCount;
+   int nextJob;
+   int emitted;
+   int window;
+   bool stop;
+   bool scan;
+   struct prefetcher *prefetch;
+
+   bool *hexDumpArgs;
+   int argc;
+   char **argv;
+
+   pthread_mutex_t lock;
+   pthread_cond_t jobDone;
+   pthread_cond_t jobEmitted;
+};
+
+/** An io_uring set up with raw system calls.  The
+ *  pointers lead into the submission and completion
+ *  rings the kernel shares through mmap.
+ */
+struct uringQueue
+{
+   int fd;
+   unsigned int entries;
+   unsigned int pending;
+   unsigned int *sqHead;
+   unsigned int *sqTail;
+   unsigned int *sqMask;
+   unsigned int *sqArray;
+   unsigned int *cqHead;
+   unsigned int *cqTail;
+   unsigned int *cqMask;
+   struct io_uring_sqe *sqes;
+   struct io_uring_cqe *cqes;
+   void *sqRing;
+   size_t sqRingSize;
+   void *cqRing;
+   size_t cqRingSize;
+   size_t sqesSize;
+};
+
+/** One file being read ahead on the io_uring.  The
+ *  header is read first, then the section header
+ *  table it points to.
+ */
+struct prefetchSlot
+{
+   int job;
+   int fd;
+   int stage;
+   unsigned char header[64];
+   unsigned char *table;
+   struct iovec iov;
+};
+
+/** Shared state for reading files ahead of the worker
+ *  pool.  Each file's state says whether its reads are
+ *  done and whether it looked like an ELF file.  Reads
+ *  never run more than a fixed distance ahead of the
+ *  files the pool has claimed.
+ */
+struct prefetcher
+{
+   char **fileNames;
+   int fileCount;
+   int *states;
+   int nextFile;
+   int consumed;
+   bool stop;
+   bool uring;
+   struct uringQueue ring;
+   struct prefetchSlot *slots;
+   pthread_t *threads;
+   int threadCount;
+   pthread_mutex_t lock;
+   pthread_cond_t ready;
+   pthread_cond_t advanced;
+};
+
+/** The start of a parse cache entry.  The decoded
+ *  section headers follow it, in local endian.  The
+ *  key fields must match the file's current stat for
+ *  the entry to be used.
+ */
+struct cacheHeader
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t sectionCount;
+   uint32_t headerSize;
+   uint32_t sectionSize;
+   uint64_t device;
+   uint64_t inode;
+   uint64_t size;
+   int64_t mtimeSec;
+   int64_t mtimeNsec;
+   union fileHeader_union fileHeader;
+};
+
+/** Counters for the parse cache report, updated
+ *  atomically by every worker.
+ */
+struct cacheStats
+{
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t stale;
+   uint64_t stored;
+   uint64_t evicted;
+};
+
+/** A cache entry found while trimming the cache.
+ */
+struct cacheFile
+{
+   char *path;
+   uint64_t size;
+   int64_t mtime;
+};
+
+/** Totals from a -R scan, with the names of the
+ *  files that failed.  The names belong to the
+ *  scan's file list.
+ */
+struct scanSummary
+{
+   int elfCount;
+   int skippedCount;
+   int failedCount;
+   const char **failed;
+};
+
+/** A growing list of file paths found by a -R scan.
+ */
+struct scanList
+{
+   char **paths;
+   int count;
+   int capacity;
+};
+
+/** One symbol table being printed.
+ *  Shared by the threads that decode and format
+ *  it.  Symbols are read straight from the image
+ *  and names point into its string table.
+ */
+struct symbolDump
+{
+   const unsigned char *table;
+   uint64_t count;
+   int entSize;
+   const char *strtab;
+   uint64_t strtabSize;
+   const unsigned char *shndxTable;
+   uint64_t shndxCount;
+   const struct sectionTable *secTable;
+   const struct elfDecoder *decoder;
+   int addrDigits;
+   uint64_t chunkCount;
+   int threadCount;
+   struct outputBuffer *out;
+   pthread_mutex_t start;
+   pthread_barrier_t formatted;
+   pthread_barrier_t written;
+};
+
+/** One thread working on a symbol table.
+ *  Each round, a thread decodes one chunk of
+ *  symbols into its own buffer and formats it into
+ *  its own text buffer, so memory use depends on
+ *  the chunk size and not the symbol count.
+ */
+struct symbolWorker
+{
+   struct symbolDump *dump;
+   int id;
+   union symbol_union *symbols;
+   char *text;
+   size_t textSize;
+   size_t textUsed;
+   bool failed;
+};
+
+/** A symbol kept for address lookups.
+ *  The name points into the file image's
+ *  string table.  limit is the end of the
+ *  symbol's section, which bounds symbols
+ *  without a size.
+ */
+struct symbolEntry
+{
+   uint64_t value;
+   uint64_t size;
+   uint64_t limit;
+   const char *name;
+};
+
+/** The function symbols of a file.
+ *  Stored contiguously; sorted by address once an
+ *  address index is built over them.
+ */
+struct symbolTable
+{
+   struct symbolEntry *symbols;
+   uint64_t count;
+};
+
+/** An address index over a symbol table.
+ *  The sorted start addresses are laid out in
+ *  Eytzinger (breadth-first tree) order from slot 1,
+ *  so a search walks down the array and the top
+ *  levels share cache lines.  ranks maps each slot
+ *  back to its position in the sorted table.
+ */
+struct addressIndex
+{
+   uint64_t *keys;
+   uint64_t *ranks;
+   const struct symbolEntry *symbols;
+   uint64_t count;
+};
+
+/** A hash section opened for symbol lookups.
+ *  Points straight into the file image: the hash
+ *  section's words, the dynamic symbols it indexes,
+ *  and their string table.  Bloom words are
+ *  address-sized, everything else is 32bit.
+ */
+struct hashLookup
+{
+   const struct sectionEntry *hashSection;
+   const struct sectionEntry *symSection;
+   const struct sectionTable *secTable;
+   const struct elfDecoder *decoder;
+   const unsigned char *words;
+   uint64_t wordCount;
+   const unsigned char *symbols;
+   uint64_t symbolCount;
+   int entSize;
+   const char *strtab;
+   uint64_t strtabSize;
+   int wordSize;
+   bool gnu;
+};
+
+/** Counts of one relocation type.
+ *  Used for relocation summaries.
+ */
+struct relocationCount
+{
+   uint32_t type;
+   uint64_t count;
+};
+
+/** The load-time work found for one file.
+ *  Filled in by the startup cost report.
+ */
+struct startupCost
+{
+   uint64_t neededCount;
+   bool bindNow;
+   const char *hashName;
+   uint64_t dynsymCount;
+   uint64_t relocCount;
+   uint64_t relativeCount;
+   uint64_t relrCount;
+   uint64_t symbolicCount;
+   uint64_t pltCount;
+   uint64_t lookupCount;
+   uint64_t relroSize;
+   uint64_t typeCounts[256];
+   uint64_t otherTypes;
+};
+
+/** One file in a dependency graph.
+ *  Keyed by its path on disk (sysroot included).
+ *  Missing and incompatible files get a node too, so
+ *  every path is only checked once.  children[i] is the
+ *  file found for needed[i], or NULL if none was.
+ */
+struct depNode
+{
+   char *path;
+   int id;
+   bool exists;
+   int elfClass;
+   int elfData;
+   uint16_t machine;
+   int state;
+   int neededCount;
+   char **needed;
+   struct depNode **children;
+   char *rpath;
+   char *runpath;
+};
+
+/** A dependency graph shared by every --deps walk.
+ *  Nodes are found through an open-addressing hash
+ *  index on their path.  Files waiting to be parsed sit
+ *  in a queue that worker threads drain; the lock
+ *  guards everything but a node's parsed fields, which
+ *  only its parsing thread touches until it is done.
+ */
+struct depGraph
+{
+   struct depNode **nodes;
+   int count;
+   int capacity;
+   struct depNode **buckets;
+   int bucketCount;
+   struct depNode **queue;
+   int queueHead;
+   int queueTail;
+   int queueSize;
+   int active;
+   const char *sysroot;
+   char **searchDirs;
+   int searchDirCount;
+   pthread_mutex_t lock;
+   pthread_cond_t changed;
+};
 
+/** A dynamic symbol kept for the --unresolved check.
+ *  The name is an offset into its file's copy of the
+ *  dynamic string table, and the hash is its GNU hash.
+ */
+struct linkSymbol
+{
+   uint32_t hash;
+   uint32_t name;
+};
+
+/** One file of an --unresolved check: the symbols it
+ *  exports and the ones it imports, with the imports
+ *  no file exports listed once the check has run.
+ */
+struct linkFile
+{
+   const char *fileName;
+   bool loaded;
+   char *strings;
+   uint64_t stringsSize;
+   struct linkSymbol *exports;
+   int exportCount;
+   struct linkSymbol *imports;
+   int importCount;
+   int *missing;
+   int missingCount;
+};
+
+/** A slot of the global export index.  The file is
+ *  stored plus one, so a zeroed slot is empty.
+ */
+struct exportSlot
+{
+   uint32_t hash;
+   uint32_t name;
+   int file;
+};
+
+/** Shared state for an --unresolved check.  Threads
+ *  claim files through the counters, and the export
+ *  index is split into partitions on the top bits of
+ *  the mixed hash, each built by one thread.  Each
+ *  partition is sized from its own export count and
+ *  starts at its offset into the slots.  failed is set
+ *  if memory ran out, which ends the check.
+ */
+struct linkCheck
+{
+   struct linkFile *files;
+   int fileCount;
+   int nextLoad;
+   int nextPartition;
+   int nextProbe;
+   int threadCount;
+   struct exportSlot *slots;
+   int partitionBits;
+   uint64_t *partitionStart;
+   uint64_t *partitionSize;
+   bool failed;
+   pthread_mutex_t lock;
+   pthread_mutex_t start;
+   pthread_barrier_t phase;
+};
+
+/** A file held parsed by the query server.  It sits
+ *  in a hash chain by path and in the LRU list, and
+ *  stays alive while requests are using it even after
+ *  it has been evicted or replaced.
+ */
+struct serverFile
+{
+   char *path;
+   uint64_t device;
+   uint64_t inode;
+   uint64_t size;
+   int64_t mtimeSec;
+   int64_t mtimeNsec;
+   struct fileImage image;
+   union fileHeader_union fileHeader;
+   struct sectionTable secTable;
+   uint64_t memory;
+   int users;
+   bool cached;
+   struct serverFile *hashNext;
+   struct serverFile *prev;
+   struct serverFile *next;
+};
+
+/** The query server's cache of parsed files, kept in
+ *  most recently used order and bounded by the memory
+ *  its files take, along with the count of clients
+ *  being served.
+ */
+struct serverCache
+{
+   struct serverFile **buckets;
+   int bucketCount;
+   struct serverFile *head;
+   struct serverFile *tail;
+   int count;
+   uint64_t memory;
+   uint64_t limit;
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t evicted;
+   uint64_t requests;
+   int clients;
+   pthread_mutex_t lock;
+   pthread_cond_t clientLeft;
+};
+
+/** An open file behind the libreadelf handle: its
+ *  image, ELF header and section table, read once
+ *  by readelfOpen.
+ */
+struct readelfFile
+{
+   struct fileImage image;
+   union fileHeader_union fileHeader;
+   struct sectionTable secTable;
+};
+
+/** A large output buffer that is written to its
+ *  stream with one fwrite each time it fills.  With
+ *  no stream the output is only counted; written is
+ *  the number of bytes passed on so far.
+ */
+struct outputBuffer
+{
+   char *data;
+   char *cursor;
+   char *end;
+   FILE *out;
+   uint64_t written;
+};
+
+/** The header at the start of a compressed section
+ *  (Elf32_Chdr or Elf64_Chdr), widened to 64bit.
+ *  headerSize is the number of bytes it takes in the
+ *  file, before the compressed stream.
+ */
+struct compressionHeader
+{
+   uint32_t type;
+   uint64_t size;
+   uint64_t align;
+   int headerSize;
+};
+
+/** A streaming decompressor over one compressed
+ *  section.  The stream is zlib's or zstd's state,
+ *  and input is the part of the compressed bytes
+ *  not yet handed to it.
+ */
+struct sectionInflater
+{
+   uint32_t type;
+   void *stream;
+   const unsigned char *input;
+   uint64_t inputLeft;
+   bool finished;
+};
@@ -0,0 +1,382 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file decompress.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "decompress.h"
+
+/**
+ * A function that prints the hex dump of the chosen sections for the
+ * [-z] option.  Sections with SHF_COMPRESSED set are decompressed on
+ * the way to the formatter, and the rest are dumped as they are.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file to dump
+ *          array of hex dump slices, one per section
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printDecompressedDump(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image,
+                           struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out) {
+
+   int iter;
+   const struct sectionEntry *section;
+
+   // Iterate over the section table
+   for (iter=0; iter < secTable->count; iter++) {
+
+      // Dump sections associated with [-x] opt
+      if (!hexDumpSlices[iter].selected) {
+         continue;
+      }
+
+      section = &secTable->sections[iter];
+
+      if (section->data.Struct.sh_flags & SHF_COMPRESSED) {
+         printDecompressedSection(fileHeader, section, &hexDumpSlices[iter], image, out);
+      } else {
+         printHexSection(section, &hexDumpSlices[iter], image, out);
+      }
+   }
+}
+
+/**
+ * A function that prints the hex dump of a compressed section's
+ * slice.  The slice is taken from the uncompressed bytes, which are
+ * streamed from the decompressor into the formatter, so the section
+ * is never inflated in memory as a whole.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the compressed section
+ *          pointer to the section's slice
+ *          pointer to the image of the file to dump
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printDecompressedSection(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const struct hexDumpSlice *slice,
+                              const struct fileImage *image, struct outputBuffer *out) {
+
+   uint64_t start;
+   uint64_t length;
+   const unsigned char *raw;
+
+   struct compressionHeader chdr;
+   struct sectionInflater inflater;
+
+   // Read the compression header
+   if (!readCompressionHeader(fileHeader, section, image, &chdr)) {
+      writeText(out, "Section '");
+      writeText(out, section->name);
+      writeText(out, "' has a corrupt compression header.\n");
+      return;
+   }
+
+   // Check the slice against the uncompressed size
+   start = slice->start;
+   if (chdr.size == 0) {
+      printHexSliceError(section, HEX_SLICE_EMPTY, start, out);
+      return;
+   }
+   if (start >= chdr.size) {
+      printHexSliceError(section, HEX_SLICE_OFFSET, start, out);
+      return;
+   }
+   length = (slice->length > chdr.size - start) ? chdr.size - start : slice->length;
+
+   // The compressed stream must be inside the image
+   raw = imageAt(image, section->data.Struct.sh_offset, section->data.Struct.sh_size);
+   if (raw == NULL) {
+      printHexSliceError(section, HEX_SLICE_TRUNCATED, start, out);
+      return;
+   }
+
+   // Start the decompressor for this type
+   if (!openInflater(&inflater, chdr.type, raw + chdr.headerSize, section->data.Struct.sh_size - chdr.headerSize)) {
+      writeText(out, "Section '");
+      writeText(out, section->name);
+      writeText(out, "' is compressed with ");
+      writeText(out, compressionTypeName(chdr.type));
+      writeText(out, ", which can't be decompressed.\n");
+      return;
+   }
+
+   // The compressed bytes are read front to back
+   imageAdvise(image, section->data.Struct.sh_offset, section->data.Struct.sh_size, MADV_SEQUENTIAL);
+
+   // Print section name
+   writeText(out, "\n");
+   writeText(out, "Hex dump of section '");
+   writeText(out, section->name);
+   writeText(out, "':\n");
+
+   // Print hex body, and say if the stream ran out or was corrupt
+   if (!printInflatedBody(&inflater, start, length, start + length == chdr.size, out)) {
+      writeText(out, "Section '");
+      writeText(out, section->name);
+      writeText(out, "' could not be fully decompressed.\n");
+   }
+
+   closeInflater(&inflater);
+}
+
+/**
+ * A function that prints the hex body of a slice of a section's
+ * uncompressed bytes.  The decompressor fills a fixed window; whole
+ * lines are formatted out of it and the partial line left over is
+ * moved to the front, so memory use doesn't depend on the section's
+ * size.  Bytes before the slice are decompressed and dropped, and
+ * decompression stops once the slice is printed.  A slice that runs
+ * to the end of the section reads the rest of the stream as well, so
+ * its checksum is verified.
+ *
+ * INPUT:   pointer to the opened decompressor
+ *          first uncompressed byte to print
+ *          number of bytes to print
+ *          true if the slice runs to the end of the section
+ *          output buffer to print to
+ *
+ * OUTPUT:  true if the whole slice was printed
+ *          false if the stream ended early or was corrupt, or the
+ *          window couldn't be allocated
+ */
+bool printInflatedBody(struct sectionInflater *inflater, uint64_t start, uint64_t length, bool toEnd, struct outputBuffer *out) {
+
+   int lineSize;
+   int status = INFLATE_MORE;
+   size_t used = 0;
+   size_t produced;
+   size_t drop;
+   size_t count;
+   size_t pos;
+
+   uint64_t skip = start;
+   uint64_t addr = start;
+   unsigned char *window;
+
+   // Without a window nothing can be printed; the caller reports it
+   if ( (window = malloc(INFLATE_WINDOW)) == NULL ) {
+      writeChar(out, '\n');
+      return false;
+   }
+
+   while (length > 0 && status == INFLATE_MORE) {
+
+      // Decompress into the free part of the window
+      status = inflateSome(inflater, window + used, INFLATE_WINDOW - used, &produced);
+
+      // Drop bytes before the slice
+      if (skip > 0) {
+         drop = (skip < produced) ? skip : produced;
+         memmove(window + used, window + used + drop, produced - drop);
+         produced -= drop;
+         skip     -= drop;
+      }
+
+      // Keep no more than the slice needs
+      used += produced;
+      if (used > length) {
+         used = length;
+      }
+
+      // Format whole lines, or everything once nothing more will come
+      count = (used == length || status != INFLATE_MORE) ? used : used & ~(size_t)15;
+      for (pos = 0; pos < count; pos += lineSize) {
+         lineSize    = (count - pos >= 16) ? 16 : count - pos;
+         out->cursor = formatHexLine(reserveOutput(out, HEX_LINE_MAX), addr, window + pos, lineSize);
+         addr       += 0x10;
+      }
+
+      // Move the partial line to the front
+      memmove(window, window + count, used - count);
+      used   -= count;
+      length -= count;
+   }
+
+   // Finish the stream; any more bytes mean ch_size was wrong
+   while (toEnd && length == 0 && status == INFLATE_MORE) {
+      status = inflateSome(inflater, window, INFLATE_WINDOW, &produced);
+      if (produced > 0) {
+         status = INFLATE_ERROR;
+      }
+   }
+
+   free(window);
+
+   // Finish with a blank line
+   writeChar(out, '\n');
+
+   return (length == 0 && status != INFLATE_ERROR);
+}
+
+/**
+ * A function that sets up a streaming decompressor for a section's
+ * compressed bytes.  zlib is always available; zstd only when the
+ * program was built with it.
+ *
+ * INPUT:   pointer to the decompressor to set up
+ *          ch_type of the section
+ *          pointer to the compressed bytes
+ *          number of compressed bytes
+ *
+ * OUTPUT:  true if the decompressor is ready
+ *          false if the type isn't supported
+ */
+bool openInflater(struct sectionInflater *inflater, uint32_t type, const unsigned char *input, uint64_t size) {
+
+   z_stream *zlib;
+
+   inflater->type      = type;
+   inflater->stream    = NULL;
+   inflater->input     = input;
+   inflater->inputLeft = size;
+   inflater->finished  = false;
+
+   switch (type) {
+      case ELFCOMPRESS_ZLIB:
+         if ( (zlib = calloc(1, sizeof(z_stream))) == NULL ) {
+            return false;
+         }
+         if (inflateInit(zlib) != Z_OK) {
+            free(zlib);
+            return false;
+         }
+         inflater->stream = zlib;
+         return true;
+#ifdef HAVE_ZSTD
+      case ELFCOMPRESS_ZSTD:
+         inflater->stream = ZSTD_createDStream();
+         if (inflater->stream == NULL) {
+            return false;
+         }
+         ZSTD_initDStream(inflater->stream);
+         return true;
+#endif
+      default:
+         return false;
+   }
+}
+
+/**
+ * A function that decompresses as much as fits into a buffer.  zlib
+ * is handed the input a chunk at a time, since its counts are 32-bit.
+ *
+ * INPUT:   pointer to the decompressor
+ *          pointer to where the bytes should go
+ *          size of the buffer
+ *          pointer to store the number of bytes produced
+ *
+ * OUTPUT:  INFLATE_MORE if the stream continues
+ *          INFLATE_END once the stream is complete
+ *          INFLATE_ERROR if the stream is corrupt or cut short
+ */
+int inflateSome(struct sectionInflater *inflater, unsigned char *out, size_t size, size_t *produced) {
+
+   int ret;
+   z_stream *zlib;
+
+#ifdef HAVE_ZSTD
+   size_t left;
+   ZSTD_inBuffer zstdIn;
+   ZSTD_outBuffer zstdOut;
+#endif
+
+   *produced = 0;
+   if (inflater->finished) {
+      return INFLATE_END;
+   }
+
+   switch (inflater->type) {
+      case ELFCOMPRESS_ZLIB:
+         zlib = inflater->stream;
+
+         // Hand zlib the next chunk of input
+         if (zlib->avail_in == 0 && inflater->inputLeft > 0) {
+            zlib->next_in  = (unsigned char *)inflater->input;
+            zlib->avail_in = (inflater->inputLeft > INFLATE_INPUT_CHUNK) ? INFLATE_INPUT_CHUNK : inflater->inputLeft;
+            inflater->input     += zlib->avail_in;
+            inflater->inputLeft -= zlib->avail_in;
+         }
+
+         zlib->next_out  = out;
+         zlib->avail_out = size;
+         ret = inflate(zlib, Z_NO_FLUSH);
+         *produced = size - zlib->avail_out;
+
+         if (ret == Z_STREAM_END) {
+            inflater->finished = true;
+            return INFLATE_END;
+         }
+         // Z_BUF_ERROR only means no progress was possible this time
+         if (ret == Z_OK || (ret == Z_BUF_ERROR && *produced > 0)) {
+            return INFLATE_MORE;
+         }
+         return INFLATE_ERROR;
+#ifdef HAVE_ZSTD
+      case ELFCOMPRESS_ZSTD:
+         zstdIn.src   = inflater->input;
+         zstdIn.size  = inflater->inputLeft;
+         zstdIn.pos   = 0;
+         zstdOut.dst  = out;
+         zstdOut.size = size;
+         zstdOut.pos  = 0;
+
+         left = ZSTD_decompressStream(inflater->stream, &zstdOut, &zstdIn);
+         *produced = zstdOut.pos;
+         inflater->input     += zstdIn.pos;
+         inflater->inputLeft -= zstdIn.pos;
+
+         if (ZSTD_isError(left)) {
+            return INFLATE_ERROR;
+         }
+         if (left == 0) {
+            inflater->finished = true;
+            return INFLATE_END;
+         }
+         // No progress at all means the input ran out
+         if (zstdIn.pos == 0 && zstdOut.pos == 0) {
+            return INFLATE_ERROR;
+         }
+         return INFLATE_MORE;
+#endif
+      default:
+         return INFLATE_ERROR;
+   }
+}
+
+/**
+ * A utility function that releases a decompressor's state.
+ *
+ * INPUT:   pointer to the decompressor
+ *
+ * OUTPUT:  none
+ */
+void closeInflater(struct sectionInflater *inflater) {
+
+   if (inflater->stream == NULL) {
+      return;
+   }
+
+   switch (inflater->type) {
+      case ELFCOMPRESS_ZLIB:
+         inflateEnd(inflater->stream);
+         free(inflater->stream);
+         break;
+#ifdef HAVE_ZSTD
+      case ELFCOMPRESS_ZSTD:
+         ZSTD_freeDStream(inflater->stream);
+         break;
+#endif
+   }
+
+   inflater->stream = NULL;
+}
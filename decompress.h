@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file decompress.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// The hex dump formatter, its prototypes and defines
+#include "hexDump.h"
+
+// Local Prototypes
+void printDecompressedDump(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image,
+                           struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+void printDecompressedSection(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const struct hexDumpSlice *slice,
+                              const struct fileImage *image, struct outputBuffer *out);
+bool printInflatedBody(struct sectionInflater *inflater, uint64_t start, uint64_t length, bool toEnd, struct outputBuffer *out);
+bool openInflater(struct sectionInflater *inflater, uint32_t type, const unsigned char *input, uint64_t size);
+int inflateSome(struct sectionInflater *inflater, unsigned char *out, size_t size, size_t *produced);
+void closeInflater(struct sectionInflater *inflater);
+
+// Other Prototypes
+bool readCompressionHeader(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const struct fileImage *image, struct compressionHeader *chdr);
+const char *compressionTypeName(uint32_t type);
+
+// Defines
+#define SHF_COMPRESSED 0x800
+#define ELFCOMPRESS_ZLIB 1
+#define ELFCOMPRESS_ZSTD 2
+
+#define INFLATE_WINDOW (1 << 16)
+#define INFLATE_INPUT_CHUNK (1 << 20)
+
+#define INFLATE_MORE  0
+#define INFLATE_END   1
+#define INFLATE_ERROR 2
@@ -0,0 +1,750 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file dependencies.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "dependencies.h"
+
+// The graph shared by every walk in this run
+static struct depGraph dependencyGraph;
+static pthread_once_t dependencyGraphOnce = PTHREAD_ONCE_INIT;
+
+// Directories the loader searches when nothing else names one
+static const char *const defaultLibDirs[] = { "/lib64", "/usr/lib64", "/lib", "/usr/lib" };
+
+/**
+ * A function that prints the libraries a file needs, and the libraries
+ * those need, the way the dynamic loader would find them.  The file's
+ * own DT_NEEDED entries are resolved here; every library found is then
+ * parsed by a pool of threads, which resolve that library's needs in
+ * turn until nothing is left.  Libraries are remembered across every
+ * file in the run, so each one is only parsed once.
+ *
+ * INPUT:   name of the file
+ *          pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printDependencies(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out) {
+
+   int iter;
+   int threadCount;
+   long cpuCount;
+   int libraryCount = 0;
+
+   bool *listed;
+   pthread_t *threads;
+
+   struct depNode root = {0};
+   struct depGraph *graph = getDependencyGraph();
+
+   // Read and resolve the file's own needs
+   root.path = (char *)fileName;
+   readDependencyInfo(&root, fileHeader, secTable, image);
+   resolveDependencies(graph, &root, displayDependencyPath(graph, fileName));
+
+   // Parse everything that was found, on one thread per core unless
+   // files are already spread over pool or scan workers
+   cpuCount    = sysconf(_SC_NPROCESSORS_ONLN);
+   threadCount = (workerCount > 1 || poolWorkerCount > 1 || cpuCount < 1) ? 1 : cpuCount;
+   if (threadCount > DEP_MAX_THREADS) {
+      threadCount = DEP_MAX_THREADS;
+   }
+
+   // Helpers that can't be started leave their share to the others
+   if ( (threads = malloc(threadCount * sizeof(pthread_t))) == NULL ) {
+      threadCount = 1;
+   }
+   for (iter=1; iter < threadCount; iter++) {
+      if (pthread_create(&threads[iter], NULL, dependencyWorker, graph) != 0) {
+         break;
+      }
+   }
+   threadCount = iter;
+   dependencyWorker(graph);
+   for (iter=1; iter < threadCount; iter++) {
+      pthread_join(threads[iter], NULL);
+   }
+   free(threads);
+
+   // Print the tree, listing each library's needs only once
+   pthread_mutex_lock(&graph->lock);
+   listed = calloc(graph->count + 1, sizeof(bool));
+   pthread_mutex_unlock(&graph->lock);
+
+   writeText(out, "\n");
+   writeText(out, "Dependencies of '");
+   writeText(out, fileName);
+   writeText(out, "':\n");
+   if (root.neededCount == 0) {
+      writeText(out, "  This file needs no shared libraries.\n");
+   }
+   printDependencyTree(graph, &root, 0, listed, out);
+
+   // Print totals
+   pthread_mutex_lock(&graph->lock);
+   for (iter=0; iter < graph->count; iter++) {
+      libraryCount += listed[iter];
+   }
+   pthread_mutex_unlock(&graph->lock);
+   writeText(out, "  ");
+   writeSigned(out, libraryCount);
+   writeText(out, " distinct libraries\n");
+
+   // Release the root's strings
+   for (iter=0; iter < root.neededCount; iter++) {
+      free(root.needed[iter]);
+   }
+   free(root.needed);
+   free(root.children);
+   free(root.rpath);
+   free(root.runpath);
+   free(listed);
+}
+
+/**
+ * A function that returns the dependency graph, setting it up on first
+ * use: the sysroot, and the search directories from the sysroot's
+ * /etc/ld.so.conf followed by the loader's defaults.
+ *
+ * INPUT:   none
+ *
+ * OUTPUT:  pointer to the graph
+ */
+static void initDependencyGraph(void) {
+
+   unsigned int iter;
+   struct depGraph *graph = &dependencyGraph;
+
+   graph->sysroot     = (sysrootDir != NULL) ? sysrootDir : "";
+   graph->bucketCount = 256;
+   graph->buckets     = calloc(graph->bucketCount, sizeof(struct depNode *));
+
+   pthread_mutex_init(&graph->lock, NULL);
+   pthread_cond_init(&graph->changed, NULL);
+
+   readLdSoConf(graph, "/etc/ld.so.conf", 0);
+   for (iter=0; iter < sizeof(defaultLibDirs) / sizeof(defaultLibDirs[0]); iter++) {
+      addSearchDir(graph, defaultLibDirs[iter]);
+   }
+}
+
+struct depGraph *getDependencyGraph(void) {
+
+   pthread_once(&dependencyGraphOnce, initDependencyGraph);
+
+   return &dependencyGraph;
+}
+
+/**
+ * A function that reads the search directories from an ld.so.conf
+ * file inside the sysroot, following its include lines.
+ *
+ * INPUT:   pointer to the graph
+ *          path of the file, inside the sysroot
+ *          how many includes deep this file is
+ *
+ * OUTPUT:  none
+ */
+void readLdSoConf(struct depGraph *graph, const char *confName, int depth) {
+
+   size_t iter;
+   size_t rootLength;
+   size_t capacity = 0;
+   ssize_t length;
+
+   char *line = NULL;
+   char *text;
+   char *comment;
+   char path[DEP_PATH_MAX];
+   char pattern[DEP_PATH_MAX];
+
+   FILE *conf;
+   glob_t matches;
+
+   // Give up on include loops
+   if (depth > DEP_CONF_DEPTH) {
+      return;
+   }
+
+   snprintf(path, sizeof(path), "%s%s", graph->sysroot, confName);
+   if ( (conf = fopen(path, "r")) == NULL ) {
+      return;
+   }
+
+   rootLength = strlen(graph->sysroot);
+
+   while ( (length = getline(&line, &capacity, conf)) != -1 ) {
+
+      // Drop comments and surrounding whitespace
+      if ( (comment = strchr(line, '#')) != NULL ) {
+         *comment = '\0';
+      }
+      text = line + strspn(line, " \t");
+      while (length > 0 && strchr(" \t\r\n", line[length - 1]) != NULL) {
+         line[--length] = '\0';
+      }
+
+      if (*text == '\0') {
+         continue;
+      }
+
+      // Follow includes, which are globs
+      if (strncmp(text, "include", 7) == 0 && (text[7] == ' ' || text[7] == '\t')) {
+
+         text += 8 + strspn(text + 8, " \t");
+         text[strcspn(text, " \t")] = '\0';
+
+         // Relative patterns are relative to this file's directory
+         if (*text == '/') {
+            snprintf(pattern, sizeof(pattern), "%s%s", graph->sysroot, text);
+         } else {
+            snprintf(pattern, sizeof(pattern), "%s%.*s/%s", graph->sysroot,
+                  (int)(strrchr(confName, '/') - confName), confName, text);
+         }
+
+         if (glob(pattern, 0, NULL, &matches) == 0) {
+            for (iter=0; iter < matches.gl_pathc; iter++) {
+               readLdSoConf(graph, matches.gl_pathv[iter] + rootLength, depth + 1);
+            }
+            globfree(&matches);
+         }
+         continue;
+      }
+
+      // Skip hwcap lines, keep directories
+      if (*text == '/') {
+         addSearchDir(graph, text);
+      }
+   }
+
+   free(line);
+   fclose(conf);
+}
+
+/**
+ * A utility function that appends a directory to the graph's default
+ * search list.
+ *
+ * INPUT:   pointer to the graph
+ *          directory, inside the sysroot
+ *
+ * OUTPUT:  none
+ */
+void addSearchDir(struct depGraph *graph, const char *dir) {
+
+   graph->searchDirs = realloc(graph->searchDirs, (graph->searchDirCount + 1) * sizeof(char *));
+   graph->searchDirs[graph->searchDirCount++] = strdup(dir);
+}
+
+/**
+ * A function that reads what a file's dynamic section says about its
+ * dependencies: its DT_NEEDED names and its DT_RPATH and DT_RUNPATH
+ * search paths.  The strings are copied, so the image can be closed
+ * afterwards.  The file's class and machine are kept to pick matching
+ * libraries.
+ *
+ * INPUT:   pointer to the node to fill in
+ *          pointer to the fileHeader for the file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *
+ * OUTPUT:  none
+ */
+void readDependencyInfo(struct depNode *node, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image) {
+
+   int index;
+   int entSize;
+   uint64_t iter;
+   uint64_t count;
+   uint64_t strtabSize;
+
+   const char *strtab;
+   const char *text;
+   const unsigned char *table;
+   const struct sectionEntry *section;
+   const struct elfDecoder *decoder;
+
+   union dynamic_union *entries;
+   struct dynamic_struct64 *entry;
+
+   node->exists   = true;
+   node->elfClass = fileHeader->arr[4];
+   node->elfData  = fileHeader->arr[5];
+   node->machine  = fileHeader->Struct.e_machine;
+
+   // Locate the dynamic section and its strings
+   if ( (index = findSectionByType(secTable, SHT_DYNAMIC, 0)) == -1 ) {
+      return;
+   }
+   section = &secTable->sections[index];
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   entSize = section->data.Struct.sh_entsize;
+   if (entSize < decoder->dynamicSize) {
+      return;
+   }
+   count  = section->data.Struct.sh_size / entSize;
+   table  = imageAt(image, section->data.Struct.sh_offset, count * entSize);
+   strtab = findStringTable(secTable, section, image, &strtabSize);
+   if (table == NULL || strtab == NULL) {
+      return;
+   }
+
+   entries = malloc((count > 0 ? count : 1) * sizeof(union dynamic_union));
+   decoder->decodeDynamic(table, count, entSize, entries);
+
+   // There are never more needed entries than dynamic entries
+   node->needed = malloc((count > 0 ? count : 1) * sizeof(char *));
+
+   // Iterate up to the DT_NULL entry
+   for (iter=0; iter < count && entries[iter].Struct.d_tag != DT_NULL; iter++) {
+
+      entry = &entries[iter].Struct;
+
+      // Skip strings that run outside the string table
+      if (entry->d_val >= strtabSize || memchr(strtab + entry->d_val, '\0', strtabSize - entry->d_val) == NULL) {
+         continue;
+      }
+      text = strtab + entry->d_val;
+
+      switch(entry->d_tag) {
+         case DT_NEEDED:
+            node->needed[node->neededCount++] = strdup(text);
+            break;
+         case DT_RPATH:
+            free(node->rpath);
+            node->rpath = strdup(text);
+            break;
+         case DT_RUNPATH:
+            free(node->runpath);
+            node->runpath = strdup(text);
+            break;
+      }
+   }
+
+   free(entries);
+}
+
+/**
+ * The loop run by each thread of a dependency walk.  Threads take
+ * queued libraries and parse them until the queue is empty and no
+ * other thread is still parsing (and so might queue more).
+ *
+ * INPUT:   pointer to the graph
+ *
+ * OUTPUT:  NULL
+ */
+void *dependencyWorker(void *arg) {
+
+   struct depNode *node;
+   struct depGraph *graph = arg;
+
+   pthread_mutex_lock(&graph->lock);
+
+   while (true) {
+
+      // Wait for work, or for every parse to finish
+      while (graph->queueHead == graph->queueTail && graph->active > 0) {
+         pthread_cond_wait(&graph->changed, &graph->lock);
+      }
+      if (graph->queueHead == graph->queueTail) {
+         break;
+      }
+
+      // Take the next library
+      node = graph->queue[graph->queueHead++];
+      graph->active++;
+      pthread_mutex_unlock(&graph->lock);
+
+      parseDependencyFile(graph, node);
+
+      // Mark it done and wake the others
+      pthread_mutex_lock(&graph->lock);
+      node->state = DEP_DONE;
+      graph->active--;
+      pthread_cond_broadcast(&graph->changed);
+   }
+
+   pthread_mutex_unlock(&graph->lock);
+
+   return NULL;
+}
+
+/**
+ * A function that parses a library found in the graph and resolves
+ * its needs, which queues any library not seen before.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the library's node
+ *
+ * OUTPUT:  none
+ */
+void parseDependencyFile(struct depGraph *graph, struct depNode *node) {
+
+   struct fileImage image;
+   union fileHeader_union fileHeader;
+   struct sectionTable secTable = {0};
+
+   if (!openFileImage(node->path, &image)) {
+      return;
+   }
+
+   if (readFileHeader(&fileHeader, &image) && readSectionHeaders(&fileHeader, &secTable, &image)) {
+      readDependencyInfo(node, &fileHeader, &secTable, &image);
+   }
+
+   freeSectionTable(&secTable);
+   closeFileImage(&image);
+
+   resolveDependencies(graph, node, displayDependencyPath(graph, node->path));
+}
+
+/**
+ * A function that finds the file for each of a node's needs.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the node
+ *          the node's path inside the sysroot, for $ORIGIN
+ *
+ * OUTPUT:  none
+ */
+void resolveDependencies(struct depGraph *graph, struct depNode *node, const char *displayPath) {
+
+   int iter;
+
+   node->children = calloc(node->neededCount + 1, sizeof(struct depNode *));
+
+   for (iter=0; iter < node->neededCount; iter++) {
+      node->children[iter] = findDependency(graph, node, displayPath, node->needed[iter]);
+   }
+}
+
+/**
+ * A function that finds the file for one needed name, searching in
+ * the loader's order: the name itself if it holds a slash, then the
+ * requester's DT_RPATH (only without a DT_RUNPATH), the --lib-path
+ * directories, the requester's DT_RUNPATH, and the default
+ * directories.  Only files of the requester's class, endianness and
+ * machine are accepted.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the node that needs the library
+ *          the requester's path inside the sysroot, for $ORIGIN
+ *          the needed name
+ *
+ * OUTPUT:  pointer to the library's node
+ *          NULL if no matching file was found
+ */
+struct depNode *findDependency(struct depGraph *graph, const struct depNode *requester, const char *displayPath, const char *name) {
+
+   int iter;
+   char origin[DEP_PATH_MAX];
+   char path[DEP_PATH_MAX];
+   const char *slash;
+   struct depNode *found = NULL;
+
+   // $ORIGIN is the requester's directory
+   slash = strrchr(displayPath, '/');
+   snprintf(origin, sizeof(origin), "%.*s", slash ? (int)(slash - displayPath) : 1, slash ? displayPath : ".");
+
+   // Names with a slash are paths
+   if (strchr(name, '/') != NULL) {
+      snprintf(path, sizeof(path), "%s%s", (*name == '/') ? graph->sysroot : "", name);
+      return tryDependency(graph, requester, path);
+   }
+
+   if (requester->rpath != NULL && requester->runpath == NULL) {
+      found = searchDependencyPath(graph, requester, origin, requester->rpath, name);
+   }
+   for (iter=0; iter < libPathCount && found == NULL; iter++) {
+      found = searchDependencyPath(graph, requester, origin, libPaths[iter], name);
+   }
+   if (found == NULL && requester->runpath != NULL) {
+      found = searchDependencyPath(graph, requester, origin, requester->runpath, name);
+   }
+   for (iter=0; iter < graph->searchDirCount && found == NULL; iter++) {
+      found = searchDependencyPath(graph, requester, origin, graph->searchDirs[iter], name);
+   }
+
+   return found;
+}
+
+/**
+ * A utility function that searches a colon separated list of
+ * directories for a library.  $ORIGIN and ${ORIGIN} at the start of a
+ * directory are replaced by the requester's directory.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the node that needs the library
+ *          the requester's directory inside the sysroot
+ *          colon separated directories, inside the sysroot
+ *          the needed name
+ *
+ * OUTPUT:  pointer to the library's node
+ *          NULL if no matching file was found
+ */
+struct depNode *searchDependencyPath(struct depGraph *graph, const struct depNode *requester, const char *origin, const char *pathList, const char *name) {
+
+   int length;
+   const char *dir = pathList;
+   const char *rest;
+   char path[DEP_PATH_MAX];
+   struct depNode *found;
+
+   while (*dir != '\0') {
+
+      length = strcspn(dir, ":");
+
+      // Build sysroot + directory + name
+      if (strncmp(dir, "$ORIGIN", 7) == 0 || strncmp(dir, "${ORIGIN}", 9) == 0) {
+         rest = dir + ((dir[1] == '{') ? 9 : 7);
+         snprintf(path, sizeof(path), "%s%s%.*s/%s", graph->sysroot, origin, (int)(length - (rest - dir)), rest, name);
+      } else if (length > 0) {
+         snprintf(path, sizeof(path), "%s%.*s/%s", graph->sysroot, length, dir, name);
+      } else {
+         snprintf(path, sizeof(path), "%s./%s", graph->sysroot, name);
+      }
+
+      if ( (found = tryDependency(graph, requester, path)) != NULL ) {
+         return found;
+      }
+
+      dir += length;
+      if (*dir == ':') {
+         dir++;
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * A utility function that checks whether a path holds a library the
+ * requester can use, and queues it for parsing the first time it is
+ * found.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the node that needs the library
+ *          path of the candidate on disk
+ *
+ * OUTPUT:  pointer to the library's node
+ *          NULL if the path doesn't hold a matching ELF file
+ */
+struct depNode *tryDependency(struct depGraph *graph, const struct depNode *requester, const char *path) {
+
+   struct depNode *node = lookupDependencyNode(graph, path);
+
+   // Only the requester's kind of file will do
+   if (!node->exists || node->elfClass != requester->elfClass ||
+       node->elfData != requester->elfData || node->machine != requester->machine) {
+      return NULL;
+   }
+
+   // Queue libraries seen for the first time
+   pthread_mutex_lock(&graph->lock);
+   if (node->state == DEP_NEW) {
+      node->state = DEP_QUEUED;
+      if (graph->queueTail == graph->queueSize) {
+         graph->queueSize = (graph->queueSize == 0) ? 64 : graph->queueSize * 2;
+         graph->queue     = realloc(graph->queue, graph->queueSize * sizeof(struct depNode *));
+      }
+      graph->queue[graph->queueTail++] = node;
+      pthread_cond_broadcast(&graph->changed);
+   }
+   pthread_mutex_unlock(&graph->lock);
+
+   return node;
+}
+
+/**
+ * A function that returns the node for a path, making one the first
+ * time the path is seen.  New nodes record whether the path holds an
+ * ELF file and its class, endianness and machine, read from the first
+ * bytes of the file without holding the lock.
+ *
+ * INPUT:   pointer to the graph
+ *          path on disk
+ *
+ * OUTPUT:  pointer to the path's node
+ */
+struct depNode *lookupDependencyNode(struct depGraph *graph, const char *path) {
+
+   int fd;
+   uint32_t mask;
+   uint32_t bucket;
+   unsigned char header[64] = {0};
+
+   struct depNode *node;
+   struct depNode *found = NULL;
+   union fileHeader_union fileHeader;
+
+   // Look for a node already made
+   pthread_mutex_lock(&graph->lock);
+   mask   = graph->bucketCount - 1;
+   bucket = hashName(path) & mask;
+   while ( (node = graph->buckets[bucket]) != NULL ) {
+      if (strcmp(node->path, path) == 0) {
+         found = node;
+         break;
+      }
+      bucket = (bucket + 1) & mask;
+   }
+   pthread_mutex_unlock(&graph->lock);
+
+   if (found != NULL) {
+      return found;
+   }
+
+   // Read the identification and machine of the file
+   node = calloc(1, sizeof(struct depNode));
+   node->path = strdup(path);
+   if ( (fd = open(path, O_RDONLY)) != -1 ) {
+      if (pread(fd, header, sizeof(header), 0) >= 20 &&
+          header[0] == 0x7f && header[1] == 'E' && header[2] == 'L' && header[3] == 'F') {
+         selectElfDecoder(header[4], header[5])->decodeFileHeader(header, &fileHeader);
+         node->exists   = true;
+         node->elfClass = header[4];
+         node->elfData  = header[5];
+         node->machine  = fileHeader.Struct.e_machine;
+      }
+      close(fd);
+   }
+
+   // Another thread may have made it meanwhile
+   pthread_mutex_lock(&graph->lock);
+   bucket = hashName(path) & (graph->bucketCount - 1);
+   while ( (found = graph->buckets[bucket]) != NULL && strcmp(found->path, path) != 0 ) {
+      bucket = (bucket + 1) & (graph->bucketCount - 1);
+   }
+   if (found == NULL) {
+      insertDependencyNode(graph, node);
+   }
+   pthread_mutex_unlock(&graph->lock);
+
+   if (found != NULL) {
+      free(node->path);
+      free(node);
+      return found;
+   }
+
+   return node;
+}
+
+/**
+ * A utility function that adds a node to the graph, growing the hash
+ * index once it is half full.  The lock must be held.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the new node
+ *
+ * OUTPUT:  none
+ */
+void insertDependencyNode(struct depGraph *graph, struct depNode *node) {
+
+   int iter;
+   uint32_t bucket;
+   struct depNode **oldBuckets;
+   int oldCount;
+
+   // Grow the node list
+   if (graph->count == graph->capacity) {
+      graph->capacity = (graph->capacity == 0) ? 64 : graph->capacity * 2;
+      graph->nodes    = realloc(graph->nodes, graph->capacity * sizeof(struct depNode *));
+   }
+   node->id = graph->count;
+   graph->nodes[graph->count++] = node;
+
+   // Rebuild the index at twice the size when it gets half full
+   if (2 * graph->count > graph->bucketCount) {
+      oldBuckets = graph->buckets;
+      oldCount   = graph->bucketCount;
+
+      graph->bucketCount *= 2;
+      graph->buckets      = calloc(graph->bucketCount, sizeof(struct depNode *));
+
+      for (iter=0; iter < oldCount; iter++) {
+         if (oldBuckets[iter] != NULL && oldBuckets[iter] != node) {
+            bucket = hashName(oldBuckets[iter]->path) & (graph->bucketCount - 1);
+            while (graph->buckets[bucket] != NULL) {
+               bucket = (bucket + 1) & (graph->bucketCount - 1);
+            }
+            graph->buckets[bucket] = oldBuckets[iter];
+         }
+      }
+      free(oldBuckets);
+   }
+
+   // Insert the new node
+   bucket = hashName(node->path) & (graph->bucketCount - 1);
+   while (graph->buckets[bucket] != NULL) {
+      bucket = (bucket + 1) & (graph->bucketCount - 1);
+   }
+   graph->buckets[bucket] = node;
+}
+
+/**
+ * A function that prints a node's needs as an indented tree.  A
+ * library's own needs are only listed the first time it appears.
+ *
+ * INPUT:   pointer to the graph
+ *          pointer to the node
+ *          depth of the node in the tree
+ *          array marking the libraries already listed
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printDependencyTree(const struct depGraph *graph, const struct depNode *node, int depth, bool *listed, struct outputBuffer *out) {
+
+   int iter;
+   const struct depNode *child;
+
+   for (iter=0; iter < node->neededCount; iter++) {
+
+      child = node->children[iter];
+      writeTextPadded(out, "", 2 * (depth + 1));
+      writeText(out, node->needed[iter]);
+      writeText(out, " => ");
+
+      if (child == NULL) {
+         writeText(out, "not found\n");
+      } else if (listed[child->id]) {
+         writeText(out, displayDependencyPath(graph, child->path));
+         writeText(out, " (see above)\n");
+      } else {
+         writeText(out, displayDependencyPath(graph, child->path));
+         writeChar(out, '\n');
+         listed[child->id] = true;
+         printDependencyTree(graph, child, depth + 1, listed, out);
+      }
+   }
+}
+
+/**
+ * A utility function that gives a path as seen inside the sysroot.
+ *
+ * INPUT:   pointer to the graph
+ *          path on disk
+ *
+ * OUTPUT:  the path without the sysroot in front
+ */
+const char *displayDependencyPath(const struct depGraph *graph, const char *path) {
+
+   size_t length = strlen(graph->sysroot);
+
+   if (length > 0 && strncmp(path, graph->sysroot, length) == 0 && path[length] == '/') {
+      return path + length;
+   }
+
+   return path;
+}
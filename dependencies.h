@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file dependencies.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <pthread.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern int workerCount;
+extern int poolWorkerCount;
+extern const char *sysrootDir;
+extern char **libPaths;
+extern int libPathCount;
+
+// Local Prototypes
+void printDependencies(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+struct depGraph *getDependencyGraph(void);
+void readLdSoConf(struct depGraph *graph, const char *confName, int depth);
+void addSearchDir(struct depGraph *graph, const char *dir);
+void readDependencyInfo(struct depNode *node, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image);
+void *dependencyWorker(void *arg);
+void parseDependencyFile(struct depGraph *graph, struct depNode *node);
+void resolveDependencies(struct depGraph *graph, struct depNode *node, const char *displayPath);
+struct depNode *findDependency(struct depGraph *graph, const struct depNode *requester, const char *displayPath, const char *name);
+struct depNode *searchDependencyPath(struct depGraph *graph, const struct depNode *requester, const char *origin, const char *pathList, const char *name);
+struct depNode *tryDependency(struct depGraph *graph, const struct depNode *requester, const char *path);
+struct depNode *lookupDependencyNode(struct depGraph *graph, const char *path);
+void insertDependencyNode(struct depGraph *graph, struct depNode *node);
+void printDependencyTree(const struct depGraph *graph, const struct depNode *node, int depth, bool *listed, struct outputBuffer *out);
+const char *displayDependencyPath(const struct depGraph *graph, const char *path);
+
+// Other Prototypes
+bool openFileImage(const char *fileName, struct fileImage *image);
+void closeFileImage(struct fileImage *image);
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void freeSectionTable(struct sectionTable *secTable);
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+int findSectionByType(const struct sectionTable *secTable, uint32_t type, int start);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+uint32_t hashName(const char *name);
+
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+// Defines
+#define SHT_DYNAMIC 6
+
+#define DT_NULL    0
+#define DT_NEEDED  1
+#define DT_RPATH   15
+#define DT_RUNPATH 29
+
+#define DEP_NEW     0
+#define DEP_QUEUED  1
+#define DEP_DONE    2
+
+#define DEP_MAX_THREADS 8
+#define DEP_CONF_DEPTH 4
+#define DEP_PATH_MAX 4096
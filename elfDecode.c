@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file elfDecode.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "elfDecode.h"
+
+/**
+ * Unaligned loads of host-endian words.  The LOAD_LE and LOAD_BE
+ * macros pick a plain load or a byte-reversed load at compile time,
+ * depending on the endianness of the machine running this program.
+ */
+static inline uint16_t loadHost16(const unsigned char *p) { uint16_t v; memcpy(&v, p, 2); return v; }
+static inline uint32_t loadHost32(const unsigned char *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+static inline uint64_t loadHost64(const unsigned char *p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define LOAD_LE16(p) loadHost16(p)
+#define LOAD_LE32(p) loadHost32(p)
+#define LOAD_LE64(p) loadHost64(p)
+#define LOAD_BE16(p) __builtin_bswap16(loadHost16(p))
+#define LOAD_BE32(p) __builtin_bswap32(loadHost32(p))
+#define LOAD_BE64(p) __builtin_bswap64(loadHost64(p))
+#else
+#define LOAD_LE16(p) __builtin_bswap16(loadHost16(p))
+#define LOAD_LE32(p) __builtin_bswap32(loadHost32(p))
+#define LOAD_LE64(p) __builtin_bswap64(loadHost64(p))
+#define LOAD_BE16(p) loadHost16(p)
+#define LOAD_BE32(p) loadHost32(p)
+#define LOAD_BE64(p) loadHost64(p)
+#endif
+
+// Single bytes need no swapping
+#define LOAD8(p) (*(p))
+
+// Loads a field of an on-disk struct from a raw byte pointer
+#define FIELD(LOAD, raw, STRUCT, field) LOAD((raw) + offsetof(struct STRUCT, field))
+
+/**
+ * The single definition every decoder is generated from.  Each use
+ * fixes the on-disk struct layouts and the load for each field width,
+ * so a decoder's loops never check the class or endianness.  Every
+ * decoder writes the 64bit, host-endian form the rest of the program
+ * uses.  Single word decoders are included for tables, like the hash
+ * sections, that are read in place instead of decoded in bulk.
+ *
+ * INPUT:   suffix for the generated function names
+ *          on-disk ELF header struct
+ *          on-disk section header struct
+ *          on-disk program header struct
+ *          on-disk symbol struct
+ *          on-disk relocation (with addend) struct
+ *          on-disk dynamic section struct
+ *          bits below the symbol in a relocation's info word
+ *          loads for 16bit, 32bit and address-sized fields
+ */
+#define DEFINE_ELF_DECODERS(SUFFIX, EHDR, SHDR, PHDR, SYM, RELA, DYN, RSHIFT, LOAD16, LOAD32, LOADWORD) \
+                                                                                          \
+uint32_t decodeWord##SUFFIX(const unsigned char *raw) {                                   \
+   return LOAD32(raw);                                                                    \
+}                                                                                         \
+                                                                                          \
+uint64_t decodeAddress##SUFFIX(const unsigned char *raw) {                                \
+   return LOADWORD(raw);                                                                  \
+}                                                                                         \
+                                                                                          \
+void decodeFileHeader##SUFFIX(const unsigned char *raw, union fileHeader_union *fileHeader) { \
+                                                                                          \
+   /* Identification bytes are copied as is */                                            \
+   memcpy(fileHeader->arr, raw, 16);                                                      \
+                                                                                          \
+   fileHeader->Struct.e_type      = FIELD(LOAD16,   raw, EHDR, e_type);                   \
+   fileHeader->Struct.e_machine   = FIELD(LOAD16,   raw, EHDR, e_machine);                \
+   fileHeader->Struct.e_version   = FIELD(LOAD32,   raw, EHDR, e_version);                \
+   fileHeader->Struct.e_entry     = FIELD(LOADWORD, raw, EHDR, e_entry);                  \
+   fileHeader->Struct.e_phoff     = FIELD(LOADWORD, raw, EHDR, e_phoff);                  \
+   fileHeader->Struct.e_shoff     = FIELD(LOADWORD, raw, EHDR, e_shoff);                  \
+   fileHeader->Struct.e_flags     = FIELD(LOAD32,   raw, EHDR, e_flags);                  \
+   fileHeader->Struct.e_ehsize    = FIELD(LOAD16,   raw, EHDR, e_ehsize);                 \
+   fileHeader->Struct.e_phentsize = FIELD(LOAD16,   raw, EHDR, e_phentsize);              \
+   fileHeader->Struct.e_phnum     = FIELD(LOAD16,   raw, EHDR, e_phnum);                  \
+   fileHeader->Struct.e_shentsize = FIELD(LOAD16,   raw, EHDR, e_shentsize);              \
+   fileHeader->Struct.e_shnum     = FIELD(LOAD16,   raw, EHDR, e_shnum);                  \
+   fileHeader->Struct.e_shstrndx  = FIELD(LOAD16,   raw, EHDR, e_shstrndx);               \
+}                                                                                         \
+                                                                                          \
+void decodeSectionHeaders##SUFFIX(const unsigned char *table, int count, int entSize,     \
+                                  struct sectionEntry *sections) {                        \
+                                                                                          \
+   int iter;                                                                              \
+   const unsigned char *raw;                                                              \
+   struct sectionHeader_struct64 *secHeader;                                              \
+                                                                                          \
+   for (iter=0; iter < count; iter++) {                                                   \
+                                                                                          \
+      raw       = table + (uint64_t)iter * entSize;                                       \
+      secHeader = &sections[iter].data.Struct;                                            \
+                                                                                          \
+      sections[iter].index    = iter;                                                     \
+      secHeader->sh_name      = FIELD(LOAD32,   raw, SHDR, sh_name);                      \
+      secHeader->sh_type      = FIELD(LOAD32,   raw, SHDR, sh_type);                      \
+      secHeader->sh_flags     = FIELD(LOADWORD, raw, SHDR, sh_flags);                     \
+      secHeader->sh_addr      = FIELD(LOADWORD, raw, SHDR, sh_addr);                      \
+      secHeader->sh_offset    = FIELD(LOADWORD, raw, SHDR, sh_offset);                    \
+      secHeader->sh_size      = FIELD(LOADWORD, raw, SHDR, sh_size);                      \
+      secHeader->sh_link      = FIELD(LOAD32,   raw, SHDR, sh_link);                      \
+      secHeader->sh_info      = FIELD(LOAD32,   raw, SHDR, sh_info);                      \
+      secHeader->sh_addralign = FIELD(LOADWORD, raw, SHDR, sh_addralign);                 \
+      secHeader->sh_entsize   = FIELD(LOADWORD, raw, SHDR, sh_entsize);                   \
+   }                                                                                      \
+}                                                                                         \
+                                                                                          \
+void decodeProgramHeaders##SUFFIX(const unsigned char *table, int count, int entSize,     \
+                                  union programHeader_union *segments) {                  \
+                                                                                          \
+   int iter;                                                                              \
+   const unsigned char *raw;                                                              \
+   struct programHeader_struct64 *progHeader;                                             \
+                                                                                          \
+   for (iter=0; iter < count; iter++) {                                                   \
+                                                                                          \
+      raw        = table + (uint64_t)iter * entSize;                                      \
+      progHeader = &segments[iter].Struct;                                                \
+                                                                                          \
+      progHeader->p_type   = FIELD(LOAD32,   raw, PHDR, p_type);                          \
+      progHeader->p_flags  = FIELD(LOAD32,   raw, PHDR, p_flags);                         \
+      progHeader->p_offset = FIELD(LOADWORD, raw, PHDR, p_offset);                        \
+      progHeader->p_vaddr  = FIELD(LOADWORD, raw, PHDR, p_vaddr);                         \
+      progHeader->p_paddr  = FIELD(LOADWORD, raw, PHDR, p_paddr);                         \
+      progHeader->p_filesz = FIELD(LOADWORD, raw, PHDR, p_filesz);                        \
+      progHeader->p_memsz  = FIELD(LOADWORD, raw, PHDR, p_memsz);                         \
+      progHeader->p_align  = FIELD(LOADWORD, raw, PHDR, p_align);                         \
+   }                                                                                      \
+}                                                                                         \
+                                                                                          \
+void decodeSymbols##SUFFIX(const unsigned char *table, int count, int entSize,            \
+                           union symbol_union *symbols) {                                 \
+                                                                                          \
+   int iter;                                                                              \
+   const unsigned char *raw;                                                              \
+   struct symbol_struct64 *symbol;                                                        \
+                                                                                          \
+   for (iter=0; iter < count; iter++) {                                                   \
+                                                                                          \
+      raw    = table + (uint64_t)iter * entSize;                                          \
+      symbol = &symbols[iter].Struct;                                                     \
+                                                                                          \
+      symbol->st_name  = FIELD(LOAD32,   raw, SYM, st_name);                              \
+      symbol->st_info  = FIELD(LOAD8,    raw, SYM, st_info);                              \
+      symbol->st_other = FIELD(LOAD8,    raw, SYM, st_other);                             \
+      symbol->st_shndx = FIELD(LOAD16,   raw, SYM, st_shndx);                             \
+      symbol->st_value = FIELD(LOADWORD, raw, SYM, st_value);                             \
+      symbol->st_size  = FIELD(LOADWORD, raw, SYM, st_size);                              \
+   }                                                                                      \
+}                                                                                         \
+                                                                                          \
+void decodeRelocations##SUFFIX(const unsigned char *table, int count, int entSize,        \
+                               bool rela, struct relocationEntry *relocations) {          \
+                                                                                          \
+   int iter;                                                                              \
+   const unsigned char *raw;                                                              \
+   struct relocationEntry *reloc;                                                         \
+                                                                                          \
+   for (iter=0; iter < count; iter++) {                                                   \
+                                                                                          \
+      raw   = table + (uint64_t)iter * entSize;                                           \
+      reloc = &relocations[iter];                                                         \
+                                                                                          \
+      reloc->offset = FIELD(LOADWORD, raw, RELA, r_offset);                               \
+      reloc->info   = FIELD(LOADWORD, raw, RELA, r_info);                                 \
+      reloc->symbol = reloc->info >> RSHIFT;                                              \
+      reloc->type   = reloc->info & (((uint64_t)1 << RSHIFT) - 1);                        \
+                                                                                          \
+      /* Addends are signed, so 32bit ones are sign extended */                           \
+      if (!rela) {                                                                        \
+         reloc->addend = 0;                                                               \
+      } else if (RSHIFT == 8) {                                                           \
+         reloc->addend = (int32_t)FIELD(LOADWORD, raw, RELA, r_addend);                   \
+      } else {                                                                            \
+         reloc->addend = (int64_t)FIELD(LOADWORD, raw, RELA, r_addend);                   \
+      }                                                                                   \
+   }                                                                                      \
+}                                                                                         \
+                                                                                          \
+void decodeDynamic##SUFFIX(const unsigned char *table, int count, int entSize,            \
+                           union dynamic_union *entries) {                                \
+                                                                                          \
+   int iter;                                                                              \
+   const unsigned char *raw;                                                              \
+   struct dynamic_struct64 *entry;                                                        \
+                                                                                          \
+   for (iter=0; iter < count; iter++) {                                                   \
+                                                                                          \
+      raw   = table + (uint64_t)iter * entSize;                                           \
+      entry = &entries[iter].Struct;                                                      \
+                                                                                          \
+      /* Tags are signed, so 32bit ones are sign extended */                              \
+      if (RSHIFT == 8) {                                                                  \
+         entry->d_tag = (int32_t)FIELD(LOADWORD, raw, DYN, d_tag);                        \
+      } else {                                                                            \
+         entry->d_tag = (int64_t)FIELD(LOADWORD, raw, DYN, d_tag);                        \
+      }                                                                                   \
+      entry->d_val = FIELD(LOADWORD, raw, DYN, d_val);                                    \
+   }                                                                                      \
+}
+
+// The four class/endianness combinations
+DEFINE_ELF_DECODERS(32LE, fileHeader_struct32, sectionHeader_struct32, programHeader_struct32, symbol_struct32, relocation_struct32, dynamic_struct32, 8, LOAD_LE16, LOAD_LE32, LOAD_LE32)
+DEFINE_ELF_DECODERS(32BE, fileHeader_struct32, sectionHeader_struct32, programHeader_struct32, symbol_struct32, relocation_struct32, dynamic_struct32, 8, LOAD_BE16, LOAD_BE32, LOAD_BE32)
+DEFINE_ELF_DECODERS(64LE, fileHeader_struct64, sectionHeader_struct64, programHeader_struct64, symbol_struct64, relocation_struct64, dynamic_struct64, 32, LOAD_LE16, LOAD_LE32, LOAD_LE64)
+DEFINE_ELF_DECODERS(64BE, fileHeader_struct64, sectionHeader_struct64, programHeader_struct64, symbol_struct64, relocation_struct64, dynamic_struct64, 32, LOAD_BE16, LOAD_BE32, LOAD_BE64)
+
+// Decoder table, indexed by [64bit][big endian]
+static const struct elfDecoder elfDecoders[2][2] = {
+   {
+      { 52, 40, 32, 16, 8, 12, 8, decodeFileHeader32LE, decodeSectionHeaders32LE, decodeProgramHeaders32LE, decodeSymbols32LE, decodeRelocations32LE, decodeDynamic32LE, decodeWord32LE, decodeAddress32LE },
+      { 52, 40, 32, 16, 8, 12, 8, decodeFileHeader32BE, decodeSectionHeaders32BE, decodeProgramHeaders32BE, decodeSymbols32BE, decodeRelocations32BE, decodeDynamic32BE, decodeWord32BE, decodeAddress32BE },
+   },
+   {
+      { 64, 64, 56, 24, 16, 24, 16, decodeFileHeader64LE, decodeSectionHeaders64LE, decodeProgramHeaders64LE, decodeSymbols64LE, decodeRelocations64LE, decodeDynamic64LE, decodeWord64LE, decodeAddress64LE },
+      { 64, 64, 56, 24, 16, 24, 16, decodeFileHeader64BE, decodeSectionHeaders64BE, decodeProgramHeaders64BE, decodeSymbols64BE, decodeRelocations64BE, decodeDynamic64BE, decodeWord64BE, decodeAddress64BE },
+   },
+};
+
+/**
+ * A function that picks the decoders for a file from its EI_CLASS and
+ * EI_DATA bytes.  This is done once per file; anything that is not
+ * 32bit is read as 64bit, and anything that is not big endian is
+ * read as little endian.
+ *
+ * INPUT:   EI_CLASS byte of the file
+ *          EI_DATA byte of the file
+ *
+ * OUTPUT:  pointer to the matching decoders
+ */
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData) {
+   return &elfDecoders[elfClass != BIT32][elfData == ENDIAN_BIG];
+}
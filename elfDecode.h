@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file elfDecode.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "customDataTypes.h"
+
+// Declares the decoders for one ELF class/endianness combination
+#define DECLARE_ELF_DECODERS(SUFFIX) \
+   uint32_t decodeWord##SUFFIX(const unsigned char *raw); \
+   uint64_t decodeAddress##SUFFIX(const unsigned char *raw); \
+   void decodeFileHeader##SUFFIX(const unsigned char *raw, union fileHeader_union *fileHeader); \
+   void decodeSectionHeaders##SUFFIX(const unsigned char *table, int count, int entSize, struct sectionEntry *sections); \
+   void decodeProgramHeaders##SUFFIX(const unsigned char *table, int count, int entSize, union programHeader_union *segments); \
+   void decodeSymbols##SUFFIX(const unsigned char *table, int count, int entSize, union symbol_union *symbols); \
+   void decodeRelocations##SUFFIX(const unsigned char *table, int count, int entSize, bool rela, struct relocationEntry *relocations); \
+   void decodeDynamic##SUFFIX(const unsigned char *table, int count, int entSize, union dynamic_union *entries);
+
+// Local Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+
+DECLARE_ELF_DECODERS(32LE)
+DECLARE_ELF_DECODERS(32BE)
+DECLARE_ELF_DECODERS(64LE)
+DECLARE_ELF_DECODERS(64BE)
+
+// Defines
+#define BIT32 1
+#define BIT64 2
+#define ENDIAN_LITTLE 1
+#define ENDIAN_BIG 2
@@ -15,272 +15,287 @@
 /**
  * A function that reads a file's ELF header and stores the hex
  * values in a struct, whose pointer is passed to the function.
- * An endian-dependent utility function is used to help store the
- * header's content.
+ * The decoder for the file's class and endianness is picked from
+ * the identification bytes and stores the header's content.  Files
+ * too short to hold the whole header for their class are rejected.
  *
  * INPUT:   pointer to struct to store header info
- *          pointer to file to read
+ *          pointer to the image of the file to read
  *
  * OUTPUT:  true if the ELF header was successfully read
  *          false if not
  */
-bool readFileHeader(union fileHeader_union *fileHeader, FILE *file) {
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image) {
 
-   int i;
-   char buffer[64];
-
-   // Read file into buffer
-   for (i = 0; i < 64; i++) {
-      buffer[i] = fgetc(file);
-   }
+   const unsigned char *raw;
+   const struct elfDecoder *decoder;
 
    // Verify file is an ELF
-   if ( buffer[0] != 0x7f || buffer[1] != 'E' || buffer[2] != 'L' || buffer[3] != 'F' ) {
+   if (!hasElfMagic(image)) {
       return false; // tell parent function that file is incorrect
    }
 
-   // Copy buffer to union
-   memcpy(fileHeader->arr, buffer, 64);
-
-   // Make sure union is in 64bit format
-   if (fileHeader->arr[4] == BIT32) {
-      fileHeader32to64(fileHeader);
+   // The whole header for the file's class must be in the file
+   if ( (raw = imageAt(image, 0, EI_NIDENT)) == NULL ) {
+      return false;
    }
-
-   // Make sure file endian matches local endian
-   if (!checkSameEndian(fileHeader->arr[5])) {
-      fileHeaderEndianSwap(fileHeader);
+   decoder = selectElfDecoder(raw[4], raw[5]);
+   if ( (raw = imageAt(image, 0, decoder->fileHeaderSize)) == NULL ) {
+      return false;
    }
 
+   // Decode the header into 64bit, local endian format
+   decoder->decodeFileHeader(raw, fileHeader);
+
    // Tell parent funtion that header successfully read
    return true;
 }
 
 /**
- * A utility function that converts a fileHeader's content from
- * 32bit to 64bit.  All other functions rely on the fileHeader info
- * to be in 64bit format.
+ * A utility function that checks a file starts with the ELF magic
+ * bytes, so a file that isn't an ELF can be told apart from one whose
+ * header is cut short.
  *
- * INPUT:   pointer to the fileHeader to update
+ * INPUT:   pointer to the image of the file
  *
- * OUTPUT:  none
+ * OUTPUT:  true if the file starts with 0x7f 'E' 'L' 'F'
+ *          false otherwise
  */
-void fileHeader32to64(union fileHeader_union *fileHeader) {
-
-   // Copy regular fields from 32struct to 64struct in reverse order
-   fileHeader->Struct.e_shstrndx  = fileHeader->Struct32.e_shstrndx;
-   fileHeader->Struct.e_shnum     = fileHeader->Struct32.e_shnum;
-   fileHeader->Struct.e_shentsize = fileHeader->Struct32.e_shentsize;
-   fileHeader->Struct.e_phnum     = fileHeader->Struct32.e_phnum;
-   fileHeader->Struct.e_phentsize = fileHeader->Struct32.e_phentsize;
-   fileHeader->Struct.e_ehsize    = fileHeader->Struct32.e_ehsize;
-   fileHeader->Struct.e_flags     = fileHeader->Struct32.e_flags;
-
-   // Copy pointer fields from 32struct to 64struct in reverse order
-   fileHeader->Struct.e_shoff     = (uint64_t)fileHeader->Struct32.e_shoff;
-   fileHeader->Struct.e_phoff     = (uint64_t)fileHeader->Struct32.e_phoff;
-   fileHeader->Struct.e_entry     = (uint64_t)fileHeader->Struct32.e_entry;
-}
+bool hasElfMagic(const struct fileImage *image) {
 
-/**
- * A utility function that converts a fileHeader's content to
- * the same endianness as this program. All other functions rely
- * on the fileHeader info to be the same endianness as the 
- * machine this is running on.
- *
- * INPUT:   pointer to the fileHeader to update
- *
- * OUTPUT:  none
- */
-void fileHeaderEndianSwap(union fileHeader_union *fileHeader) {
-
-   // Swap endianness
-   fileHeader->Struct.e_type      = endianSwap16Bit(fileHeader->Struct.e_type);
-   fileHeader->Struct.e_machine   = endianSwap16Bit(fileHeader->Struct.e_machine);
-
-   fileHeader->Struct.e_version   = endianSwap32Bit(fileHeader->Struct.e_version);
+   const unsigned char *magic;
 
-   fileHeader->Struct.e_entry     = endianSwap64Bit(fileHeader->Struct.e_entry);
-   fileHeader->Struct.e_phoff     = endianSwap64Bit(fileHeader->Struct.e_phoff);
-   fileHeader->Struct.e_shoff     = endianSwap64Bit(fileHeader->Struct.e_shoff);
+   magic = imageAt(image, 0, 4);
 
-   fileHeader->Struct.e_flags     = endianSwap32Bit(fileHeader->Struct.e_flags);
-
-   fileHeader->Struct.e_ehsize    = endianSwap16Bit(fileHeader->Struct.e_ehsize);
-   fileHeader->Struct.e_phentsize = endianSwap16Bit(fileHeader->Struct.e_phentsize);
-   fileHeader->Struct.e_phnum     = endianSwap16Bit(fileHeader->Struct.e_phnum);
-   fileHeader->Struct.e_shentsize = endianSwap16Bit(fileHeader->Struct.e_shentsize);
-   fileHeader->Struct.e_shnum     = endianSwap16Bit(fileHeader->Struct.e_shnum);
-   fileHeader->Struct.e_shstrndx  = endianSwap16Bit(fileHeader->Struct.e_shstrndx);
+   return (magic != NULL && memcmp(magic, "\x7f" "ELF", 4) == 0);
 }
 
 /**
  * A function that processes and prints the ELF header info, stored in
- * a struct whose pointer is passed in.  A utility function is used to
- * convert the multi-byte values into an int.
+ * a struct whose pointer is passed in.  Each line is formatted straight
+ * into the output buffer.  Under extended numbering the real section
+ * count and string table index follow the raw values in parentheses.
  *
  * INPUT:   pointer to struct to store header info
+ *          pointer to the section table, may be NULL if not read
+ *          output buffer to print to
  *
  * OUTPUT:  none
  */
-void printFileHeader(const union fileHeader_union *fileHeader) {
+void printFileHeader(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out) {
 
    int i;
    int bit;
-   char buffer[256];
+   const char *text;
    char magicBytes[16];
 
    // Print magic bytes
    memcpy(magicBytes, fileHeader->arr, 16);
    bit = magicBytes[4];
 
-   printf("ELF Header:\n");
-   printf("  Magic:    ");
-   for (i = 0; i < 15; i++) {
-      printf("%02x ", magicBytes[i]);
+   writeText(out, "ELF Header:\n");
+   writeText(out, "  Magic:    ");
+   for (i = 0; i < 16; i++) {
+      writeHex(out, (unsigned int)magicBytes[i], 2);
+      writeChar(out, (i < 15) ? ' ' : '\n');
    }
-   printf("%02x\n", magicBytes[i]);
   
    // Print EI_CLASS
    switch(magicBytes[4]) {
       case BIT32:
-         strcpy(buffer, "ELF32");
+         text = "ELF32";
          break;
       case BIT64:
-         strcpy(buffer, "ELF64");
+         text = "ELF64";
          break;
       default:
-         strcpy(buffer, "Unsupported EI_CLASS type!");
+         text = "Unsupported EI_CLASS type!";
    }
-   printf("  Class:\t\t\t     %s\n", buffer);
+   writeText(out, "  Class:\t\t\t     ");
+   writeText(out, text);
+   writeChar(out, '\n');
 
    // Print EI_DATA
    switch(bit) {
       case ENDIAN_LITTLE:
-         strcpy(buffer, "2\'s complement, little endian");
+         text = "2\'s complement, little endian";
          break;
       case ENDIAN_BIG:
-         strcpy(buffer, "2\'s complement, big endian");
+         text = "2\'s complement, big endian";
          break;
       default:
-         strcpy(buffer, "Unsupported EI_DATA type!");
+         text = "Unsupported EI_DATA type!";
    }
-   printf("  Data:\t\t\t\t     %s\n", buffer);
+   writeText(out, "  Data:\t\t\t\t     ");
+   writeText(out, text);
+   writeChar(out, '\n');
 
    // Print EI_VERSION
    switch(magicBytes[6]) {
       case 0x01:
-         printf("  Version:\t\t\t     1 (current)\n");
+         writeText(out, "  Version:\t\t\t     1 (current)\n");
          break;
       default:
-         printf("  Version:\t\t\t     %d\n", (int)(magicBytes[6]));
+         writeText(out, "  Version:\t\t\t     ");
+         writeSigned(out, magicBytes[6]);
+         writeChar(out, '\n');
    }
 
    // Print EI_OSABI
    switch(magicBytes[7]) {
       case 0x00:
-         strcpy(buffer, "UNIX - System V");
+         text = "UNIX - System V";
          break;
       case 0x01:
-         strcpy(buffer, "HP-UX");
+         text = "HP-UX";
          break;
       case 0x02:
-         strcpy(buffer, "NetBSD");
+         text = "NetBSD";
          break;
       case 0x03:
-         strcpy(buffer, "Linux");
+         text = "Linux";
          break;
       case 0x04:
-         strcpy(buffer, "GNU Hurd");
+         text = "GNU Hurd";
          break;
       default:
-         strcpy(buffer, "Unsupported EI_OSABI type!");
+         text = "Unsupported EI_OSABI type!";
    }
-   printf("  OS/ABI:\t\t\t     %s\n", buffer);
+   writeText(out, "  OS/ABI:\t\t\t     ");
+   writeText(out, text);
+   writeChar(out, '\n');
 
    // Print EI_ABIVERSION
-   printf("  ABI Version:\t\t\t     %d\n", (int)magicBytes[8]);
+   writeText(out, "  ABI Version:\t\t\t     ");
+   writeSigned(out, magicBytes[8]);
+   writeChar(out, '\n');
 
    // Print e_type
-   switch(fileHeader->Struct.e_type) {
-      case 0x00:
-         strcpy(buffer, "No file type");
-         break;
-      case 0x01:
-         strcpy(buffer, "Relocatable file");
-         break;
-      case 0x02:
-         strcpy(buffer, "Executable file");
-         break;
-      case 0x03:
-         strcpy(buffer, "DYN (Shared object file)");
-         break;
-      case 0x04:
-         strcpy(buffer, "Core file");
-         break;
-      default:
-         strcpy(buffer, "Unsupported e_file type!");
-   }
-   printf("  Type:\t\t\t\t     %s\n", buffer);
+   writeText(out, "  Type:\t\t\t\t     ");
+   writeText(out, fileTypeName(fileHeader->Struct.e_type));
+   writeChar(out, '\n');
 
    // Print e_machine
    switch(fileHeader->Struct.e_machine) {
       case 0x00:
-         strcpy(buffer, "No machine");
+         text = "No machine";
          break;
       case 0x01:
-         strcpy(buffer, "AT&T WE 32100");
+         text = "AT&T WE 32100";
          break;
       case 0x02:
-         strcpy(buffer, "SPARC");
+         text = "SPARC";
          break;
       case 0x03:
-         strcpy(buffer, "Intel 80386");
+         text = "Intel 80386";
          break;
       case 0x28:
-         strcpy(buffer, "ARM");
+         text = "ARM";
          break;
       case 0x3e:
-         strcpy(buffer, "Advanced Micro Devices X86-64");
+         text = "Advanced Micro Devices X86-64";
          break;
       default:
-         strcpy(buffer, "Unsupported e_file type!");
+         text = "Unsupported e_file type!";
    }
-   printf("  Machine:\t\t\t     %s\n", buffer);
+   writeText(out, "  Machine:\t\t\t     ");
+   writeText(out, text);
+   writeChar(out, '\n');
 
    // Print e_version
-   printf("  Version:\t\t\t     0x%x\n", fileHeader->Struct.e_version);
-
-   // Print e_entry
-   printf("  Entry point address:\t\t     %p\n", (void *)fileHeader->Struct.e_entry);
+   writeText(out, "  Version:\t\t\t     0x");
+   writeHex(out, fileHeader->Struct.e_version, 1);
+   writeChar(out, '\n');
+
+   // Print e_entry, the way %p does
+   writeText(out, "  Entry point address:\t\t     ");
+   if (fileHeader->Struct.e_entry == 0) {
+      writeText(out, "(nil)");
+   } else {
+      writeText(out, "0x");
+      writeHex(out, fileHeader->Struct.e_entry, 1);
+   }
+   writeChar(out, '\n');
 
    // Print e_phoff
-   printf("  Start of program headers:\t     %ld (bytes into file)\n",
-         fileHeader->Struct.e_phoff);
+   writeText(out, "  Start of program headers:\t     ");
+   writeSigned(out, fileHeader->Struct.e_phoff);
+   writeText(out, " (bytes into file)\n");
 
    // Print e_shoff
-   printf("  Start of section headers:\t     %ld (bytes into file)\n",
-         fileHeader->Struct.e_shoff);
+   writeText(out, "  Start of section headers:\t     ");
+   writeSigned(out, fileHeader->Struct.e_shoff);
+   writeText(out, " (bytes into file)\n");
 
    // Print e_flags
-   printf("  Flags:\t\t\t     0x%x\n", fileHeader->Struct.e_flags);
+   writeText(out, "  Flags:\t\t\t     0x");
+   writeHex(out, fileHeader->Struct.e_flags, 1);
+   writeChar(out, '\n');
 
    // Print e_ehsize
-   printf("  Size of this header:\t\t     %d (bytes)\n", fileHeader->Struct.e_ehsize);
+   writeText(out, "  Size of this header:\t\t     ");
+   writeUnsigned(out, fileHeader->Struct.e_ehsize);
+   writeText(out, " (bytes)\n");
 
    // Print e_phentsize
-   printf("  Size of program headers:\t     %d (bytes)\n", fileHeader->Struct.e_phentsize);
+   writeText(out, "  Size of program headers:\t     ");
+   writeUnsigned(out, fileHeader->Struct.e_phentsize);
+   writeText(out, " (bytes)\n");
 
    // Print e_phnum
-   printf("  Number of program headers:\t     %d\n", fileHeader->Struct.e_phnum);
+   writeText(out, "  Number of program headers:\t     ");
+   writeUnsigned(out, fileHeader->Struct.e_phnum);
+   writeChar(out, '\n');
 
    // Print e_shentsize
-   printf("  Size of section headers:\t     %d (bytes)\n", fileHeader->Struct.e_shentsize);
+   writeText(out, "  Size of section headers:\t     ");
+   writeUnsigned(out, fileHeader->Struct.e_shentsize);
+   writeText(out, " (bytes)\n");
 
    // Print e_shnum
-   printf("  Number of section headers:\t     %d\n", fileHeader->Struct.e_shnum);
+   writeText(out, "  Number of section headers:\t     ");
+   writeUnsigned(out, fileHeader->Struct.e_shnum);
+   if (fileHeader->Struct.e_shnum == 0 && secTable != NULL && secTable->count > 0) {
+      writeText(out, " (");
+      writeUnsigned(out, secTable->count);
+      writeChar(out, ')');
+   }
+   writeChar(out, '\n');
 
    // Print e_shstrndx
-   printf("  Section header string table index: %d\n", fileHeader->Struct.e_shstrndx);
+   writeText(out, "  Section header string table index: ");
+   writeUnsigned(out, fileHeader->Struct.e_shstrndx);
+   if (fileHeader->Struct.e_shstrndx == SHN_XINDEX && secTable != NULL && secTable->count > 0) {
+      writeText(out, " (");
+      writeUnsigned(out, secTable->sections[0].data.Struct.sh_link);
+      writeChar(out, ')');
+   }
+   writeChar(out, '\n');
+}
+
+/**
+ * A utility function that names an ELF file type.  Shared by the ELF
+ * header and program header printers.
+ *
+ * INPUT:   e_type value
+ *
+ * OUTPUT:  name of the file type
+ */
+const char *fileTypeName(uint16_t type) {
+
+   switch(type) {
+      case 0x00:
+         return "No file type";
+      case 0x01:
+         return "Relocatable file";
+      case 0x02:
+         return "Executable file";
+      case 0x03:
+         return "DYN (Shared object file)";
+      case 0x04:
+         return "Core file";
+      default:
+         return "Unsupported e_file type!";
+   }
 }
 
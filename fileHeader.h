@@ -19,20 +19,27 @@
 #include "customDataTypes.h"
 
 // Local Prototypes
-bool readFileHeader(union fileHeader_union *fileHeader, FILE *file);
-void fileHeader32to64(union fileHeader_union *fileHeader);
-void fileHeaderEndianSwap(union fileHeader_union *fileHeader);
-void printFileHeader(const union fileHeader_union *fileHeader);
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+bool hasElfMagic(const struct fileImage *image);
+void printFileHeader(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+const char *fileTypeName(uint16_t type);
 
 // Other Prototyptes
-bool checkSameEndian(const int programEndian);
-uint16_t endianSwap16Bit(const uint16_t input);
-uint32_t endianSwap32Bit(const uint32_t input);
-uint64_t endianSwap64Bit(const uint64_t input);
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
 
 // Defines
+#define EI_NIDENT 16
+
 #define BIT32 1
 #define BIT64 2
 #define ENDIAN_LITTLE 1
 #define ENDIAN_BIG 2
 
+#define SHN_XINDEX 0xffff
+
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file fileImage.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "fileImage.h"
+
+/**
+ * A function that opens a file and makes its whole content available
+ * through a fileImage.  Regular files are mapped read-only so every
+ * reader can work straight from the page cache.  Anything that can't
+ * be mapped (pipes, empty files, special files) is read into a heap
+ * buffer instead.
+ *
+ * INPUT:   name of the file to open
+ *          pointer to the fileImage to fill in
+ *
+ * OUTPUT:  true if the image is ready for use
+ *          false if the file couldn't be opened or read
+ */
+bool openFileImage(const char *fileName, struct fileImage *image) {
+
+   int fd;
+   bool loaded;
+   void *map;
+   struct stat info;
+
+   // Start from an empty image
+   image->data   = NULL;
+   image->size   = 0;
+   image->mapped = false;
+
+   // Attempt to open the file
+   if ( (fd = open(fileName, O_RDONLY)) == -1 ) {
+      return false;
+   }
+
+   // Map regular, non-empty files
+   if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+         image->data   = map;
+         image->size   = info.st_size;
+         image->mapped = true;
+         close(fd);
+         return true;
+      }
+   }
+
+   // Fall back to reading the file into memory
+   loaded = loadFileImage(fd, image);
+   close(fd);
+
+   return loaded;
+}
+
+/**
+ * A utility function that reads an entire file into a heap buffer
+ * using large pread calls.  Streams that can't seek are read with
+ * plain read calls instead.
+ *
+ * INPUT:   open file descriptor to read from
+ *          pointer to the fileImage to fill in
+ *
+ * OUTPUT:  true if the whole file was read
+ *          false otherwise
+ */
+bool loadFileImage(int fd, struct fileImage *image) {
+
+   ssize_t count;
+   bool seekable = true;
+
+   uint64_t used = 0;
+   uint64_t capacity = 0;
+
+   unsigned char *buffer = NULL;
+   unsigned char *grown;
+
+   while (true) {
+
+      // Make room for the next chunk
+      if (capacity - used < IMAGE_READ_CHUNK) {
+         capacity = (capacity == 0) ? IMAGE_READ_CHUNK : capacity * 2;
+         if ( (grown = realloc(buffer, capacity)) == NULL ) {
+            free(buffer);
+            return false;
+         }
+         buffer = grown;
+      }
+
+      // Read the next chunk
+      if (seekable) {
+         count = pread(fd, buffer + used, IMAGE_READ_CHUNK, used);
+         if (count == -1 && errno == ESPIPE) {
+            seekable = false;
+            continue;
+         }
+      } else {
+         count = read(fd, buffer + used, IMAGE_READ_CHUNK);
+      }
+
+      // Retry interrupted reads, give up on real errors
+      if (count == -1) {
+         if (errno == EINTR) {
+            continue;
+         }
+         free(buffer);
+         return false;
+      }
+
+      // Stop at end of file
+      if (count == 0) {
+         break;
+      }
+
+      used += count;
+   }
+
+   image->data   = buffer;
+   image->size   = used;
+   image->mapped = false;
+
+   return true;
+}
+
+/**
+ * A utility function that returns a pointer to a range of bytes in
+ * the image, making sure the whole range lies inside the file.
+ *
+ * INPUT:   pointer to the fileImage
+ *          offset of the first byte
+ *          number of bytes needed
+ *
+ * OUTPUT:  pointer to the first byte
+ *          NULL if the range runs past the end of the file
+ */
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size) {
+
+   // Check the range without overflowing
+   if (offset > image->size || size > image->size - offset) {
+      return NULL;
+   }
+
+   return image->data + offset;
+}
+
+/**
+ * A utility function that passes an madvise hint for a range of a
+ * mapped image, such as MADV_WILLNEED to read a range ahead or
+ * MADV_DONTNEED to drop a range that is no longer needed.  The range
+ * is widened to whole pages.  Heap images ignore the hint.
+ *
+ * INPUT:   pointer to the fileImage
+ *          offset of the first byte
+ *          number of bytes
+ *          madvise advice value
+ *
+ * OUTPUT:  none
+ */
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice) {
+
+   uint64_t page;
+   uint64_t start;
+   uint64_t end;
+
+   // Only mappings take hints, and only inside the file
+   if (!image->mapped || size == 0 || imageAt(image, offset, size) == NULL) {
+      return;
+   }
+
+   // Round the range out to whole pages
+   page  = sysconf(_SC_PAGESIZE);
+   start = offset & ~(page - 1);
+   end   = offset + size;
+
+   madvise((void *)(image->data + start), end - start, advice);
+}
+
+/**
+ * A utility function that releases the memory behind a fileImage.
+ *
+ * INPUT:   pointer to the fileImage to close
+ *
+ * OUTPUT:  none
+ */
+void closeFileImage(struct fileImage *image) {
+
+   if (image->mapped) {
+      munmap((void *)image->data, image->size);
+   } else {
+      free((void *)image->data);
+   }
+
+   image->data   = NULL;
+   image->size   = 0;
+   image->mapped = false;
+}
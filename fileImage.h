@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file fileImage.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+bool openFileImage(const char *fileName, struct fileImage *image);
+bool loadFileImage(int fd, struct fileImage *image);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice);
+void closeFileImage(struct fileImage *image);
+
+// Defines
+#define IMAGE_READ_CHUNK (1 << 20)
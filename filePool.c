@@ -0,0 +1,294 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file filePool.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "filePool.h"
+
+/**
+ * A function that processes several files on a pool of worker threads.
+ * Each worker buffers a file's output in memory, and the calling thread
+ * writes those buffers out in argument order, so the result matches a
+ * sequential run.  Like the sequential run, output stops after the first
+ * file that fails.  A -R scan instead keeps going past failures, skips
+ * files without the ELF magic bytes, and counts each file's outcome in
+ * the summary.  Each file's ELF header and section header table are
+ * read ahead by the prefetcher, and a worker starts on a file once
+ * those reads are done.  If no worker can be started the calling
+ * thread runs each job itself, and without memory for the jobs the
+ * files are processed in order with no pool at all.
+ *
+ * INPUT:   array of file names to process
+ *          number of file names
+ *          number of worker threads
+ *          pointer to the scan summary to fill in (NULL outside a scan)
+ *          boolean array for hex dump args one-hot-encoding
+ *          number of args
+ *          args (pointer to string arr)
+ *
+ * OUTPUT:  true if every file was processed
+ *          false if a file failed
+ */
+bool processFilesParallel(char *fileNames[], int fileCount, int workers, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]) {
+
+   int i;
+   int threadCount;
+   bool success = true;
+
+   pthread_t *threads;
+   struct fileJob *job;
+   struct filePool pool;
+   struct prefetcher prefetch;
+
+   // Never start more workers than files
+   threadCount = (workers < fileCount) ? workers : fileCount;
+
+   // Set up the shared pool state
+   if ( (pool.jobs = calloc(fileCount > 0 ? fileCount : 1, sizeof(struct fileJob))) == NULL ) {
+      return processFilesInOrder(fileNames, fileCount, summary, hexDumpArgs, argc, argv);
+   }
+   pool.jobCount    = fileCount;
+   pool.nextJob     = 0;
+   pool.emitted     = 0;
+   pool.window      = threadCount * POOL_WINDOW_PER_WORKER;
+   pool.stop        = false;
+   pool.scan        = (summary != NULL);
+   pool.prefetch    = &prefetch;
+   pool.hexDumpArgs = hexDumpArgs;
+   pool.argc        = argc;
+   pool.argv        = argv;
+
+   pthread_mutex_init(&pool.lock, NULL);
+   pthread_cond_init(&pool.jobDone, NULL);
+   pthread_cond_init(&pool.jobEmitted, NULL);
+
+   for (i=0; i < fileCount; i++) {
+      pool.jobs[i].fileName = fileNames[i];
+   }
+
+   // Start reading ahead, then start the workers
+   poolWorkerCount = threadCount;
+   startPrefetch(&prefetch, fileNames, fileCount);
+   if ( (threads = malloc(threadCount * sizeof(pthread_t))) == NULL ) {
+      threadCount = 0;
+   }
+   for (i=0; i < threadCount; i++) {
+      if (pthread_create(&threads[i], NULL, fileWorker, &pool) != 0) {
+         break;
+      }
+   }
+   threadCount = i;
+
+   // Write out each job's buffers in order as they finish
+   for (i=0; i < fileCount && (success || pool.scan); i++) {
+
+      job = &pool.jobs[i];
+
+      // With no workers, run the job here
+      if (threadCount == 0) {
+         pool.nextJob = i + 1;
+         runFileJob(&pool, job);
+         job->done = true;
+      }
+
+      // Wait for this job
+      pthread_mutex_lock(&pool.lock);
+      while (!job->done) {
+         pthread_cond_wait(&pool.jobDone, &pool.lock);
+      }
+      pthread_mutex_unlock(&pool.lock);
+
+      // Print the job's output and errors
+      fwrite(job->outText, 1, job->outSize, stdout);
+      fwrite(job->errText, 1, job->errSize, stderr);
+
+      free(job->outText);
+      free(job->errText);
+      job->outText = NULL;
+      job->errText = NULL;
+
+      // Count the outcome of a scanned file
+      if (pool.scan) {
+         if (!job->success) {
+            summary->failed[summary->failedCount++] = job->fileName;
+         } else if (job->status == SCAN_NOT_ELF) {
+            summary->skippedCount++;
+         } else {
+            summary->elfCount++;
+         }
+      }
+
+      // Let the workers move ahead, or stop them after a failure
+      pthread_mutex_lock(&pool.lock);
+      if (job->success || pool.scan) {
+         pool.emitted = i + 1;
+      }
+      if (!job->success) {
+         pool.stop = !pool.scan;
+         success = false;
+      }
+      pthread_cond_broadcast(&pool.jobEmitted);
+      pthread_mutex_unlock(&pool.lock);
+   }
+
+   // Wait for the workers to finish
+   for (i=0; i < threadCount; i++) {
+      pthread_join(threads[i], NULL);
+   }
+   stopPrefetch(&prefetch);
+   poolWorkerCount = 0;
+
+   // Free any output that was never printed
+   for (i=0; i < fileCount; i++) {
+      free(pool.jobs[i].outText);
+      free(pool.jobs[i].errText);
+   }
+
+   pthread_cond_destroy(&pool.jobEmitted);
+   pthread_cond_destroy(&pool.jobDone);
+   pthread_mutex_destroy(&pool.lock);
+
+   free(threads);
+   free(pool.jobs);
+
+   return success;
+}
+
+/**
+ * A function that processes files one after another on the calling
+ * thread, printing straight to stdout and stderr.  It is the fallback
+ * when there isn't memory for the pool's jobs, and counts a scan's
+ * files the same way the pool does.
+ *
+ * INPUT:   the same as processFilesParallel, without the worker count
+ *
+ * OUTPUT:  true if every file was processed
+ *          false if a file failed
+ */
+bool processFilesInOrder(char *fileNames[], int fileCount, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]) {
+
+   int i;
+   bool success = true;
+
+   for (i=0; i < fileCount; i++) {
+
+      // A scan skips files without the ELF magic bytes
+      if (summary != NULL && prefetchFile(fileNames[i]) == PREFETCH_NOT_ELF) {
+         summary->skippedCount++;
+         continue;
+      }
+
+      if (outputFormat == OUTPUT_TEXT) {
+         printf("\nFile: %s\n", fileNames[i]);
+      }
+
+      if (processFile(fileNames[i], hexDumpArgs, argc, argv, stdout, stderr)) {
+         if (summary != NULL) {
+            summary->elfCount++;
+         }
+      } else if (summary != NULL) {
+         summary->failed[summary->failedCount++] = fileNames[i];
+         success = false;
+      } else {
+         return false;
+      }
+   }
+
+   return success;
+}
+
+/**
+ * The thread function for each worker in the pool.  It claims the next
+ * job in argument order, processes it, and marks it as done.  Workers
+ * wait when they get too far ahead of the output already printed.
+ *
+ * INPUT:   pointer to the shared filePool
+ *
+ * OUTPUT:  NULL
+ */
+void *fileWorker(void *arg) {
+
+   struct filePool *pool = arg;
+   struct fileJob *job;
+
+   while (true) {
+
+      // Claim the next job, staying inside the output window
+      pthread_mutex_lock(&pool->lock);
+      while (!pool->stop && pool->nextJob < pool->jobCount &&
+             pool->nextJob >= pool->emitted + pool->window) {
+         pthread_cond_wait(&pool->jobEmitted, &pool->lock);
+      }
+      if (pool->stop || pool->nextJob >= pool->jobCount) {
+         pthread_mutex_unlock(&pool->lock);
+         break;
+      }
+      job = &pool->jobs[pool->nextJob++];
+      pthread_mutex_unlock(&pool->lock);
+
+      // Process the file into memory
+      runFileJob(pool, job);
+
+      // Tell the main thread the job is ready
+      pthread_mutex_lock(&pool->lock);
+      job->done = true;
+      pthread_cond_broadcast(&pool->jobDone);
+      pthread_mutex_unlock(&pool->lock);
+   }
+
+   return NULL;
+}
+
+/**
+ * A function that processes a single job's file with its output and
+ * errors captured in memory streams.
+ *
+ * INPUT:   pointer to the shared filePool
+ *          pointer to the job to run
+ *
+ * OUTPUT:  none
+ */
+void runFileJob(struct filePool *pool, struct fileJob *job) {
+
+   FILE *out;
+   FILE *err;
+
+   // Wait for the file's headers, then skip it if a scan finds it isn't ELF
+   if (waitPrefetch(pool->prefetch, job - pool->jobs) == PREFETCH_NOT_ELF && pool->scan) {
+      job->status  = SCAN_NOT_ELF;
+      job->success = true;
+      return;
+   }
+
+   out = open_memstream(&job->outText, &job->outSize);
+   err = open_memstream(&job->errText, &job->errSize);
+
+   // Without memory streams there is nowhere to print to
+   if (out == NULL || err == NULL) {
+      if (out != NULL) {
+         fclose(out);
+      }
+      if (err != NULL) {
+         fclose(err);
+      }
+      job->success = false;
+      return;
+   }
+
+   // Same per-file banner as a sequential run
+   if (outputFormat == OUTPUT_TEXT) {
+      fprintf(out, "\nFile: %s\n", job->fileName);
+   }
+
+   job->success = processFile(job->fileName, pool->hexDumpArgs, pool->argc, pool->argv, out, err);
+
+   fclose(out);
+   fclose(err);
+}
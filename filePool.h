@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file filePool.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern int outputFormat;
+extern int poolWorkerCount;
+
+// Local Prototypes
+bool processFilesParallel(char *fileNames[], int fileCount, int workers, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]);
+bool processFilesInOrder(char *fileNames[], int fileCount, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]);
+void *fileWorker(void *arg);
+void runFileJob(struct filePool *pool, struct fileJob *job);
+
+// Other Prototypes
+bool processFile(const char *fileName, bool *hexDumpArgs, int argc, char *argv[], FILE *out, FILE *err);
+void startPrefetch(struct prefetcher *prefetch, char *fileNames[], int fileCount);
+void stopPrefetch(struct prefetcher *prefetch);
+int waitPrefetch(struct prefetcher *prefetch, int index);
+int prefetchFile(const char *fileName);
+
+// Defines
+#define POOL_WINDOW_PER_WORKER 4
+
+#define SCAN_ELF     0
+#define SCAN_NOT_ELF 1
+
+#define PREFETCH_NOT_ELF 2
+
+#define OUTPUT_TEXT 0
@@ -13,167 +13,467 @@
 #include "hexDump.h"
 
 /**
- * A function that iterates over the sectionHeader LL, looking for a node 
- * based on the user-inputted section name.  If the node is found, it
- * updates the one-hot encoding array that corresponds to which nodes are
- * meant to be hex dumped.
+ * A function that looks up a section in the section table based on
+ * the user-inputted section name.  If the section is found, it updates
+ * the slice array that records which sections are meant to be hex
+ * dumped.  A name of the form name@offset+len picks a slice of the
+ * section; both numbers may be decimal or 0x hex, and +len may be left
+ * off to dump to the end of the section.
  *
- * INPUT:   pointer to the section LL
+ * INPUT:   pointer to the section table
  *          string of user-inputted name
- *          bool array of one-hot-encoding
+ *          array of hex dump slices, one per section
  *
- * OUTPUT:  true if node found
+ * OUTPUT:  true if section found
  *          false otherwise
  *
  * @todo: allow user to enter section index instead of name
  */
-bool findNode(struct sectionNode *startSecLL, const char *secName, bool *hexDumpNodes) {
+bool findNode(const struct sectionTable *secTable, const char *secName, struct hexDumpSlice *hexDumpSlices) {
 
-   bool foundNode = false;
-   struct sectionNode *node = startSecLL;
+   int index;
+   char *name;
+   const char *at;
 
-   // Iterate over the section LL
-   while (node != NULL && !foundNode) {
+   uint64_t start  = 0;
+   uint64_t length = HEX_DUMP_ALL;
 
-      // Check if node's name matches input
-      if (strcmp(secName, node->name) == 0) {
-         foundNode = true;
-      }
+   // Look the whole name up in the hash index
+   index = findSection(secTable, secName);
+
+   // Otherwise try it as name@offset+len
+   if (index == -1 && (at = strrchr(secName, '@')) != NULL && parseHexSlice(at + 1, &start, &length)) {
+      name  = strndup(secName, at - secName);
+      index = findSection(secTable, name);
+      free(name);
+   }
+
+   // Update the slice for this section
+   if (index != -1) {
+      hexDumpSlices[index].selected = true;
+      hexDumpSlices[index].start    = start;
+      hexDumpSlices[index].length   = length;
+   }
+
+   // Return whether or not section was found
+   return (index != -1);
+}
+
+/**
+ * A utility function that parses the offset+len part of a section
+ * slice.  The length is optional.
+ *
+ * INPUT:   string holding offset[+len]
+ *          pointer to store the offset
+ *          pointer to store the length
+ *
+ * OUTPUT:  true if the whole string parsed
+ *          false otherwise
+ */
+bool parseHexSlice(const char *text, uint64_t *start, uint64_t *length) {
+
+   const char *end;
+
+   // Parse the offset
+   if ( (end = parseSliceNumber(text, start)) == NULL ) {
+      return false;
+   }
+
+   // Parse the optional length
+   if (*end == '+' && (end = parseSliceNumber(end + 1, length)) == NULL) {
+      return false;
+   }
+
+   return (*end == '\0');
+}
+
+/**
+ * A utility function that parses one number of a slice, in hex after
+ * a 0x prefix and in decimal otherwise, so a leading 0 isn't octal.
+ *
+ * INPUT:   the text to parse
+ *          pointer to store the number
+ *
+ * OUTPUT:  pointer just past the number
+ *          NULL if there is no number or it doesn't fit in 64 bits
+ */
+const char *parseSliceNumber(const char *text, uint64_t *value) {
+
+   int base = 10;
+   char *end;
+
+   if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+      base  = 16;
+      text += 2;
+   }
+
+   // strtoull would also take a sign or spaces
+   if (!isxdigit((unsigned char)*text) || (base == 10 && !isdigit((unsigned char)*text))) {
+      return NULL;
+   }
 
-      // Increment node if wrong node
-      else {
-         node = node->next;
+   errno  = 0;
+   *value = strtoull(text, &end, base);
+   if (errno == ERANGE) {
+      return NULL;
+   }
+
+   return end;
+}
+
+/**
+ * A function that prints the hex dump of the chosen sections.  This
+ * function iterates over the section table and finds the sections to
+ * print, then prints each one's name and hex values.
+ *
+ * INPUT:   pointer to the section table
+ *          pointer to the image of the file to dump
+ *          array of hex dump slices, one per section
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printHexDump(const struct sectionTable *secTable, const struct fileImage *image, struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out) {
+
+   int iter;
+
+   // Iterate over the section table
+   for (iter=0; iter < secTable->count; iter++) {
+
+      // Dump sections associated with [-x] opt
+      if (hexDumpSlices[iter].selected) {
+         printHexSection(&secTable->sections[iter], &hexDumpSlices[iter], image, out);
       }
    }
+}
 
-   // Update one-hot encoding of hex dump nodes
-   if (foundNode) {
-      hexDumpNodes[node->index] = true;
+/**
+ * A function that prints the hex dump of one section's slice, with
+ * the section's name before it.
+ *
+ * INPUT:   pointer to the section
+ *          pointer to the section's slice
+ *          pointer to the image of the file to dump
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printHexSection(const struct sectionEntry *section, const struct hexDumpSlice *slice, const struct fileImage *image, struct outputBuffer *out) {
+
+   int status;
+   uint64_t start;
+   uint64_t length;
+
+   // Find the bytes to dump, or say why there are none
+   status = resolveHexSlice(section, slice, image, &start, &length);
+   if (status != HEX_SLICE_OK) {
+      printHexSliceError(section, status, start, out);
+      return;
    }
 
-   // Return whether or not node was found
-   return foundNode;
+   // Print section name
+   writeText(out, "\n");
+   writeText(out, "Hex dump of section '");
+   writeText(out, section->name);
+   writeText(out, "':\n");
+
+   // Print hex body
+   printHexBody(image, section->data.Struct.sh_offset + start, length, start, out);
 }
 
 /**
- * A function that prints the hex dump of a give node.  This function 
- * iterates of the LL and finds the node to print, then prints the 
- * name.  A second function is called to print the actual hex values.
+ * A utility function that says why a section's slice has nothing to
+ * dump.
  *
- * INPUT:   pointer to the section LL head
- *          pointer to the file to dump
- *          boolean array of the one-hot-encoding
+ * INPUT:   pointer to the section
+ *          HEX_SLICE_* status from resolving the slice
+ *          start of the slice (section relative)
+ *          output buffer to print to
  *
  * OUTPUT:  none
  */
-void printHexDump(struct sectionNode *startSecLL, FILE *file, bool *hexDumpNodes) {
+void printHexSliceError(const struct sectionEntry *section, int status, uint64_t start, struct outputBuffer *out) {
 
-   int size;
-   uint64_t addr;
-   struct sectionNode *node = startSecLL;
+   writeText(out, "Section '");
+   writeText(out, section->name);
 
-   // Iterate over the section LL
-   while (node != NULL) {
+   switch (status) {
+      case HEX_SLICE_EMPTY:
+         writeText(out, "' has no data to dump.\n");
+         break;
+      case HEX_SLICE_OFFSET:
+         writeText(out, "' has no data to dump at offset 0x");
+         writeHex(out, start, 1);
+         writeText(out, ".\n");
+         break;
+      default:
+         writeText(out, "' extends past the end of the file.\n");
+   }
+}
 
-      // Dump nodes associated with [-x] opt
-      if (hexDumpNodes[node->index]) {
+/**
+ * A utility function that works out which bytes of a section a hex
+ * dump slice covers.  The slice is stopped at the end of the section,
+ * and must lie inside the image.  Shared by the hex dump printer and
+ * the structured output serializer.
+ *
+ * INPUT:   pointer to the section
+ *          pointer to the section's slice
+ *          pointer to the image of the file
+ *          pointer to store the slice start in (section relative)
+ *          pointer to store the slice length in
+ *
+ * OUTPUT:  HEX_SLICE_OK if there are bytes to dump
+ *          HEX_SLICE_EMPTY if the section is empty or NOBITS
+ *          HEX_SLICE_OFFSET if the slice starts past the section's end
+ *          HEX_SLICE_TRUNCATED if the bytes run past the end of the file
+ */
+int resolveHexSlice(const struct sectionEntry *section, const struct hexDumpSlice *slice, const struct fileImage *image, uint64_t *start, uint64_t *length) {
 
-         // Get size of section
-         size = node->data.Struct.sh_size;
+   uint64_t size;
 
-         // Check for empty section
-         if (size == 0) {
-            printf("Section '%s' has no data to dump.\n", node->name); 
-            node = node->next;
-            continue;
-         }
+   // Get size of section
+   size    = section->data.Struct.sh_size;
+   *start  = slice->start;
+   *length = 0;
 
-         // Print section name
-         printf("\n");
-         printf("Hex dump of section '%s':\n", node->name);
+   // Check for empty section; NOBITS sections have no bytes in the file
+   if (size == 0 || section->data.Struct.sh_type == SHT_NOBITS) {
+      return HEX_SLICE_EMPTY;
+   }
 
-         // Jump to section in file
-         addr = node->data.Struct.sh_offset;
-         fseek(file, addr, SEEK_SET);
+   // Check the slice starts inside the section
+   if (*start >= size) {
+      return HEX_SLICE_OFFSET;
+   }
 
-         // Print hex body
-         printHexBody(size, file);
-      }
+   // Stop the slice at the end of the section
+   *length = slice->length;
+   if (*length > size - *start) {
+      *length = size - *start;
+   }
 
-      // Increment node
-      node = node->next;
+   // Make sure the slice is inside the image
+   if (imageAt(image, section->data.Struct.sh_offset + *start, *length) == NULL) {
+      return HEX_SLICE_TRUNCATED;
    }
+
+   return HEX_SLICE_OK;
 }
 
+/**
+ * Lookup tables for the hex dump formatter.  hexDigits maps a nibble
+ * to its hex digit, and hexPairs maps a whole byte to its two digits.
+ */
+#define HEX_ROW(h) h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" \
+                   h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+
+static const char hexDigits[] = "0123456789abcdef";
+
+static const char hexPairs[] =
+   HEX_ROW("0") HEX_ROW("1") HEX_ROW("2") HEX_ROW("3")
+   HEX_ROW("4") HEX_ROW("5") HEX_ROW("6") HEX_ROW("7")
+   HEX_ROW("8") HEX_ROW("9") HEX_ROW("a") HEX_ROW("b")
+   HEX_ROW("c") HEX_ROW("d") HEX_ROW("e") HEX_ROW("f");
+
 /**
  * A function called by printHexDump to iterate over a section
- * and print its content in hex format.
+ * and print its content in hex format.  The section is streamed in
+ * large chunks: the next chunk is prefetched while the current one
+ * is formatted, and each chunk is dropped from memory once printed,
+ * so dumping a multi-gigabyte section keeps memory use flat.  Lines
+ * are formatted straight into the output buffer.
  *
- * INPUT:   int size of the section
- *          pointer to location in file to print from
+ * INPUT:   pointer to the image of the file to dump
+ *          offset of the first byte to dump in the file
+ *          number of bytes to dump
+ *          address to print for the first byte
+ *          output buffer to print to
  *
  * OUTPUT:  none
  */
-void printHexBody(const int secSize, FILE *file) {
+void printHexBody(const struct fileImage *image, uint64_t offset, uint64_t size, uint64_t addr, struct outputBuffer *out) {
 
-   int i;
+   int lineSize;
+   uint64_t currByte;
+   uint64_t chunkStart;
+   uint64_t chunkEnd;
+   uint64_t nextSize;
 
-   int addr = 0;
-   int currByte = 0;
-   int bufferSize = 0;
+   const unsigned char *data;
 
-   unsigned char buffer[16];
+   // The dump reads front to back
+   imageAdvise(image, offset, size, MADV_SEQUENTIAL);
 
-   // Iterate over the the lines to print
-   while (currByte < secSize) {
-      
-      // Determine amount of bytes in next line
-      if ( (secSize - currByte) >= 16 ) {
-         bufferSize = 16;                    // full 16byte line to print
-      } else {
-         bufferSize = secSize - currByte;    // < 16bytes to print
-      }
+   // Iterate over the section a chunk at a time
+   for (chunkStart = 0; chunkStart < size; chunkStart = chunkEnd) {
 
-      // Scan bytes to buffer
-      for (i=0; i < bufferSize; i++) {
-         buffer[i] = fgetc(file);
-      }
+      chunkEnd = (size - chunkStart > HEX_CHUNK) ? chunkStart + HEX_CHUNK : size;
+      data     = imageAt(image, offset + chunkStart, chunkEnd - chunkStart);
+      currByte = chunkStart;
 
-      // Print and increment the address
-      printf("  0x%08x ", addr);
-      addr += 0x10;
+      // Start reading the next chunk in the background
+      nextSize = (size - chunkEnd > HEX_CHUNK) ? HEX_CHUNK : size - chunkEnd;
+      imageAdvise(image, offset + chunkEnd, nextSize, MADV_WILLNEED);
 
-      // Print the bytes in hex
-      for (i=0; i < bufferSize; i++) {
-         printf("%02x", buffer[i]);
-         // Print space between every 4bytes
-         if ( ((i+1) % 4) == 0 ) {
-            printf(" ");
+      // Iterate over the the lines in this chunk
+      while (currByte < chunkEnd) {
+
+         // Determine amount of bytes in next line
+         if ( (chunkEnd - currByte) >= 16 ) {
+            lineSize = 16;                            // full 16byte line to print
+         } else {
+            lineSize = chunkEnd - currByte;           // < 16bytes to print
          }
+
+         // Format the line and increment the address
+         out->cursor = formatHexLine(reserveOutput(out, HEX_LINE_MAX), addr, data, lineSize);
+         addr += 0x10;
+
+         // Update loop params
+         data     += lineSize;
+         currByte += lineSize;
       }
 
-      // Ensure ASCII Printout is in right place
-      for (i=bufferSize; i < 16; i++) {
-         printf("  ");
-         if ( ((i+1) % 4) == 0 ) {
-            printf(" ");
-         }
+      // Drop the printed chunk from memory
+      imageAdvise(image, offset + chunkStart, chunkEnd - chunkStart, MADV_DONTNEED);
+   }
+
+   // Finish with a blank line
+   writeChar(out, '\n');
+}
+
+/**
+ * A function that formats one line of a hex dump into a buffer.
+ * The line holds the address, up to 16 bytes in hex (grouped by
+ * 4 bytes), and the same bytes in ASCII.
+ *
+ * INPUT:   pointer to where the line should be written
+ *          address to print at the start of the line
+ *          pointer to the bytes for this line
+ *          number of bytes in this line (1 to 16)
+ *
+ * OUTPUT:  pointer just past the formatted line
+ */
+char *formatHexLine(char *out, uint64_t addr, const unsigned char *bytes, int count) {
+
+   int i;
+   int digits = 8;
+
+   // Addresses past 4GB get as many digits as they need
+   while (digits < 16 && (addr >> (4 * digits)) != 0) {
+      digits++;
+   }
+
+   // Print the address
+   memcpy(out, "  0x", 4);
+   for (i=0; i < digits; i++) {
+      out[4 + i] = hexDigits[(addr >> (4 * (digits - 1 - i))) & 0xf];
+   }
+   out[4 + digits] = ' ';
+   out += 5 + digits;
+
+   // Full lines take the vector path
+   if (count == 16) {
+      return formatHexLine16(out, bytes);
+   }
+
+   // Print the bytes in hex
+   for (i=0; i < count; i++) {
+      memcpy(out, &hexPairs[bytes[i] * 2], 2);
+      out += 2;
+      // Print space between every 4bytes
+      if ( ((i+1) % 4) == 0 ) {
+         *out++ = ' ';
       }
+   }
 
-      // Print the bytes in ASCII
-      for (i=0; i < bufferSize; i++) {
-         if (buffer[i] >= 0x20 && buffer[i] <= 0x7e) {   // Prints ASCII chars
-            printf("%c", buffer[i]);
-         } else {                                        // Prints . for non-ASCII
-            printf(".");
-         }
+   // Ensure ASCII Printout is in right place
+   for (i=count; i < 16; i++) {
+      *out++ = ' ';
+      *out++ = ' ';
+      if ( ((i+1) % 4) == 0 ) {
+         *out++ = ' ';
       }
-      printf("\n");
+   }
 
-      // Update loop param
-      currByte += bufferSize;
+   // Print the bytes in ASCII, with . for non-ASCII
+   for (i=0; i < count; i++) {
+      *out++ = (bytes[i] >= 0x20 && bytes[i] <= 0x7e) ? bytes[i] : '.';
    }
+   *out++ = '\n';
 
-   printf("\n");
+   return out;
 }
 
+/**
+ * A function that formats the hex and ASCII columns of a full
+ * 16 byte line.  With SSE2 both columns are converted 16 bytes
+ * at a time; otherwise the byte-pair table is used.
+ *
+ * INPUT:   pointer to where the columns should be written
+ *          pointer to the 16 bytes for this line
+ *
+ * OUTPUT:  pointer just past the formatted line
+ */
+char *formatHexLine16(char *out, const unsigned char *bytes) {
+
+   int i;
+
+#ifdef __SSE2__
+   char digits[32];
+
+   __m128i raw    = _mm_loadu_si128((const __m128i *)bytes);
+   __m128i nibble = _mm_set1_epi8(0x0f);
+
+   // Split each byte into its high and low nibble
+   __m128i high = _mm_and_si128(_mm_srli_epi16(raw, 4), nibble);
+   __m128i low  = _mm_and_si128(raw, nibble);
+
+   // Turn nibbles into '0'-'9' or 'a'-'f'
+   __m128i nine = _mm_set1_epi8(9);
+   __m128i zero = _mm_set1_epi8('0');
+   __m128i skip = _mm_set1_epi8('a' - '0' - 10);
+
+   high = _mm_add_epi8(_mm_add_epi8(high, zero), _mm_and_si128(_mm_cmpgt_epi8(high, nine), skip));
+   low  = _mm_add_epi8(_mm_add_epi8(low, zero),  _mm_and_si128(_mm_cmpgt_epi8(low, nine), skip));
+
+   // Interleave so every byte's two digits sit next to each other
+   _mm_storeu_si128((__m128i *)digits,        _mm_unpacklo_epi8(high, low));
+   _mm_storeu_si128((__m128i *)(digits + 16), _mm_unpackhi_epi8(high, low));
+
+   // Copy the digits out in 4 byte groups
+   for (i=0; i < 4; i++) {
+      memcpy(out, digits + 8 * i, 8);
+      out[8] = ' ';
+      out += 9;
+   }
+
+   // Keep printable bytes (0x20 to 0x7e), replace the rest with .
+   __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(raw, _mm_set1_epi8(0x1f)),
+                                     _mm_cmplt_epi8(raw, _mm_set1_epi8(0x7f)));
+   __m128i ascii     = _mm_or_si128(_mm_and_si128(printable, raw),
+                                    _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+   _mm_storeu_si128((__m128i *)out, ascii);
+   out += 16;
+#else
+   // Print the bytes in hex
+   for (i=0; i < 16; i++) {
+      memcpy(out, &hexPairs[bytes[i] * 2], 2);
+      out += 2;
+      // Print space between every 4bytes
+      if ( ((i+1) % 4) == 0 ) {
+         *out++ = ' ';
+      }
+   }
+
+   // Print the bytes in ASCII, with . for non-ASCII
+   for (i=0; i < 16; i++) {
+      *out++ = (bytes[i] >= 0x20 && bytes[i] <= 0x7e) ? bytes[i] : '.';
+   }
+#endif
+
+   *out++ = '\n';
+
+   return out;
+}
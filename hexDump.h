@@ -15,11 +15,45 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <sys/mman.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "customDataTypes.h"
 
 // Local Prototypes
-bool findNode(struct sectionNode *startSecLL, const char *secName, bool *hexDumpNodes);
-void printHexDump(struct sectionNode *startSecLL, FILE *file, bool *hexDumpNodes);
-void printHexBody(const int secSize, FILE *file);
+bool findNode(const struct sectionTable *secTable, const char *secName, struct hexDumpSlice *hexDumpSlices);
+bool parseHexSlice(const char *text, uint64_t *start, uint64_t *length);
+const char *parseSliceNumber(const char *text, uint64_t *value);
+void printHexDump(const struct sectionTable *secTable, const struct fileImage *image, struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+void printHexSection(const struct sectionEntry *section, const struct hexDumpSlice *slice, const struct fileImage *image, struct outputBuffer *out);
+void printHexSliceError(const struct sectionEntry *section, int status, uint64_t start, struct outputBuffer *out);
+int resolveHexSlice(const struct sectionEntry *section, const struct hexDumpSlice *slice, const struct fileImage *image, uint64_t *start, uint64_t *length);
+void printHexBody(const struct fileImage *image, uint64_t offset, uint64_t size, uint64_t addr, struct outputBuffer *out);
+char *formatHexLine(char *out, uint64_t addr, const unsigned char *bytes, int count);
+char *formatHexLine16(char *out, const unsigned char *bytes);
+
+// Other Prototypes
+int findSection(const struct sectionTable *secTable, const char *secName);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice);
+char *reserveOutput(struct outputBuffer *buffer, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
+
+// Defines
+#define HEX_LINE_MAX 74
+#define HEX_CHUNK (1 << 20)
+#define HEX_DUMP_ALL UINT64_MAX
+
+#define HEX_SLICE_OK        0
+#define HEX_SLICE_EMPTY     1
+#define HEX_SLICE_OFFSET    2
+#define HEX_SLICE_TRUNCATED 3
 
+#define SHT_NOBITS 8
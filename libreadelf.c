@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file libreadelf.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "libreadelfCore.h"
+
+/**
+ * A function that opens an ELF file for the library's callers, reading
+ * its ELF header and section table once.  Every other library call
+ * works from the handle, and nothing is printed or exits on error.
+ *
+ * INPUT:   name of the file
+ *          pointer to store the new handle
+ *
+ * OUTPUT:  READELF_OK with the handle stored
+ *          READELF_ERR_OPEN, READELF_ERR_NOT_ELF or READELF_ERR_SECTIONS
+ *          (READELF_ERR_ARGUMENT or READELF_ERR_MEMORY) on failure
+ */
+int readelfOpen(const char *fileName, struct readelfFile **file) {
+
+   struct readelfFile *opened;
+
+   if (fileName == NULL || file == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   *file = NULL;
+
+   if ( (opened = calloc(1, sizeof(struct readelfFile))) == NULL ) {
+      return READELF_ERR_MEMORY;
+   }
+
+   if (!openFileImage(fileName, &opened->image)) {
+      free(opened);
+      return READELF_ERR_OPEN;
+   }
+   if (!readFileHeader(&opened->fileHeader, &opened->image)) {
+      closeFileImage(&opened->image);
+      free(opened);
+      return READELF_ERR_NOT_ELF;
+   }
+   if (!readSectionHeaders(&opened->fileHeader, &opened->secTable, &opened->image)) {
+      freeSectionTable(&opened->secTable);
+      closeFileImage(&opened->image);
+      free(opened);
+      return READELF_ERR_SECTIONS;
+   }
+
+   *file = opened;
+
+   return READELF_OK;
+}
+
+/**
+ * A function that closes a handle from readelfOpen.  Names and data
+ * pointers handed out for the file are no longer valid afterwards.
+ *
+ * INPUT:   the handle (NULL is ignored)
+ *
+ * OUTPUT:  none
+ */
+void readelfClose(struct readelfFile *file) {
+
+   if (file == NULL) {
+      return;
+   }
+
+   freeSectionTable(&file->secTable);
+   closeFileImage(&file->image);
+   free(file);
+}
+
+/**
+ * A utility function that describes a status code, using the same
+ * wording as the command line's errors.
+ *
+ * INPUT:   a status code
+ *
+ * OUTPUT:  a description of it
+ */
+const char *readelfStatusText(int status) {
+
+   switch(status) {
+      case READELF_OK:
+         return "Success";
+      case READELF_END:
+         return "No more sections";
+      case READELF_ERR_ARGUMENT:
+         return "Invalid argument";
+      case READELF_ERR_OPEN:
+         return "No such file";
+      case READELF_ERR_NOT_ELF:
+         return "Not an ELF file - it has the wrong magic bytes at the start";
+      case READELF_ERR_SECTIONS:
+         return "The section header table is truncated or corrupt";
+      case READELF_ERR_NOT_FOUND:
+         return "No such section";
+      case READELF_ERR_RANGE:
+         return "The range runs outside the section or the file";
+      case READELF_ERR_MEMORY:
+         return "Out of memory";
+      default:
+         return "Unknown status";
+   }
+}
+
+/**
+ * A function that copies out the fields of a file's ELF header.
+ *
+ * INPUT:   the handle
+ *          pointer to the header to fill in
+ *
+ * OUTPUT:  READELF_OK, or READELF_ERR_ARGUMENT
+ */
+int readelfGetHeader(const struct readelfFile *file, struct readelfHeader *header) {
+
+   const struct fileHeader_struct64 *fields;
+
+   if (file == NULL || header == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   fields = &file->fileHeader.Struct;
+
+   header->elfClass            = file->fileHeader.arr[4];
+   header->elfData             = file->fileHeader.arr[5];
+   header->osAbi               = file->fileHeader.arr[7];
+   header->type                = fields->e_type;
+   header->machine             = fields->e_machine;
+   header->flags               = fields->e_flags;
+   header->entry               = fields->e_entry;
+   header->programHeaderOffset = fields->e_phoff;
+   header->sectionHeaderOffset = fields->e_shoff;
+   header->programHeaderCount  = fields->e_phnum;
+   header->sectionHeaderCount  = fields->e_shnum;
+   header->sectionNameIndex    = fields->e_shstrndx;
+
+   return READELF_OK;
+}
+
+/**
+ * A function that returns how many sections a file has.
+ *
+ * INPUT:   the handle
+ *
+ * OUTPUT:  the number of sections, or READELF_ERR_ARGUMENT
+ */
+int readelfSectionCount(const struct readelfFile *file) {
+
+   if (file == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+
+   return file->secTable.count;
+}
+
+/**
+ * A function that copies out one section header by index.
+ *
+ * INPUT:   the handle
+ *          index of the section
+ *          pointer to the section to fill in
+ *
+ * OUTPUT:  READELF_OK, READELF_ERR_NOT_FOUND or READELF_ERR_ARGUMENT
+ */
+int readelfGetSection(const struct readelfFile *file, int index, struct readelfSection *section) {
+
+   if (file == NULL || section == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   if (index < 0 || index >= file->secTable.count) {
+      return READELF_ERR_NOT_FOUND;
+   }
+
+   fillReadelfSection(&file->secTable.sections[index], section);
+
+   return READELF_OK;
+}
+
+/**
+ * A function that finds a section by name through the section table's
+ * hash index.
+ *
+ * INPUT:   the handle
+ *          name of the section
+ *          pointer to the section to fill in
+ *
+ * OUTPUT:  READELF_OK, READELF_ERR_NOT_FOUND or READELF_ERR_ARGUMENT
+ */
+int readelfFindSection(const struct readelfFile *file, const char *name, struct readelfSection *section) {
+
+   int index;
+
+   if (file == NULL || name == NULL || section == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   if ( (index = findSection(&file->secTable, name)) == -1 ) {
+      return READELF_ERR_NOT_FOUND;
+   }
+
+   fillReadelfSection(&file->secTable.sections[index], section);
+
+   return READELF_OK;
+}
+
+/**
+ * Functions that walk a file's sections in order:
+ *
+ *    readelfSectionBegin(file, &iterator);
+ *    while (readelfSectionNext(&iterator, &section) == READELF_OK) ...
+ *
+ * INPUT:   the handle and the iterator to set up, or
+ *          the iterator and the section to fill in
+ *
+ * OUTPUT:  READELF_OK, READELF_END after the last section,
+ *          or READELF_ERR_ARGUMENT
+ */
+void readelfSectionBegin(const struct readelfFile *file, struct readelfSectionIterator *iterator) {
+
+   if (iterator != NULL) {
+      iterator->file = file;
+      iterator->next = 0;
+   }
+}
+
+int readelfSectionNext(struct readelfSectionIterator *iterator, struct readelfSection *section) {
+
+   if (iterator == NULL || iterator->file == NULL || section == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   if (iterator->next >= iterator->file->secTable.count) {
+      return READELF_END;
+   }
+
+   fillReadelfSection(&iterator->file->secTable.sections[iterator->next++], section);
+
+   return READELF_OK;
+}
+
+/**
+ * A function that gives direct access to a range of a section's
+ * bytes, without copying.  The pointer stays valid until the file is
+ * closed.
+ *
+ * INPUT:   the handle
+ *          pointer to the section
+ *          offset into the section
+ *          number of bytes
+ *          pointer to store the address of the first byte
+ *
+ * OUTPUT:  READELF_OK, READELF_ERR_RANGE if the range runs outside the
+ *          section or the file, or READELF_ERR_ARGUMENT
+ */
+int readelfSectionData(const struct readelfFile *file, const struct readelfSection *section, uint64_t offset, uint64_t length, const unsigned char **data) {
+
+   const unsigned char *bytes;
+
+   if (file == NULL || section == NULL || data == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+
+   // NOBITS sections have no bytes in the file
+   if (offset > section->size || length > section->size - offset || section->type == SHT_NOBITS) {
+      return READELF_ERR_RANGE;
+   }
+   if ( (bytes = imageAt(&file->image, section->offset + offset, length)) == NULL ) {
+      return READELF_ERR_RANGE;
+   }
+
+   *data = bytes;
+
+   return READELF_OK;
+}
+
+/**
+ * Functions that print a file's ELF header, section headers, or a hex
+ * dump of one section (name@offset+len selects a slice), exactly as
+ * the -h, -t and -x options do.
+ *
+ * INPUT:   the handle
+ *          name of the section to dump (readelfPrintHexDump only)
+ *          stream to print to
+ *
+ * OUTPUT:  READELF_OK, READELF_ERR_NOT_FOUND, READELF_ERR_MEMORY
+ *          or READELF_ERR_ARGUMENT
+ */
+int readelfPrintHeader(const struct readelfFile *file, FILE *out) {
+
+   struct outputBuffer buffer;
+
+   if (file == NULL || out == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+
+   if (!openOutputBuffer(&buffer, out)) {
+      return READELF_ERR_MEMORY;
+   }
+   printFileHeader(&file->fileHeader, &file->secTable, &buffer);
+   closeOutputBuffer(&buffer);
+
+   return READELF_OK;
+}
+
+int readelfPrintSections(const struct readelfFile *file, FILE *out) {
+
+   struct outputBuffer buffer;
+
+   if (file == NULL || out == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+
+   if (!openOutputBuffer(&buffer, out)) {
+      return READELF_ERR_MEMORY;
+   }
+   printSectionInfo(&file->fileHeader, &file->secTable, &buffer);
+   printSectionHeaders(&file->fileHeader, &file->secTable, &file->image, &buffer);
+   closeOutputBuffer(&buffer);
+
+   return READELF_OK;
+}
+
+int readelfPrintHexDump(const struct readelfFile *file, const char *secName, FILE *out) {
+
+   struct outputBuffer buffer;
+   struct hexDumpSlice *hexDumpSlices;
+
+   if (file == NULL || secName == NULL || out == NULL) {
+      return READELF_ERR_ARGUMENT;
+   }
+   if ( (hexDumpSlices = calloc(file->secTable.count + 1, sizeof(struct hexDumpSlice))) == NULL ) {
+      return READELF_ERR_MEMORY;
+   }
+   if (!findNode(&file->secTable, secName, hexDumpSlices)) {
+      free(hexDumpSlices);
+      return READELF_ERR_NOT_FOUND;
+   }
+
+   if (!openOutputBuffer(&buffer, out)) {
+      free(hexDumpSlices);
+      return READELF_ERR_MEMORY;
+   }
+   printHexDump(&file->secTable, &file->image, hexDumpSlices, &buffer);
+   closeOutputBuffer(&buffer);
+   free(hexDumpSlices);
+
+   return READELF_OK;
+}
+
+/**
+ * A utility function that copies a section table entry into the
+ * library's public section struct.
+ *
+ * INPUT:   pointer to the section table entry
+ *          pointer to the section to fill in
+ *
+ * OUTPUT:  none
+ */
+void fillReadelfSection(const struct sectionEntry *entry, struct readelfSection *section) {
+
+   const struct sectionHeader_struct64 *fields = &entry->data.Struct;
+
+   section->index     = entry->index;
+   section->name      = entry->name;
+   section->type      = fields->sh_type;
+   section->flags     = fields->sh_flags;
+   section->address   = fields->sh_addr;
+   section->offset    = fields->sh_offset;
+   section->size      = fields->sh_size;
+   section->link      = fields->sh_link;
+   section->info      = fields->sh_info;
+   section->align     = fields->sh_addralign;
+   section->entrySize = fields->sh_entsize;
+}
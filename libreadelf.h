@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file libreadelf.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Public interface of libreadelf.  This is the only header programs
+// linking the library include, so unlike the others it is guarded and
+// doesn't pull in customDataTypes.h.
+#ifndef LIBREADELF_H
+#define LIBREADELF_H
+
+// Includes
+#include <stdio.h>
+#include <stdint.h>
+
+// Functions the shared library exports
+#define READELF_API __attribute__((visibility("default")))
+
+/** An open ELF file.  Its contents are private to the
+ *  library; it is made by readelfOpen and freed by
+ *  readelfClose.
+ */
+struct readelfFile;
+
+/** The fields of an ELF file header, widened to
+ *  64bit and in local endian.  The section fields are
+ *  raw: with extended numbering sectionHeaderCount is 0
+ *  and sectionNameIndex is 0xffff, and readelfSectionCount
+ *  gives the real count.
+ */
+struct readelfHeader
+{
+   int elfClass;
+   int elfData;
+   int osAbi;
+   uint16_t type;
+   uint16_t machine;
+   uint32_t flags;
+   uint64_t entry;
+   uint64_t programHeaderOffset;
+   uint64_t sectionHeaderOffset;
+   uint16_t programHeaderCount;
+   uint16_t sectionHeaderCount;
+   uint16_t sectionNameIndex;
+};
+
+/** One section header.  The name points into the
+ *  open file and stays valid until it is closed.
+ */
+struct readelfSection
+{
+   int index;
+   const char *name;
+   uint32_t type;
+   uint64_t flags;
+   uint64_t address;
+   uint64_t offset;
+   uint64_t size;
+   uint32_t link;
+   uint32_t info;
+   uint64_t align;
+   uint64_t entrySize;
+};
+
+/** Walks the sections of an open file in order.
+ *  Set up by readelfSectionBegin.
+ */
+struct readelfSectionIterator
+{
+   const struct readelfFile *file;
+   int next;
+};
+
+// Prototypes
+READELF_API int readelfOpen(const char *fileName, struct readelfFile **file);
+READELF_API void readelfClose(struct readelfFile *file);
+READELF_API const char *readelfStatusText(int status);
+
+READELF_API int readelfGetHeader(const struct readelfFile *file, struct readelfHeader *header);
+READELF_API int readelfSectionCount(const struct readelfFile *file);
+READELF_API int readelfGetSection(const struct readelfFile *file, int index, struct readelfSection *section);
+READELF_API int readelfFindSection(const struct readelfFile *file, const char *name, struct readelfSection *section);
+READELF_API void readelfSectionBegin(const struct readelfFile *file, struct readelfSectionIterator *iterator);
+READELF_API int readelfSectionNext(struct readelfSectionIterator *iterator, struct readelfSection *section);
+READELF_API int readelfSectionData(const struct readelfFile *file, const struct readelfSection *section, uint64_t offset, uint64_t length, const unsigned char **data);
+
+READELF_API int readelfPrintHeader(const struct readelfFile *file, FILE *out);
+READELF_API int readelfPrintSections(const struct readelfFile *file, FILE *out);
+READELF_API int readelfPrintHexDump(const struct readelfFile *file, const char *secName, FILE *out);
+
+// Defines
+#define READELF_OK             0
+#define READELF_END            1
+#define READELF_ERR_ARGUMENT  -1
+#define READELF_ERR_OPEN      -2
+#define READELF_ERR_NOT_ELF   -3
+#define READELF_ERR_SECTIONS  -4
+#define READELF_ERR_NOT_FOUND -5
+#define READELF_ERR_RANGE     -6
+#define READELF_ERR_MEMORY    -7
+
+#endif
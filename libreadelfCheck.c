@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file libreadelfCheck.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdint.h>
+
+#include "libreadelf.h"
+
+/**
+ * A check for the library's handle API, linked against libreadelf.a.
+ * It opens an ELF file, walks its sections, reads the .text data and
+ * makes sure a missing file fails cleanly.
+ *
+ * INPUT:   argument count
+ *          arguments, the ELF file to open
+ *
+ * OUTPUT:  0 if every call behaved, 1 otherwise
+ */
+int main(int argc, char *argv[]) {
+
+   int status;
+   int walked;
+   struct readelfFile *file;
+   struct readelfHeader header;
+   struct readelfSection section;
+   struct readelfSectionIterator iterator;
+   const unsigned char *data;
+
+   if (argc != 2) {
+      fprintf(stderr, "Usage: %s elf-file\n", argv[0]);
+      return 1;
+   }
+
+   // Open the file and read its header
+   if ( (status = readelfOpen(argv[1], &file)) != READELF_OK ) {
+      fprintf(stderr, "%s: %s\n", argv[1], readelfStatusText(status));
+      return 1;
+   }
+   if (readelfGetHeader(file, &header) != READELF_OK || header.elfClass == 0) {
+      fprintf(stderr, "%s: Cannot read the header\n", argv[1]);
+      readelfClose(file);
+      return 1;
+   }
+
+   // The iterator must visit every section once
+   walked = 0;
+   readelfSectionBegin(file, &iterator);
+   while (readelfSectionNext(&iterator, &section) == READELF_OK) {
+      walked++;
+   }
+   if (walked == 0 || walked != readelfSectionCount(file)) {
+      fprintf(stderr, "%s: Walked %d of %d sections\n", argv[1], walked, readelfSectionCount(file));
+      readelfClose(file);
+      return 1;
+   }
+
+   // Named sections can be found and read
+   if (readelfFindSection(file, ".text", &section) != READELF_OK ||
+       readelfSectionData(file, &section, 0, section.size, &data) != READELF_OK) {
+      fprintf(stderr, "%s: Cannot read .text\n", argv[1]);
+      readelfClose(file);
+      return 1;
+   }
+   readelfClose(file);
+
+   // A missing file reports an error instead of exiting
+   if (readelfOpen("/nonexistent/libreadelfCheck", &file) != READELF_ERR_OPEN) {
+      fprintf(stderr, "Opening a missing file didn't fail\n");
+      return 1;
+   }
+
+   return 0;
+}
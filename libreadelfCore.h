@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file libreadelfCore.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+#include "libreadelf.h"
+
+// Local Prototypes
+void fillReadelfSection(const struct sectionEntry *entry, struct readelfSection *section);
+
+// Other Prototypes
+bool openFileImage(const char *fileName, struct fileImage *image);
+void closeFileImage(struct fileImage *image);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+void printFileHeader(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+int findSection(const struct sectionTable *secTable, const char *secName);
+void printSectionInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+void printSectionHeaders(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+bool findNode(const struct sectionTable *secTable, const char *secName, struct hexDumpSlice *hexDumpSlices);
+void printHexDump(const struct sectionTable *secTable, const struct fileImage *image, struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+void freeSectionTable(struct sectionTable *secTable);
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out);
+void closeOutputBuffer(struct outputBuffer *buffer);
+
+// Defines
+#define SHT_NOBITS 8
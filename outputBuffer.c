@@ -0,0 +1,511 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file outputBuffer.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "outputBuffer.h"
+
+/**
+ * Lookup tables for the formatters.  digitPairs maps 0-99 to two
+ * decimal digits, so numbers are formatted two digits per division.
+ */
+#define DIGIT_ROW(d) d "0" d "1" d "2" d "3" d "4" d "5" d "6" d "7" d "8" d "9"
+
+static const char digitPairs[] =
+   DIGIT_ROW("0") DIGIT_ROW("1") DIGIT_ROW("2") DIGIT_ROW("3") DIGIT_ROW("4")
+   DIGIT_ROW("5") DIGIT_ROW("6") DIGIT_ROW("7") DIGIT_ROW("8") DIGIT_ROW("9");
+
+static const char hexDigits[] = "0123456789abcdef";
+
+/**
+ * A function that sets up an output buffer for a stream.  Writers
+ * format straight into the buffer, which goes to the stream with one
+ * fwrite whenever it fills, so no printf is involved.
+ *
+ * INPUT:   pointer to the buffer to set up
+ *          stream the buffer writes to, or NULL to only count
+ *
+ * OUTPUT:  true if the buffer was allocated
+ *          false otherwise
+ */
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out) {
+
+   buffer->data    = malloc(OUTPUT_BUFFER_SIZE);
+   buffer->cursor  = buffer->data;
+   buffer->end     = buffer->data + OUTPUT_BUFFER_SIZE;
+   buffer->out     = out;
+   buffer->written = 0;
+
+   return (buffer->data != NULL);
+}
+
+/**
+ * A function that writes out what is left in a buffer and frees it.
+ *
+ * INPUT:   pointer to the buffer
+ *
+ * OUTPUT:  none
+ */
+void closeOutputBuffer(struct outputBuffer *buffer) {
+
+   flushOutputBuffer(buffer);
+   free(buffer->data);
+
+   buffer->data   = NULL;
+   buffer->cursor = NULL;
+   buffer->end    = NULL;
+}
+
+/**
+ * A utility function that writes a buffer's content to its stream, if
+ * it has one, and empties it.
+ *
+ * INPUT:   pointer to the buffer
+ *
+ * OUTPUT:  none
+ */
+void flushOutputBuffer(struct outputBuffer *buffer) {
+
+   if (buffer->cursor > buffer->data) {
+      if (buffer->out != NULL) {
+         fwrite(buffer->data, 1, buffer->cursor - buffer->data, buffer->out);
+      }
+      buffer->written += buffer->cursor - buffer->data;
+      buffer->cursor   = buffer->data;
+   }
+}
+
+/**
+ * A utility function that makes room for up to OUTPUT_RESERVE_MAX
+ * bytes, flushing first if they don't fit.  The caller formats into
+ * the returned pointer and moves the cursor past what it wrote.
+ *
+ * INPUT:   pointer to the buffer
+ *          number of bytes needed
+ *
+ * OUTPUT:  pointer to write at
+ */
+char *reserveOutput(struct outputBuffer *buffer, size_t size) {
+
+   if ((size_t)(buffer->end - buffer->cursor) < size) {
+      flushOutputBuffer(buffer);
+   }
+
+   return buffer->cursor;
+}
+
+/**
+ * Functions that append raw bytes, a nul-terminated string or a
+ * single character.  Writes larger than the buffer go straight to the
+ * stream.
+ *
+ * INPUT:   pointer to the buffer
+ *          the bytes (and their count) or the string
+ *
+ * OUTPUT:  none
+ */
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size) {
+
+   if ((size_t)(buffer->end - buffer->cursor) < size) {
+      flushOutputBuffer(buffer);
+      if (size > OUTPUT_BUFFER_SIZE) {
+         if (buffer->out != NULL) {
+            fwrite(bytes, 1, size, buffer->out);
+         }
+         buffer->written += size;
+         return;
+      }
+   }
+
+   memcpy(buffer->cursor, bytes, size);
+   buffer->cursor += size;
+}
+
+void writeText(struct outputBuffer *buffer, const char *text) {
+   writeBytes(buffer, text, strlen(text));
+}
+
+void writeChar(struct outputBuffer *buffer, char ch) {
+
+   if (buffer->cursor == buffer->end) {
+      flushOutputBuffer(buffer);
+   }
+
+   *buffer->cursor++ = ch;
+}
+
+/**
+ * A function that formats an unsigned number in decimal, two digits at
+ * a time from the right.
+ *
+ * INPUT:   pointer to where the digits should be written
+ *          the number
+ *
+ * OUTPUT:  pointer just past the digits
+ */
+char *formatUnsigned(char *out, uint64_t value) {
+
+   int length;
+   char digits[20];
+   char *cursor = digits + sizeof(digits);
+
+   while (value >= 100) {
+      cursor -= 2;
+      memcpy(cursor, &digitPairs[(value % 100) * 2], 2);
+      value /= 100;
+   }
+   if (value >= 10) {
+      cursor -= 2;
+      memcpy(cursor, &digitPairs[value * 2], 2);
+   } else {
+      *--cursor = '0' + value;
+   }
+
+   length = digits + sizeof(digits) - cursor;
+   memcpy(out, cursor, length);
+
+   return out + length;
+}
+
+/**
+ * A function that formats a number in hex, zero-filled to at least the
+ * given number of digits, like printf's "%016lx".
+ *
+ * INPUT:   pointer to where the digits should be written
+ *          the number
+ *          minimum number of digits
+ *
+ * OUTPUT:  pointer just past the digits
+ */
+char *formatHex(char *out, uint64_t value, int digits) {
+
+   int iter;
+
+   while (digits < 16 && (value >> (4 * digits)) != 0) {
+      digits++;
+   }
+   for (iter=0; iter < digits; iter++) {
+      out[iter] = hexDigits[(value >> (4 * (digits - 1 - iter))) & 0xf];
+   }
+
+   return out + digits;
+}
+
+/**
+ * Functions that format a number or a string padded with spaces to a
+ * field width, for printers that build whole lines themselves.  A
+ * positive width right-justifies and a negative width left-justifies,
+ * as for the padded writers.
+ *
+ * INPUT:   pointer to where the field should be written
+ *          the number or string
+ *          field width, negative to left-justify
+ *
+ * OUTPUT:  pointer just past the field
+ */
+char *formatUnsignedPadded(char *out, uint64_t value, int width) {
+
+   char digits[24];
+
+   return formatPadded(out, digits, formatUnsigned(digits, value) - digits, width);
+}
+
+char *formatTextPadded(char *out, const char *text, int width) {
+   return formatPadded(out, text, strlen(text), width);
+}
+
+char *formatPadded(char *out, const char *text, size_t length, int width) {
+
+   size_t fill;
+
+   fill = ((size_t)abs(width) > length) ? abs(width) - length : 0;
+
+   if (width >= 0) {
+      memset(out, ' ', fill);
+      out += fill;
+   }
+
+   memcpy(out, text, length);
+   out += length;
+
+   if (width < 0) {
+      memset(out, ' ', fill);
+      out += fill;
+   }
+
+   return out;
+}
+
+/**
+ * Functions that append a number in decimal, or in hex with at least
+ * the given number of digits.
+ *
+ * INPUT:   pointer to the buffer
+ *          the number
+ *          minimum number of hex digits (writeHex only)
+ *
+ * OUTPUT:  none
+ */
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value) {
+   buffer->cursor = formatUnsigned(reserveOutput(buffer, 20), value);
+}
+
+void writeSigned(struct outputBuffer *buffer, int64_t value) {
+
+   char *cursor = reserveOutput(buffer, 21);
+
+   if (value < 0) {
+      *cursor++ = '-';
+      buffer->cursor = formatUnsigned(cursor, -(uint64_t)value);
+   } else {
+      buffer->cursor = formatUnsigned(cursor, value);
+   }
+}
+
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits) {
+   buffer->cursor = formatHex(reserveOutput(buffer, 16), value, digits);
+}
+
+/**
+ * Functions that append a number padded to a field width with spaces,
+ * like printf's "%10lu" or "%-16d".  A positive width right-justifies
+ * the number and a negative width left-justifies it.  Numbers longer
+ * than the field are not cut.
+ *
+ * INPUT:   pointer to the buffer
+ *          the number
+ *          field width, negative to left-justify
+ *
+ * OUTPUT:  none
+ */
+void writeUnsignedPadded(struct outputBuffer *buffer, uint64_t value, int width) {
+
+   char digits[24];
+
+   writePadded(buffer, digits, formatUnsigned(digits, value) - digits, width);
+}
+
+void writeSignedPadded(struct outputBuffer *buffer, int64_t value, int width) {
+
+   char digits[24];
+   char *end;
+
+   if (value < 0) {
+      digits[0] = '-';
+      end = formatUnsigned(digits + 1, -(uint64_t)value);
+   } else {
+      end = formatUnsigned(digits, value);
+   }
+
+   writePadded(buffer, digits, end - digits, width);
+}
+
+void writeHexPadded(struct outputBuffer *buffer, uint64_t value, int width) {
+
+   char digits[16];
+
+   writePadded(buffer, digits, formatHex(digits, value, 1) - digits, width);
+}
+
+/**
+ * A function that appends a string padded to a field width with
+ * spaces, like printf's "%-30s".  The width works as for the padded
+ * number writers.
+ *
+ * INPUT:   pointer to the buffer
+ *          the string
+ *          field width, negative to left-justify
+ *
+ * OUTPUT:  none
+ */
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width) {
+   writePadded(buffer, text, strlen(text), width);
+}
+
+/**
+ * A utility function that appends text of a known length with the
+ * spaces needed to fill its field.
+ *
+ * INPUT:   pointer to the buffer
+ *          the text
+ *          length of the text
+ *          field width, negative to left-justify
+ *
+ * OUTPUT:  none
+ */
+void writePadded(struct outputBuffer *buffer, const char *text, size_t length, int width) {
+
+   size_t run;
+   size_t fill;
+   char *cursor;
+
+   fill = ((size_t)abs(width) > length) ? abs(width) - length : 0;
+
+   if (width < 0) {
+      writeBytes(buffer, text, length);
+   }
+
+   // Spaces come in runs no longer than the largest reservation
+   while (fill > 0) {
+      run    = (fill > OUTPUT_RESERVE_MAX) ? OUTPUT_RESERVE_MAX : fill;
+      cursor = reserveOutput(buffer, run);
+      memset(cursor, ' ', run);
+      buffer->cursor = cursor + run;
+      fill -= run;
+   }
+
+   if (width >= 0) {
+      writeBytes(buffer, text, length);
+   }
+}
+
+/**
+ * A function that appends bytes as a run of hex digit pairs, for hex
+ * dumps in JSON.
+ *
+ * INPUT:   pointer to the buffer
+ *          the bytes
+ *          number of bytes
+ *
+ * OUTPUT:  none
+ */
+void writeHexBytes(struct outputBuffer *buffer, const unsigned char *bytes, size_t size) {
+
+   size_t iter;
+   size_t count;
+   char *cursor;
+
+   while (size > 0) {
+
+      count  = (size > OUTPUT_RESERVE_MAX / 2) ? OUTPUT_RESERVE_MAX / 2 : size;
+      cursor = reserveOutput(buffer, count * 2);
+
+      for (iter=0; iter < count; iter++) {
+         *cursor++ = hexDigits[bytes[iter] >> 4];
+         *cursor++ = hexDigits[bytes[iter] & 0xf];
+      }
+
+      buffer->cursor = cursor;
+      bytes += count;
+      size  -= count;
+   }
+}
+
+/**
+ * A function that appends a string as a quoted JSON string, escaping
+ * quotes, backslashes and control characters.  Valid UTF-8 sequences
+ * are copied as they are; any other byte of 0x80 or more is escaped as
+ * the code point of the same value, so the result is always valid JSON.
+ *
+ * INPUT:   pointer to the buffer
+ *          the string
+ *
+ * OUTPUT:  none
+ */
+void writeJsonString(struct outputBuffer *buffer, const char *text) {
+
+   int length;
+   const unsigned char *byte;
+   char escape[7] = "\\u00";
+
+   writeBytes(buffer, "\"", 1);
+
+   for (byte = (const unsigned char *)text; *byte != '\0'; byte++) {
+      if (*byte == '"' || *byte == '\\') {
+         escape[1] = *byte;
+         writeBytes(buffer, escape, 2);
+         escape[1] = 'u';
+      } else if (*byte < 0x20 || (*byte >= 0x80 && (length = utf8Length(byte)) == 0)) {
+         escape[4] = hexDigits[*byte >> 4];
+         escape[5] = hexDigits[*byte & 0xf];
+         writeBytes(buffer, escape, 6);
+      } else if (*byte >= 0x80) {
+         writeBytes(buffer, byte, length);
+         byte += length - 1;
+      } else {
+         writeBytes(buffer, byte, 1);
+      }
+   }
+
+   writeBytes(buffer, "\"", 1);
+}
+
+/**
+ * A utility function that measures the UTF-8 sequence starting at a
+ * byte of 0x80 or more.  Overlong forms, surrogates and code points
+ * past U+10FFFF are not valid.
+ *
+ * INPUT:   pointer to the first byte
+ *
+ * OUTPUT:  length of the sequence (2 to 4)
+ *          0 if it isn't a valid sequence
+ */
+int utf8Length(const unsigned char *bytes) {
+
+   int iter;
+   int length;
+   unsigned char low = 0x80;
+   unsigned char high = 0xbf;
+
+   // The lead byte gives the length, and limits the second byte
+   if (bytes[0] >= 0xc2 && bytes[0] <= 0xdf) {
+      length = 2;
+   } else if (bytes[0] >= 0xe0 && bytes[0] <= 0xef) {
+      length = 3;
+      low    = (bytes[0] == 0xe0) ? 0xa0 : 0x80;
+      high   = (bytes[0] == 0xed) ? 0x9f : 0xbf;
+   } else if (bytes[0] >= 0xf0 && bytes[0] <= 0xf4) {
+      length = 4;
+      low    = (bytes[0] == 0xf0) ? 0x90 : 0x80;
+      high   = (bytes[0] == 0xf4) ? 0x8f : 0xbf;
+   } else {
+      return 0;
+   }
+
+   if (bytes[1] < low || bytes[1] > high) {
+      return 0;
+   }
+   for (iter=2; iter < length; iter++) {
+      if (bytes[iter] < 0x80 || bytes[iter] > 0xbf) {
+         return 0;
+      }
+   }
+
+   return length;
+}
+
+/**
+ * Functions that append a number in little endian, for the binary
+ * output format.
+ *
+ * INPUT:   pointer to the buffer
+ *          the number
+ *
+ * OUTPUT:  none
+ */
+void writeLE16(struct outputBuffer *buffer, uint16_t value) {
+
+   unsigned char bytes[2] = { value, value >> 8 };
+
+   writeBytes(buffer, bytes, sizeof(bytes));
+}
+
+void writeLE32(struct outputBuffer *buffer, uint32_t value) {
+
+   unsigned char bytes[4] = { value, value >> 8, value >> 16, value >> 24 };
+
+   writeBytes(buffer, bytes, sizeof(bytes));
+}
+
+void writeLE64(struct outputBuffer *buffer, uint64_t value) {
+
+   writeLE32(buffer, (uint32_t)value);
+   writeLE32(buffer, (uint32_t)(value >> 32));
+}
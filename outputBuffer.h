@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file outputBuffer.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out);
+void closeOutputBuffer(struct outputBuffer *buffer);
+void flushOutputBuffer(struct outputBuffer *buffer);
+char *reserveOutput(struct outputBuffer *buffer, size_t size);
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width);
+void writePadded(struct outputBuffer *buffer, const char *text, size_t length, int width);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
+void writeUnsignedPadded(struct outputBuffer *buffer, uint64_t value, int width);
+void writeSignedPadded(struct outputBuffer *buffer, int64_t value, int width);
+void writeHexPadded(struct outputBuffer *buffer, uint64_t value, int width);
+void writeHexBytes(struct outputBuffer *buffer, const unsigned char *bytes, size_t size);
+void writeJsonString(struct outputBuffer *buffer, const char *text);
+int utf8Length(const unsigned char *bytes);
+void writeLE16(struct outputBuffer *buffer, uint16_t value);
+void writeLE32(struct outputBuffer *buffer, uint32_t value);
+void writeLE64(struct outputBuffer *buffer, uint64_t value);
+char *formatUnsigned(char *out, uint64_t value);
+char *formatHex(char *out, uint64_t value, int digits);
+char *formatUnsignedPadded(char *out, uint64_t value, int width);
+char *formatTextPadded(char *out, const char *text, int width);
+char *formatPadded(char *out, const char *text, size_t length, int width);
+
+// Defines
+#define OUTPUT_BUFFER_SIZE (1 << 18)
+#define OUTPUT_RESERVE_MAX 4096
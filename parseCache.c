@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file parseCache.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "parseCache.h"
+
+// Counters for the report, shared by every worker
+static struct cacheStats cacheStats;
+
+/**
+ * A function that loads a file's decoded ELF header and section table
+ * from the --cache directory, in place of readFileHeader and
+ * readSectionHeaders.  Entries are named by the file's device and
+ * inode and hold its size and modification time, so an entry is only
+ * used while the file is unchanged; a changed file counts as stale and
+ * its entry is replaced on the next store.  The entry is mapped and its
+ * section headers copied out; names and the name index are then rebuilt
+ * from the image, which costs no decoding.  A hit refreshes the entry's
+ * time so trimming drops the least recently used entries first.
+ *
+ * INPUT:   name of the file
+ *          pointer to the fileHeader to fill in
+ *          pointer to the section table to fill in
+ *          pointer to the image of the file
+ *
+ * OUTPUT:  true if the entry was loaded
+ *          false if there is no usable entry, or no memory to load it
+ */
+bool loadCacheEntry(const char *fileName, union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image) {
+
+   int fd;
+   uint32_t iter;
+   bool valid;
+   void *map;
+   char path[CACHE_PATH_MAX];
+   struct stat info;
+   struct stat entryInfo;
+
+   const struct cacheHeader *header;
+   const union sectionHeader_union *sections;
+
+   // Find the entry for the file as it is now
+   if (!cacheEntryPath(fileName, &info, path, sizeof(path)) || (fd = open(path, O_RDONLY)) == -1) {
+      __atomic_fetch_add(&cacheStats.misses, 1, __ATOMIC_RELAXED);
+      return false;
+   }
+
+   // Map it, if it's at least big enough for a header
+   map = MAP_FAILED;
+   if (fstat(fd, &entryInfo) == 0 && (uint64_t)entryInfo.st_size >= sizeof(struct cacheHeader)) {
+      map = mmap(NULL, entryInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   }
+   if (map == MAP_FAILED) {
+      close(fd);
+      __atomic_fetch_add(&cacheStats.misses, 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&cacheStats.stale, 1, __ATOMIC_RELAXED);
+      return false;
+   }
+
+   // The format, the key and the length must all match
+   header = map;
+   valid  = memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+            header->version     == CACHE_VERSION &&
+            header->headerSize  == sizeof(union fileHeader_union) &&
+            header->sectionSize == sizeof(union sectionHeader_union) &&
+            (uint64_t)entryInfo.st_size == sizeof(struct cacheHeader) + (uint64_t)header->sectionCount * header->sectionSize &&
+            header->device    == (uint64_t)info.st_dev &&
+            header->inode     == (uint64_t)info.st_ino &&
+            header->size      == (uint64_t)info.st_size &&
+            header->size      == image->size &&
+            header->mtimeSec  == info.st_mtim.tv_sec &&
+            header->mtimeNsec == info.st_mtim.tv_nsec;
+
+   if (!valid) {
+      munmap(map, entryInfo.st_size);
+      close(fd);
+      __atomic_fetch_add(&cacheStats.misses, 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&cacheStats.stale, 1, __ATOMIC_RELAXED);
+      return false;
+   }
+
+   // Copy the header and sections out of the entry
+   *fileHeader = header->fileHeader;
+
+   sections = (const union sectionHeader_union *)(header + 1);
+   secTable->sections    = calloc(header->sectionCount > 0 ? header->sectionCount : 1, sizeof(struct sectionEntry));
+   secTable->count       = 0;
+   secTable->nameIndex   = NULL;
+   secTable->bucketCount = 0;
+   if (secTable->sections == NULL) {
+      munmap(map, entryInfo.st_size);
+      close(fd);
+      __atomic_fetch_add(&cacheStats.misses, 1, __ATOMIC_RELAXED);
+      return false;
+   }
+   secTable->count = header->sectionCount;
+   for (iter=0; iter < header->sectionCount; iter++) {
+      secTable->sections[iter].index = iter;
+      memcpy(&secTable->sections[iter].data, &sections[iter], sizeof(union sectionHeader_union));
+   }
+
+   // Mark the entry as recently used
+   futimens(fd, NULL);
+
+   munmap(map, entryInfo.st_size);
+   close(fd);
+
+   // Point the names into the image and index them
+   if (secTable->count > 0) {
+      readSectionNames(fileHeader, secTable, image);
+      if (!buildSectionIndex(secTable)) {
+         freeSectionTable(secTable);
+         __atomic_fetch_add(&cacheStats.misses, 1, __ATOMIC_RELAXED);
+         return false;
+      }
+   }
+
+   __atomic_fetch_add(&cacheStats.hits, 1, __ATOMIC_RELAXED);
+
+   return true;
+}
+
+/**
+ * A function that writes a file's decoded ELF header and section table
+ * to the --cache directory.  The entry is written to a temporary file
+ * and renamed into place, so readers never see half an entry and
+ * parallel workers can store at the same time.  The directory is made
+ * if it doesn't exist yet.
+ *
+ * INPUT:   name of the file
+ *          pointer to the fileHeader
+ *          pointer to the section table
+ *
+ * OUTPUT:  none
+ */
+void storeCacheEntry(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable) {
+
+   int fd;
+   int iter;
+   bool written;
+   size_t size;
+   char path[CACHE_PATH_MAX];
+   char tempPath[CACHE_PATH_MAX + 64];
+   unsigned char *buffer;
+   struct stat info;
+
+   struct cacheHeader *header;
+   union sectionHeader_union *sections;
+
+   if (!cacheEntryPath(fileName, &info, path, sizeof(path))) {
+      return;
+   }
+
+   // Lay the entry out in memory
+   size   = sizeof(struct cacheHeader) + secTable->count * sizeof(union sectionHeader_union);
+   buffer = calloc(1, size);
+   header = (struct cacheHeader *)buffer;
+
+   memcpy(header->magic, CACHE_MAGIC, sizeof(header->magic));
+   header->version      = CACHE_VERSION;
+   header->sectionCount = secTable->count;
+   header->headerSize   = sizeof(union fileHeader_union);
+   header->sectionSize  = sizeof(union sectionHeader_union);
+   header->device       = info.st_dev;
+   header->inode        = info.st_ino;
+   header->size         = info.st_size;
+   header->mtimeSec     = info.st_mtim.tv_sec;
+   header->mtimeNsec    = info.st_mtim.tv_nsec;
+   header->fileHeader   = *fileHeader;
+
+   sections = (union sectionHeader_union *)(header + 1);
+   for (iter=0; iter < secTable->count; iter++) {
+      sections[iter] = secTable->sections[iter].data;
+   }
+
+   // Write a temporary file, making the directory on first use
+   snprintf(tempPath, sizeof(tempPath), "%s.%d.%lx.tmp", path, (int)getpid(), (unsigned long)pthread_self());
+   if ( (fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1 && mkdir(cacheDir, 0755) == 0 ) {
+      fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   }
+   if (fd == -1) {
+      free(buffer);
+      return;
+   }
+
+   written = (write(fd, buffer, size) == (ssize_t)size);
+   close(fd);
+   free(buffer);
+
+   // Move it into place
+   if (written && rename(tempPath, path) == 0) {
+      __atomic_fetch_add(&cacheStats.stored, 1, __ATOMIC_RELAXED);
+   } else {
+      unlink(tempPath);
+   }
+}
+
+/**
+ * A utility function that stats a file and builds the path of its
+ * cache entry from its device and inode.
+ *
+ * INPUT:   name of the file
+ *          pointer to store the file's stat
+ *          buffer for the entry's path
+ *          size of the buffer
+ *
+ * OUTPUT:  true if the path was built
+ *          false if the file can't be stat'ed
+ */
+bool cacheEntryPath(const char *fileName, struct stat *info, char *path, size_t pathSize) {
+
+   if (stat(fileName, info) != 0) {
+      return false;
+   }
+
+   snprintf(path, pathSize, "%s/%016lx-%016lx%s", cacheDir,
+         (unsigned long)info->st_dev, (unsigned long)info->st_ino, CACHE_SUFFIX);
+
+   return true;
+}
+
+/**
+ * A function that keeps the cache directory under its size limit.  If
+ * the entries add up to more than the limit, the least recently used
+ * are removed until they fit in 90% of it, leaving room for the next
+ * run.  Called once at the end of a run.
+ *
+ * INPUT:   none
+ *
+ * OUTPUT:  none
+ */
+void trimCache(void) {
+
+   int iter;
+   int count = 0;
+   int capacity = 0;
+   size_t length;
+   uint64_t total = 0;
+   char path[CACHE_PATH_MAX];
+
+   DIR *dir;
+   struct dirent *entry;
+   struct stat info;
+   struct cacheFile *files = NULL;
+
+   if ( (dir = opendir(cacheDir)) == NULL ) {
+      return;
+   }
+
+   // Gather every entry with its size and time
+   while ( (entry = readdir(dir)) != NULL ) {
+
+      length = strlen(entry->d_name);
+      if (length < strlen(CACHE_SUFFIX) || strcmp(entry->d_name + length - strlen(CACHE_SUFFIX), CACHE_SUFFIX) != 0) {
+         continue;
+      }
+
+      snprintf(path, sizeof(path), "%s/%s", cacheDir, entry->d_name);
+      if (stat(path, &info) != 0) {
+         continue;
+      }
+
+      if (count == capacity) {
+         capacity = (capacity == 0) ? 256 : capacity * 2;
+         files    = realloc(files, capacity * sizeof(struct cacheFile));
+      }
+      files[count].path  = strdup(path);
+      files[count].size  = info.st_size;
+      files[count].mtime = info.st_mtim.tv_sec;
+      total += info.st_size;
+      count++;
+   }
+   closedir(dir);
+
+   // Drop the oldest entries while over the limit
+   if (total > cacheLimit) {
+      qsort(files, count, sizeof(struct cacheFile), compareCacheFiles);
+      for (iter=0; iter < count && total > cacheLimit / 10 * 9; iter++) {
+         if (unlink(files[iter].path) == 0) {
+            total -= files[iter].size;
+            cacheStats.evicted++;
+         }
+      }
+   }
+
+   for (iter=0; iter < count; iter++) {
+      free(files[iter].path);
+   }
+   free(files);
+}
+
+/**
+ * A function that prints how the cache fared in this run.
+ *
+ * INPUT:   stream to print to
+ *
+ * OUTPUT:  none
+ */
+void printCacheReport(FILE *err) {
+
+   fprintf(err, "%s: Parse cache: %lu hits, %lu misses (%lu stale), %lu stored, %lu evicted\n", programName,
+         cacheStats.hits, cacheStats.misses, cacheStats.stale, cacheStats.stored, cacheStats.evicted);
+}
+
+/**
+ * A utility function for qsort that orders cache entries from least to
+ * most recently used.
+ *
+ * INPUT:   pointers to two cacheFile structs
+ *
+ * OUTPUT:  negative, zero or positive, as for qsort
+ */
+int compareCacheFiles(const void *a, const void *b) {
+
+   const struct cacheFile *left  = a;
+   const struct cacheFile *right = b;
+
+   return (left->mtime > right->mtime) - (left->mtime < right->mtime);
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file parseCache.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern char *programName;
+extern char *cacheDir;
+extern uint64_t cacheLimit;
+
+// Local Prototypes
+bool loadCacheEntry(const char *fileName, union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void storeCacheEntry(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+bool cacheEntryPath(const char *fileName, struct stat *info, char *path, size_t pathSize);
+void trimCache(void);
+void printCacheReport(FILE *err);
+int compareCacheFiles(const void *a, const void *b);
+
+// Other Prototypes
+void readSectionNames(const union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+bool buildSectionIndex(struct sectionTable *secTable);
+void freeSectionTable(struct sectionTable *secTable);
+
+// Defines
+#define CACHE_MAGIC   "RELFCACH"
+#define CACHE_VERSION 1
+#define CACHE_SUFFIX  ".rc"
+
+#define CACHE_PATH_MAX 4096
+#define CACHE_DEFAULT_LIMIT_MB 256
@@ -0,0 +1,572 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file prefetch.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "prefetch.h"
+
+/**
+ * A function that starts a readahead hint for the files of a
+ * multi-file run.  For each file the ELF header is read, then the
+ * section header table at e_shoff, ahead of the worker pool.  The
+ * bytes read are thrown away; the workers still map and parse each
+ * file themselves, and only find those pages already in the page
+ * cache.  The header's magic bytes also let a scan skip non-ELF files
+ * early.  The reads go through an io_uring driven by one thread; where
+ * io_uring is unavailable (or --no-uring is given) a group of threads
+ * makes blocking reads instead.  If no thread can be started, each
+ * worker reads its own file's header when it waits for it.
+ *
+ * INPUT:   pointer to the prefetcher to start
+ *          array of file names
+ *          number of file names
+ *
+ * OUTPUT:  none
+ */
+void startPrefetch(struct prefetcher *prefetch, char *fileNames[], int fileCount) {
+
+   int iter;
+
+   prefetch->fileNames   = fileNames;
+   prefetch->fileCount   = fileCount;
+   prefetch->states      = calloc(fileCount > 0 ? fileCount : 1, sizeof(int));
+   prefetch->nextFile    = 0;
+   prefetch->consumed    = 0;
+   prefetch->stop        = false;
+   prefetch->slots       = NULL;
+   prefetch->uring       = false;
+   prefetch->threadCount = 0;
+   prefetch->threads     = malloc(PREFETCH_THREADS * sizeof(pthread_t));
+
+   pthread_mutex_init(&prefetch->lock, NULL);
+   pthread_cond_init(&prefetch->ready, NULL);
+   pthread_cond_init(&prefetch->advanced, NULL);
+
+   if (prefetch->states == NULL || prefetch->threads == NULL) {
+      return;
+   }
+
+   // Prefer one thread driving an io_uring
+   if (uringOpt && (prefetch->slots = calloc(PREFETCH_DEPTH, sizeof(struct prefetchSlot))) != NULL &&
+       setupUring(&prefetch->ring, PREFETCH_DEPTH)) {
+      if (pthread_create(&prefetch->threads[0], NULL, uringPrefetchWorker, prefetch) == 0) {
+         prefetch->uring       = true;
+         prefetch->threadCount = 1;
+         return;
+      }
+      closeUring(&prefetch->ring);
+   }
+   free(prefetch->slots);
+   prefetch->slots = NULL;
+
+   // Otherwise, threads making blocking reads
+   for (iter=0; iter < PREFETCH_THREADS; iter++) {
+      if (pthread_create(&prefetch->threads[iter], NULL, threadPrefetchWorker, prefetch) != 0) {
+         break;
+      }
+   }
+   prefetch->threadCount = iter;
+}
+
+/**
+ * A function that stops the prefetcher, waiting for reads in flight,
+ * and frees it.
+ *
+ * INPUT:   pointer to the prefetcher
+ *
+ * OUTPUT:  none
+ */
+void stopPrefetch(struct prefetcher *prefetch) {
+
+   int iter;
+
+   pthread_mutex_lock(&prefetch->lock);
+   prefetch->stop = true;
+   pthread_cond_broadcast(&prefetch->advanced);
+   pthread_mutex_unlock(&prefetch->lock);
+
+   for (iter=0; iter < prefetch->threadCount; iter++) {
+      pthread_join(prefetch->threads[iter], NULL);
+   }
+
+   if (prefetch->uring) {
+      closeUring(&prefetch->ring);
+      for (iter=0; iter < PREFETCH_DEPTH; iter++) {
+         free(prefetch->slots[iter].table);
+      }
+   }
+
+   pthread_cond_destroy(&prefetch->advanced);
+   pthread_cond_destroy(&prefetch->ready);
+   pthread_mutex_destroy(&prefetch->lock);
+
+   free(prefetch->threads);
+   free(prefetch->slots);
+   free(prefetch->states);
+}
+
+/**
+ * A function that waits until a file's reads are done, letting the
+ * prefetcher move further ahead.  Called by a worker before it
+ * processes the file; without prefetch threads the worker makes the
+ * reads itself.
+ *
+ * INPUT:   pointer to the prefetcher
+ *          index of the file
+ *
+ * OUTPUT:  PREFETCH_READY if the file looked like an ELF file
+ *          PREFETCH_NOT_ELF if it didn't start with the magic bytes
+ *          PREFETCH_FAILED if it couldn't be read
+ */
+int waitPrefetch(struct prefetcher *prefetch, int index) {
+
+   int state;
+
+   // With no prefetch threads, read the header here
+   if (prefetch->threadCount == 0) {
+      return prefetchFile(prefetch->fileNames[index]);
+   }
+
+   pthread_mutex_lock(&prefetch->lock);
+
+   // The pool has reached this file
+   if (index + 1 > prefetch->consumed) {
+      prefetch->consumed = index + 1;
+      pthread_cond_broadcast(&prefetch->advanced);
+   }
+
+   while (prefetch->states[index] == PREFETCH_PENDING) {
+      pthread_cond_wait(&prefetch->ready, &prefetch->lock);
+   }
+   state = prefetch->states[index];
+
+   pthread_mutex_unlock(&prefetch->lock);
+
+   return state;
+}
+
+/**
+ * A utility function that hands out the next file to read, keeping
+ * within PREFETCH_AHEAD files of the pool.
+ *
+ * INPUT:   pointer to the prefetcher
+ *          whether to wait when the prefetcher is too far ahead
+ *
+ * OUTPUT:  index of the file to read
+ *          -1 if there is none, or none yet when not waiting
+ */
+int claimPrefetchFile(struct prefetcher *prefetch, bool wait) {
+
+   int index = -1;
+
+   pthread_mutex_lock(&prefetch->lock);
+
+   while (wait && !prefetch->stop && prefetch->nextFile < prefetch->fileCount &&
+          prefetch->nextFile >= prefetch->consumed + PREFETCH_AHEAD) {
+      pthread_cond_wait(&prefetch->advanced, &prefetch->lock);
+   }
+   if (!prefetch->stop && prefetch->nextFile < prefetch->fileCount &&
+       prefetch->nextFile < prefetch->consumed + PREFETCH_AHEAD) {
+      index = prefetch->nextFile++;
+   }
+
+   pthread_mutex_unlock(&prefetch->lock);
+
+   return index;
+}
+
+/**
+ * A utility function that records a file's state and wakes the workers
+ * waiting on it.
+ *
+ * INPUT:   pointer to the prefetcher
+ *          index of the file
+ *          the file's state
+ *
+ * OUTPUT:  none
+ */
+void finishPrefetch(struct prefetcher *prefetch, int index, int state) {
+
+   pthread_mutex_lock(&prefetch->lock);
+   prefetch->states[index] = state;
+   pthread_cond_broadcast(&prefetch->ready);
+   pthread_mutex_unlock(&prefetch->lock);
+}
+
+/**
+ * A utility function that checks the magic bytes of a header read
+ * ahead and finds where its section header table lies.
+ *
+ * INPUT:   the bytes read from the start of the file
+ *          number of bytes read
+ *          pointer to store the table's offset
+ *          pointer to store the table's length (0 if nothing to read)
+ *
+ * OUTPUT:  true if the bytes start with the ELF magic
+ *          false otherwise
+ */
+bool sectionTableRange(const unsigned char *header, int size, uint64_t *offset, uint64_t *length) {
+
+   unsigned char buffer[64] = {0};
+   union fileHeader_union fileHeader;
+
+   if (size < 4 || header[0] != 0x7f || header[1] != 'E' || header[2] != 'L' || header[3] != 'F') {
+      return false;
+   }
+
+   // Decode as much of the header as was read
+   memcpy(buffer, header, size);
+   selectElfDecoder(buffer[4], buffer[5])->decodeFileHeader(buffer, &fileHeader);
+
+   *offset = fileHeader.Struct.e_shoff;
+   *length = (uint64_t)fileHeader.Struct.e_shentsize * fileHeader.Struct.e_shnum;
+
+   // The header is only a hint; don't chase short or absurd tables
+   if (size < 52) {
+      *length = 0;
+   }
+   if (*length > PREFETCH_TABLE_MAX) {
+      *length = PREFETCH_TABLE_MAX;
+   }
+
+   return true;
+}
+
+/**
+ * The thread function for the fallback backend.  Each thread claims
+ * files and reads them ahead with blocking reads.
+ *
+ * INPUT:   pointer to the prefetcher
+ *
+ * OUTPUT:  NULL
+ */
+void *threadPrefetchWorker(void *arg) {
+
+   int index;
+   struct prefetcher *prefetch = arg;
+
+   while ( (index = claimPrefetchFile(prefetch, true)) != -1 ) {
+      finishPrefetch(prefetch, index, prefetchFile(prefetch->fileNames[index]));
+   }
+
+   return NULL;
+}
+
+/**
+ * A function that reads one file's header and section header table
+ * with blocking reads.
+ *
+ * INPUT:   name of the file
+ *
+ * OUTPUT:  the file's prefetch state
+ */
+int prefetchFile(const char *fileName) {
+
+   int fd;
+   ssize_t count;
+   uint64_t offset;
+   uint64_t length;
+   unsigned char header[64];
+   unsigned char *table;
+
+   if ( (fd = open(fileName, O_RDONLY | O_NOCTTY | O_NONBLOCK)) == -1 ) {
+      return PREFETCH_FAILED;
+   }
+
+   // Read the header, then the table it points to
+   if ( (count = pread(fd, header, sizeof(header), 0)) == -1 ) {
+      close(fd);
+      return PREFETCH_FAILED;
+   }
+   if (!sectionTableRange(header, count, &offset, &length)) {
+      close(fd);
+      return PREFETCH_NOT_ELF;
+   }
+   if (length > 0 && (table = malloc(length)) != NULL) {
+      count = pread(fd, table, length, offset);
+      free(table);
+   }
+
+   close(fd);
+
+   return PREFETCH_READY;
+}
+
+/**
+ * The thread function for the io_uring backend.  It keeps up to
+ * PREFETCH_DEPTH files in flight: each file's header read is queued as
+ * soon as the file is opened, and its section table read is queued as
+ * soon as the header completes, so parsing a header overlaps with
+ * every other read outstanding.  New submissions and the wait for
+ * completions go to the kernel in one call.
+ *
+ * INPUT:   pointer to the prefetcher
+ *
+ * OUTPUT:  NULL
+ */
+void *uringPrefetchWorker(void *arg) {
+
+   int fd;
+   int index;
+   int slotIndex;
+   int inFlight = 0;
+   long submitted;
+   unsigned int head;
+   unsigned int tail;
+
+   struct io_uring_cqe *cqe;
+   struct prefetchSlot *slot;
+   struct prefetcher *prefetch = arg;
+   struct uringQueue *ring = &prefetch->ring;
+
+   // Slots not in use hold an fd of -1
+   for (slotIndex=0; slotIndex < PREFETCH_DEPTH; slotIndex++) {
+      prefetch->slots[slotIndex].fd = -1;
+   }
+
+   while (true) {
+
+      // Fill free slots, only blocking when nothing is in flight
+      while (inFlight < PREFETCH_DEPTH && (index = claimPrefetchFile(prefetch, inFlight == 0)) != -1) {
+
+         if ( (fd = open(prefetch->fileNames[index], O_RDONLY | O_NOCTTY | O_NONBLOCK)) == -1 ) {
+            finishPrefetch(prefetch, index, PREFETCH_FAILED);
+            continue;
+         }
+
+         for (slotIndex=0; prefetch->slots[slotIndex].fd != -1; slotIndex++);
+         slot        = &prefetch->slots[slotIndex];
+         slot->job   = index;
+         slot->fd    = fd;
+         slot->stage = PREFETCH_HEADER;
+         slot->table = NULL;
+
+         queueSlotRead(prefetch, slotIndex, slot->header, sizeof(slot->header), 0);
+         inFlight++;
+      }
+
+      if (inFlight == 0) {
+         break;
+      }
+
+      // Submit what was queued and wait for at least one completion
+      if ( (submitted = syscall(__NR_io_uring_enter, ring->fd, ring->pending, 1, IORING_ENTER_GETEVENTS, NULL, 0)) >= 0 ) {
+         ring->pending -= submitted;
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+         break;
+      }
+
+      // Handle every completion that has arrived
+      head = *ring->cqHead;
+      tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+      while (head != tail) {
+         cqe = &ring->cqes[head & *ring->cqMask];
+         completeSlotRead(prefetch, cqe->user_data, cqe->res, &inFlight);
+         head++;
+      }
+      __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+   }
+
+   // If the ring failed, read what's left with blocking reads.  A slot's
+   // table may still be a read target, so it is freed with the ring
+   for (slotIndex=0; slotIndex < PREFETCH_DEPTH; slotIndex++) {
+      slot = &prefetch->slots[slotIndex];
+      if (slot->fd != -1) {
+         close(slot->fd);
+         slot->fd = -1;
+         finishPrefetch(prefetch, slot->job, prefetchFile(prefetch->fileNames[slot->job]));
+      }
+   }
+   while ( (index = claimPrefetchFile(prefetch, true)) != -1 ) {
+      finishPrefetch(prefetch, index, prefetchFile(prefetch->fileNames[index]));
+   }
+
+   return NULL;
+}
+
+/**
+ * A utility function that queues a read for a slot on the ring.  It
+ * is submitted with the next io_uring_enter call.
+ *
+ * INPUT:   pointer to the prefetcher
+ *          index of the slot, kept as the read's user data
+ *          buffer to read into
+ *          number of bytes to read
+ *          offset in the file
+ *
+ * OUTPUT:  none
+ */
+void queueSlotRead(struct prefetcher *prefetch, int slotIndex, void *buffer, uint64_t size, uint64_t offset) {
+
+   unsigned int tail;
+   unsigned int index;
+   struct io_uring_sqe *sqe;
+   struct uringQueue *ring = &prefetch->ring;
+   struct prefetchSlot *slot = &prefetch->slots[slotIndex];
+
+   slot->iov.iov_base = buffer;
+   slot->iov.iov_len  = size;
+
+   tail  = *ring->sqTail;
+   index = tail & *ring->sqMask;
+   sqe   = &ring->sqes[index];
+
+   memset(sqe, 0, sizeof(*sqe));
+   sqe->opcode    = IORING_OP_READV;
+   sqe->fd        = slot->fd;
+   sqe->addr      = (uint64_t)(uintptr_t)&slot->iov;
+   sqe->len       = 1;
+   sqe->off       = offset;
+   sqe->user_data = slotIndex;
+
+   ring->sqArray[index] = index;
+   __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+   ring->pending++;
+}
+
+/**
+ * A function that handles a completed read.  A header that completes
+ * queues the read of its section header table; a table that completes
+ * (or a header that needs no table) finishes the file.
+ *
+ * INPUT:   pointer to the prefetcher
+ *          index of the slot the read belongs to
+ *          result of the read (bytes read, or -errno)
+ *          pointer to the count of files in flight
+ *
+ * OUTPUT:  none
+ */
+void completeSlotRead(struct prefetcher *prefetch, int slotIndex, int result, int *inFlight) {
+
+   int state = PREFETCH_READY;
+   uint64_t offset;
+   uint64_t length;
+   struct prefetchSlot *slot = &prefetch->slots[slotIndex];
+
+   if (slot->stage == PREFETCH_HEADER) {
+
+      if (result < 0) {
+         state = PREFETCH_FAILED;
+      } else if (!sectionTableRange(slot->header, result, &offset, &length)) {
+         state = PREFETCH_NOT_ELF;
+      }
+
+      // Chain the section table read behind the header
+      else if (length > 0 && (slot->table = malloc(length)) != NULL) {
+         slot->stage = PREFETCH_TABLE;
+         queueSlotRead(prefetch, slotIndex, slot->table, length, offset);
+         return;
+      }
+   }
+
+   // The file is done
+   close(slot->fd);
+   free(slot->table);
+   slot->fd    = -1;
+   slot->table = NULL;
+   (*inFlight)--;
+
+   finishPrefetch(prefetch, slot->job, state);
+}
+
+/**
+ * A function that sets up an io_uring with raw system calls and maps
+ * its rings.
+ *
+ * INPUT:   pointer to the ring to set up
+ *          number of submission entries
+ *
+ * OUTPUT:  true if the ring is ready
+ *          false if io_uring is unavailable
+ */
+bool setupUring(struct uringQueue *ring, unsigned int entries) {
+
+   struct io_uring_params params;
+   unsigned char *sqRing;
+   unsigned char *cqRing;
+
+   memset(&params, 0, sizeof(params));
+   memset(ring, 0, sizeof(*ring));
+
+   if ( (ring->fd = syscall(__NR_io_uring_setup, entries, &params)) < 0 ) {
+      return false;
+   }
+
+   // Map the rings, which may share one mapping
+   ring->entries    = params.sq_entries;
+   ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+   ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+   if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      if (ring->cqRingSize > ring->sqRingSize) {
+         ring->sqRingSize = ring->cqRingSize;
+      }
+      ring->cqRingSize = ring->sqRingSize;
+   }
+
+   ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+   if (ring->sqRing == MAP_FAILED) {
+      close(ring->fd);
+      return false;
+   }
+
+   if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->cqRing = ring->sqRing;
+   } else {
+      ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+      if (ring->cqRing == MAP_FAILED) {
+         munmap(ring->sqRing, ring->sqRingSize);
+         close(ring->fd);
+         return false;
+      }
+   }
+
+   ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+   ring->sqes     = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+   if (ring->sqes == MAP_FAILED) {
+      if (ring->cqRing != ring->sqRing) {
+         munmap(ring->cqRing, ring->cqRingSize);
+      }
+      munmap(ring->sqRing, ring->sqRingSize);
+      close(ring->fd);
+      return false;
+   }
+
+   // Point into the shared rings
+   sqRing = ring->sqRing;
+   cqRing = ring->cqRing;
+
+   ring->sqHead  = (unsigned int *)(sqRing + params.sq_off.head);
+   ring->sqTail  = (unsigned int *)(sqRing + params.sq_off.tail);
+   ring->sqMask  = (unsigned int *)(sqRing + params.sq_off.ring_mask);
+   ring->sqArray = (unsigned int *)(sqRing + params.sq_off.array);
+   ring->cqHead  = (unsigned int *)(cqRing + params.cq_off.head);
+   ring->cqTail  = (unsigned int *)(cqRing + params.cq_off.tail);
+   ring->cqMask  = (unsigned int *)(cqRing + params.cq_off.ring_mask);
+   ring->cqes    = (struct io_uring_cqe *)(cqRing + params.cq_off.cqes);
+
+   return true;
+}
+
+/**
+ * A utility function that unmaps an io_uring's rings and closes it.
+ *
+ * INPUT:   pointer to the ring
+ *
+ * OUTPUT:  none
+ */
+void closeUring(struct uringQueue *ring) {
+
+   munmap(ring->sqes, ring->sqesSize);
+   if (ring->cqRing != ring->sqRing) {
+      munmap(ring->cqRing, ring->cqRingSize);
+   }
+   munmap(ring->sqRing, ring->sqRingSize);
+   close(ring->fd);
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file prefetch.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern bool uringOpt;
+
+// Local Prototypes
+void startPrefetch(struct prefetcher *prefetch, char *fileNames[], int fileCount);
+void stopPrefetch(struct prefetcher *prefetch);
+int waitPrefetch(struct prefetcher *prefetch, int index);
+int claimPrefetchFile(struct prefetcher *prefetch, bool wait);
+void finishPrefetch(struct prefetcher *prefetch, int index, int state);
+bool sectionTableRange(const unsigned char *header, int size, uint64_t *offset, uint64_t *length);
+void *threadPrefetchWorker(void *arg);
+int prefetchFile(const char *fileName);
+void *uringPrefetchWorker(void *arg);
+void queueSlotRead(struct prefetcher *prefetch, int slotIndex, void *buffer, uint64_t size, uint64_t offset);
+void completeSlotRead(struct prefetcher *prefetch, int slotIndex, int result, int *inFlight);
+bool setupUring(struct uringQueue *ring, unsigned int entries);
+void closeUring(struct uringQueue *ring);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+
+// Defines
+#define PREFETCH_PENDING 0
+#define PREFETCH_READY   1
+#define PREFETCH_NOT_ELF 2
+#define PREFETCH_FAILED  3
+
+#define PREFETCH_HEADER 0
+#define PREFETCH_TABLE  1
+
+#define PREFETCH_DEPTH   64
+#define PREFETCH_AHEAD   256
+#define PREFETCH_THREADS 16
+#define PREFETCH_TABLE_MAX (16 * 1024 * 1024)
@@ -0,0 +1,466 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file programHeaders.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "programHeaders.h"
+
+/**
+ * A function that reads the program header table of a given file into
+ * one contiguous table.  The whole table is decoded in one call by the
+ * decoder for the file's class and endianness.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the segment table to fill in
+ *          pointer to the image of the file
+ *
+ * OUTPUT:  true if the program headers were read
+ *          false if the table is truncated or corrupt
+ */
+bool readProgramHeaders(const union fileHeader_union *fileHeader, struct segmentTable *segTable, const struct fileImage *image) {
+
+   int headerSize;
+   int headerCount;
+
+   const unsigned char *table;
+   const struct elfDecoder *decoder;
+
+   // Start from an empty table
+   segTable->segments = NULL;
+   segTable->count    = 0;
+
+   // Update segment variables
+   headerSize  = fileHeader->Struct.e_phentsize;
+   headerCount = fileHeader->Struct.e_phnum;
+
+   // Files without program headers have an empty table
+   if (headerCount == 0) {
+      return true;
+   }
+
+   // Pick the decoder once for the whole table
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+
+   // Headers must be at least as large as the ELF class says
+   if (headerSize < decoder->programHeaderSize) {
+      return false;
+   }
+
+   // Locate the program header table in the image
+   table = imageAt(image, fileHeader->Struct.e_phoff, (uint64_t)headerSize * headerCount);
+   if (table == NULL) {
+      return false;
+   }
+
+   // Allocate memory for every segment at once
+   segTable->segments = calloc(headerCount, sizeof(union programHeader_union));
+   segTable->count    = headerCount;
+
+   // Decode the table into 64bit, local endian format
+   decoder->decodeProgramHeaders(table, headerCount, headerSize, segTable->segments);
+
+   return true;
+}
+
+/**
+ * A function that prints general program header data before printing
+ * the actual program headers.  This is only done if the [-h] opt is not
+ * called, since that prints the same data.
+ *
+ * INPUT:   pointer to the fileHeader
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printSegmentInfo(const union fileHeader_union *fileHeader, struct outputBuffer *out) {
+
+   // Nothing else is printed without program headers
+   if (fileHeader->Struct.e_phnum == 0) {
+      return;
+   }
+
+   writeText(out, "\n");
+   writeText(out, "Elf file type is ");
+   writeText(out, fileTypeName(fileHeader->Struct.e_type));
+   writeText(out, "\nEntry point 0x");
+   writeHex(out, fileHeader->Struct.e_entry, 1);
+   writeText(out, "\nThere are ");
+   writeUnsigned(out, fileHeader->Struct.e_phnum);
+   writeText(out, " program headers, starting at offset ");
+   writeSigned(out, fileHeader->Struct.e_phoff);
+   writeChar(out, '\n');
+}
+
+/**
+ * A function that iterates over the segment table, printing each
+ * program header as it goes.  The interpreter named by a PT_INTERP
+ * segment is printed below it.
+ *
+ * INPUT:   pointer to the segment table
+ *          pointer to the image of the file
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printProgramHeaders(const struct segmentTable *segTable, const struct fileImage *image, struct outputBuffer *out) {
+
+   int iter;
+   const char *interp;
+   const struct programHeader_struct64 *progHeader;
+
+   // Check for an empty table
+   if (segTable->count == 0) {
+      writeText(out, "\n");
+      writeText(out, "There are no program headers in this file.\n");
+      return;
+   }
+
+   // Print formatting info
+   writeText(out, "\n");
+   writeText(out, "Program Headers:\n");
+   writeText(out, "  Type           Offset             VirtAddr           PhysAddr\n");
+   writeText(out, "                 FileSiz            MemSiz              Flags  Align\n");
+
+   // Iterate over each segment
+   for (iter=0; iter < segTable->count; iter++) {
+
+      progHeader = &segTable->segments[iter].Struct;
+
+      // === LINE ONE ===
+      writeText(out, "  ");
+      writeTextPadded(out, segmentTypeName(progHeader->p_type), -14);
+      writeText(out, " 0x");
+      writeHex(out, progHeader->p_offset, 16);
+      writeText(out, " 0x");
+      writeHex(out, progHeader->p_vaddr, 16);
+      writeText(out, " 0x");
+      writeHex(out, progHeader->p_paddr, 16);
+      writeChar(out, '\n');
+
+      // === LINE TWO ===
+      writeText(out, "                 0x");
+      writeHex(out, progHeader->p_filesz, 16);
+      writeText(out, " 0x");
+      writeHex(out, progHeader->p_memsz, 16);
+      writeText(out, "  ");
+      writeChar(out, (progHeader->p_flags & PF_R) ? 'R' : ' ');
+      writeChar(out, (progHeader->p_flags & PF_W) ? 'W' : ' ');
+      writeChar(out, (progHeader->p_flags & PF_X) ? 'E' : ' ');
+      writeText(out, "    0x");
+      writeHex(out, progHeader->p_align, 1);
+      writeChar(out, '\n');
+
+      // Print the requested interpreter
+      if (progHeader->p_type == PT_INTERP) {
+         interp = (const char *)imageAt(image, progHeader->p_offset, progHeader->p_filesz);
+         if (interp != NULL) {
+            writeText(out, "      [Requesting program interpreter: ");
+            writeBytes(out, interp, strnlen(interp, progHeader->p_filesz));
+            writeText(out, "]\n");
+         }
+      }
+   }
+}
+
+/**
+ * A function that prints which sections each segment holds.  Rather
+ * than testing every section against every segment, the sections are
+ * sorted once by file offset (and by address for SHT_NOBITS sections),
+ * and each segment binary searches for the first section at its start
+ * and sweeps forward to its end.  Only those candidates are checked in
+ * full, so the work grows with the number of matches instead of
+ * sections times segments.
+ *
+ * INPUT:   pointer to the segment table
+ *          pointer to the section table
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printSegmentMapping(const struct segmentTable *segTable, const struct sectionTable *secTable, struct outputBuffer *out) {
+
+   int iter;
+   int pos;
+   int matchCount;
+
+   int offsetCount = 0;
+   int addrCount = 0;
+   int otherCount = 0;
+
+   uint64_t end;
+
+   struct sectionKey *byOffset;
+   struct sectionKey *byAddr;
+   int *others;
+   int *matches;
+
+   const union sectionHeader_union *secHeader;
+   const union programHeader_union *progHeader;
+
+   // Nothing to map without program headers
+   if (segTable->count == 0) {
+      return;
+   }
+
+   byOffset = malloc((secTable->count + 1) * sizeof(struct sectionKey));
+   byAddr   = malloc((secTable->count + 1) * sizeof(struct sectionKey));
+   others   = malloc((secTable->count + 1) * sizeof(int));
+   matches  = malloc((secTable->count + 1) * sizeof(int));
+
+   // Split the sections (skipping the null section) by how they are placed
+   for (iter=1; iter < secTable->count; iter++) {
+
+      secHeader = &secTable->sections[iter].data;
+
+      if (secHeader->Struct.sh_type != SHT_NOBITS) {
+         byOffset[offsetCount].key   = secHeader->Struct.sh_offset;
+         byOffset[offsetCount].index = iter;
+         offsetCount++;
+      } else if (secHeader->Struct.sh_flags & SHF_ALLOC) {
+         byAddr[addrCount].key   = secHeader->Struct.sh_addr;
+         byAddr[addrCount].index = iter;
+         addrCount++;
+      } else {
+         others[otherCount++] = iter;
+      }
+   }
+
+   // Sort each group once
+   qsort(byOffset, offsetCount, sizeof(struct sectionKey), compareSectionKeys);
+   qsort(byAddr, addrCount, sizeof(struct sectionKey), compareSectionKeys);
+
+   // Print formatting info
+   writeText(out, "\n");
+   writeText(out, " Section to Segment mapping:\n");
+   writeText(out, "  Segment Sections...\n");
+
+   // Iterate over each segment
+   for (iter=0; iter < segTable->count; iter++) {
+
+      progHeader = &segTable->segments[iter];
+      matchCount = 0;
+
+      // Sweep the sections whose file offset starts inside the segment
+      end = progHeader->Struct.p_offset + progHeader->Struct.p_filesz;
+      if (end < progHeader->Struct.p_offset) {
+         end = UINT64_MAX;
+      }
+      pos = lowerBoundKey(byOffset, offsetCount, progHeader->Struct.p_offset);
+      for (; pos < offsetCount && byOffset[pos].key <= end; pos++) {
+         if (sectionInSegment(&secTable->sections[byOffset[pos].index].data, progHeader)) {
+            matches[matchCount++] = byOffset[pos].index;
+         }
+      }
+
+      // Sweep the SHT_NOBITS sections whose address starts inside the segment
+      end = progHeader->Struct.p_vaddr + progHeader->Struct.p_memsz;
+      if (end < progHeader->Struct.p_vaddr) {
+         end = UINT64_MAX;
+      }
+      pos = lowerBoundKey(byAddr, addrCount, progHeader->Struct.p_vaddr);
+      for (; pos < addrCount && byAddr[pos].key <= end; pos++) {
+         if (sectionInSegment(&secTable->sections[byAddr[pos].index].data, progHeader)) {
+            matches[matchCount++] = byAddr[pos].index;
+         }
+      }
+
+      // Check the few sections that have neither
+      for (pos=0; pos < otherCount; pos++) {
+         if (sectionInSegment(&secTable->sections[others[pos]].data, progHeader)) {
+            matches[matchCount++] = others[pos];
+         }
+      }
+
+      // Print the matches in section order
+      qsort(matches, matchCount, sizeof(int), compareInts);
+
+      writeText(out, (iter < 10) ? "   0" : "   ");
+      writeUnsigned(out, iter);
+      writeText(out, "     ");
+      for (pos=0; pos < matchCount; pos++) {
+         writeText(out, secTable->sections[matches[pos]].name);
+         writeChar(out, ' ');
+      }
+      writeChar(out, '\n');
+   }
+
+   free(matches);
+   free(others);
+   free(byAddr);
+   free(byOffset);
+}
+
+/**
+ * A utility function that checks whether a section lies inside a
+ * segment, using the same rules as binutils' readelf: TLS sections
+ * only go in TLS, RELRO and LOAD segments, loadable segments only hold
+ * SHF_ALLOC sections, the section's file bytes and addresses must fit
+ * in the segment, .tbss only shows up in the TLS segment, and empty
+ * sections don't count at the edges of DYNAMIC and NOTE segments.
+ *
+ * INPUT:   pointer to the section header
+ *          pointer to the program header
+ *
+ * OUTPUT:  true if the section is in the segment
+ *          false otherwise
+ */
+bool sectionInSegment(const union sectionHeader_union *secHeader, const union programHeader_union *progHeader) {
+
+   uint64_t size;
+
+   const struct sectionHeader_struct64 *sec = &secHeader->Struct;
+   const struct programHeader_struct64 *seg = &progHeader->Struct;
+
+   bool isTls    = (sec->sh_flags & SHF_TLS) != 0;
+   bool isAlloc  = (sec->sh_flags & SHF_ALLOC) != 0;
+   bool isNobits = (sec->sh_type == SHT_NOBITS);
+
+   // .tbss takes no room outside the TLS segment
+   if (isTls && isNobits && seg->p_type != PT_TLS) {
+      return false;
+   }
+   size = sec->sh_size;
+
+   // TLS sections only go in TLS, RELRO and LOAD segments
+   if (isTls && seg->p_type != PT_TLS && seg->p_type != PT_GNU_RELRO && seg->p_type != PT_LOAD) {
+      return false;
+   }
+
+   // Other sections never go in TLS or PHDR segments
+   if (!isTls && (seg->p_type == PT_TLS || seg->p_type == PT_PHDR)) {
+      return false;
+   }
+
+   // Loadable segments only hold SHF_ALLOC sections
+   if (!isAlloc && (seg->p_type == PT_LOAD || seg->p_type == PT_DYNAMIC ||
+                    seg->p_type == PT_GNU_EH_FRAME || seg->p_type == PT_GNU_STACK ||
+                    seg->p_type == PT_GNU_RELRO)) {
+      return false;
+   }
+
+   // File bytes must be inside the segment's file bytes
+   if (!isNobits) {
+      if (sec->sh_offset < seg->p_offset ||
+          sec->sh_offset - seg->p_offset > seg->p_filesz - 1 ||
+          sec->sh_offset - seg->p_offset + size > seg->p_filesz) {
+         return false;
+      }
+   }
+
+   // Addresses must be inside the segment's memory
+   if (isAlloc) {
+      if (sec->sh_addr < seg->p_vaddr ||
+          sec->sh_addr - seg->p_vaddr > seg->p_memsz - 1 ||
+          sec->sh_addr - seg->p_vaddr + size > seg->p_memsz) {
+         return false;
+      }
+   }
+
+   // Empty sections don't count at the edges of DYNAMIC and NOTE segments
+   if ((seg->p_type == PT_DYNAMIC || seg->p_type == PT_NOTE) && size == 0 && seg->p_memsz != 0) {
+      if (!isNobits && !(sec->sh_offset > seg->p_offset && sec->sh_offset - seg->p_offset < seg->p_filesz)) {
+         return false;
+      }
+      if (isAlloc && !(sec->sh_addr > seg->p_vaddr && sec->sh_addr - seg->p_vaddr < seg->p_memsz)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/**
+ * A utility function that finds the first sort key that is not less
+ * than a value, using a binary search.
+ *
+ * INPUT:   array of sorted keys
+ *          number of keys
+ *          value to search for
+ *
+ * OUTPUT:  position of the first key >= value (count if none)
+ */
+int lowerBoundKey(const struct sectionKey *keys, int count, uint64_t key) {
+
+   int low = 0;
+   int high = count;
+   int mid;
+
+   while (low < high) {
+      mid = low + (high - low) / 2;
+      if (keys[mid].key < key) {
+         low = mid + 1;
+      } else {
+         high = mid;
+      }
+   }
+
+   return low;
+}
+
+/**
+ * A qsort comparator for section keys, ordering by key and then by
+ * section index.
+ */
+int compareSectionKeys(const void *a, const void *b) {
+
+   const struct sectionKey *left  = a;
+   const struct sectionKey *right = b;
+
+   if (left->key != right->key) {
+      return (left->key < right->key) ? -1 : 1;
+   }
+   return left->index - right->index;
+}
+
+/**
+ * A qsort comparator for ints in ascending order.
+ */
+int compareInts(const void *a, const void *b) {
+   return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * A utility function that names a segment type the way readelf does.
+ *
+ * INPUT:   p_type value
+ *
+ * OUTPUT:  name of the type
+ */
+const char *segmentTypeName(uint32_t type) {
+
+   switch(type) {
+      case PT_NULL:
+         return "NULL";
+      case PT_LOAD:
+         return "LOAD";
+      case PT_DYNAMIC:
+         return "DYNAMIC";
+      case PT_INTERP:
+         return "INTERP";
+      case PT_NOTE:
+         return "NOTE";
+      case PT_SHLIB:
+         return "SHLIB";
+      case PT_PHDR:
+         return "PHDR";
+      case PT_TLS:
+         return "TLS";
+      case PT_GNU_EH_FRAME:
+         return "GNU_EH_FRAME";
+      case PT_GNU_STACK:
+         return "GNU_STACK";
+      case PT_GNU_RELRO:
+         return "GNU_RELRO";
+      case PT_GNU_PROPERTY:
+         return "GNU_PROPERTY";
+      default:
+         return "???";
+   }
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file programHeaders.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+bool readProgramHeaders(const union fileHeader_union *fileHeader, struct segmentTable *segTable, const struct fileImage *image);
+void printSegmentInfo(const union fileHeader_union *fileHeader, struct outputBuffer *out);
+void printProgramHeaders(const struct segmentTable *segTable, const struct fileImage *image, struct outputBuffer *out);
+void printSegmentMapping(const struct segmentTable *segTable, const struct sectionTable *secTable, struct outputBuffer *out);
+bool sectionInSegment(const union sectionHeader_union *secHeader, const union programHeader_union *progHeader);
+int lowerBoundKey(const struct sectionKey *keys, int count, uint64_t key);
+int compareSectionKeys(const void *a, const void *b);
+int compareInts(const void *a, const void *b);
+const char *segmentTypeName(uint32_t type);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+const char *fileTypeName(uint16_t type);
+
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
+// Defines
+#define PT_NULL         0
+#define PT_LOAD         1
+#define PT_DYNAMIC      2
+#define PT_INTERP       3
+#define PT_NOTE         4
+#define PT_SHLIB        5
+#define PT_PHDR         6
+#define PT_TLS          7
+#define PT_GNU_EH_FRAME 0x6474e550
+#define PT_GNU_STACK    0x6474e551
+#define PT_GNU_RELRO    0x6474e552
+#define PT_GNU_PROPERTY 0x6474e553
+
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+
+#define SHT_NOBITS 8
+#define SHF_ALLOC  0x2
+#define SHF_TLS    0x400
@@ -0,0 +1,458 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file relocations.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "relocations.h"
+
+/**
+ * Relocation type names for the machines readelf users see most.
+ * Gaps in the numbering are left NULL.
+ */
+static const char *const x86_64RelocNames[] = {
+   "R_X86_64_NONE", "R_X86_64_64", "R_X86_64_PC32", "R_X86_64_GOT32",
+   "R_X86_64_PLT32", "R_X86_64_COPY", "R_X86_64_GLOB_DAT", "R_X86_64_JUMP_SLOT",
+   "R_X86_64_RELATIVE", "R_X86_64_GOTPCREL", "R_X86_64_32", "R_X86_64_32S",
+   "R_X86_64_16", "R_X86_64_PC16", "R_X86_64_8", "R_X86_64_PC8",
+   "R_X86_64_DTPMOD64", "R_X86_64_DTPOFF64", "R_X86_64_TPOFF64", "R_X86_64_TLSGD",
+   "R_X86_64_TLSLD", "R_X86_64_DTPOFF32", "R_X86_64_GOTTPOFF", "R_X86_64_TPOFF32",
+   "R_X86_64_PC64", "R_X86_64_GOTOFF64", "R_X86_64_GOTPC32", "R_X86_64_GOT64",
+   "R_X86_64_GOTPCREL64", "R_X86_64_GOTPC64", "R_X86_64_GOTPLT64", "R_X86_64_PLTOFF64",
+   "R_X86_64_SIZE32", "R_X86_64_SIZE64", "R_X86_64_GOTPC32_TLSDESC", "R_X86_64_TLSDESC_CALL",
+   "R_X86_64_TLSDESC", "R_X86_64_IRELATIVE", "R_X86_64_RELATIVE64", NULL,
+   NULL, "R_X86_64_GOTPCRELX", "R_X86_64_REX_GOTPCRELX",
+};
+
+static const char *const i386RelocNames[] = {
+   "R_386_NONE", "R_386_32", "R_386_PC32", "R_386_GOT32",
+   "R_386_PLT32", "R_386_COPY", "R_386_GLOB_DAT", "R_386_JUMP_SLOT",
+   "R_386_RELATIVE", "R_386_GOTOFF", "R_386_GOTPC", "R_386_32PLT",
+   NULL, NULL, "R_386_TLS_TPOFF", "R_386_TLS_IE",
+   "R_386_TLS_GOTIE", "R_386_TLS_LE", "R_386_TLS_GD", "R_386_TLS_LDM",
+   "R_386_16", "R_386_PC16", "R_386_8", "R_386_PC8",
+   "R_386_TLS_GD_32", "R_386_TLS_GD_PUSH", "R_386_TLS_GD_CALL", "R_386_TLS_GD_POP",
+   "R_386_TLS_LDM_32", "R_386_TLS_LDM_PUSH", "R_386_TLS_LDM_CALL", "R_386_TLS_LDM_POP",
+   "R_386_TLS_LDO_32", "R_386_TLS_IE_32", "R_386_TLS_LE_32", "R_386_TLS_DTPMOD32",
+   "R_386_TLS_DTPOFF32", "R_386_TLS_TPOFF32", "R_386_SIZE32", "R_386_TLS_GOTDESC",
+   "R_386_TLS_DESC_CALL", "R_386_TLS_DESC", "R_386_IRELATIVE", "R_386_GOT32X",
+};
+
+/**
+ * A function that finds every relocation section in the section table,
+ * by section type, and prints each one.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          true to print only the count of each relocation type
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, bool summary, struct outputBuffer *out) {
+
+   int iter;
+   bool found = false;
+   const struct sectionEntry *section;
+
+   // Iterate over the section table
+   for (iter=0; iter < secTable->count; iter++) {
+
+      section = &secTable->sections[iter];
+
+      if (section->data.Struct.sh_type == SHT_REL || section->data.Struct.sh_type == SHT_RELA) {
+         printRelocationSection(fileHeader, secTable, section, image, summary, out);
+         found = true;
+      }
+   }
+
+   // Check for a file without relocations
+   if (!found) {
+      writeText(out, "\n");
+      writeText(out, "There are no relocations in this file.\n");
+   }
+}
+
+/**
+ * A function that prints one relocation section, either entry by
+ * entry or as a count of each relocation type.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the relocation section
+ *          pointer to the image of the file
+ *          true to print only the count of each relocation type
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printRelocationSection(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, bool summary, struct outputBuffer *out) {
+
+   int entSize;
+   uint64_t count;
+
+   const unsigned char *table;
+   const struct elfDecoder *decoder;
+
+   // Entries must be at least as large as the ELF class says
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   entSize = section->data.Struct.sh_entsize;
+   if (entSize < ((section->data.Struct.sh_type == SHT_RELA) ? decoder->relaSize : decoder->relSize)) {
+      writeText(out, "\nRelocation section '");
+      writeText(out, section->name);
+      writeText(out, "' has an invalid sh_entsize!\n");
+      return;
+   }
+   count = section->data.Struct.sh_size / entSize;
+
+   // Locate the entries in the image
+   table = imageAt(image, section->data.Struct.sh_offset, count * entSize);
+   if (table == NULL) {
+      writeText(out, "\nRelocation section '");
+      writeText(out, section->name);
+      writeText(out, "' extends past the end of the file.\n");
+      return;
+   }
+
+   // The entries are read front to back
+   imageAdvise(image, section->data.Struct.sh_offset, count * entSize, MADV_SEQUENTIAL);
+
+   // Print section info
+   writeText(out, "\n");
+   writeText(out, "Relocation section '");
+   writeText(out, section->name);
+   writeText(out, "' at offset 0x");
+   writeHex(out, section->data.Struct.sh_offset, 1);
+   writeText(out, " contains ");
+   writeUnsigned(out, count);
+   writeText(out, (count == 1) ? " entry:\n" : " entries:\n");
+
+   if (summary) {
+      printRelocationSummary(fileHeader, section, table, count, out);
+   } else {
+      printRelocationEntries(fileHeader, secTable, section, image, table, count, out);
+   }
+}
+
+/**
+ * A function that prints each entry of a relocation section, with the
+ * value and name of the symbol it refers to.  Entries are decoded a
+ * chunk at a time into a fixed buffer, and symbols are decoded one at
+ * a time straight from the linked symbol table.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the relocation section
+ *          pointer to the image of the file
+ *          pointer to the entries in the image
+ *          number of entries
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printRelocationEntries(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, const unsigned char *table, uint64_t count, struct outputBuffer *out) {
+
+   int iter;
+   int chunkSize;
+   int symEntSize = 0;
+   uint64_t first;
+   uint64_t symCount = 0;
+   uint64_t strtabSize = 0;
+   uint64_t shndxCount = 0;
+   uint64_t addend;
+
+   bool rela  = (section->data.Struct.sh_type == SHT_RELA);
+   bool bit32 = (fileHeader->arr[4] == BIT32);
+
+   const char *typeName;
+   const char *strtab = NULL;
+   const unsigned char *symbols = NULL;
+   const unsigned char *shndxTable = NULL;
+   const struct sectionEntry *symSection;
+   const struct elfDecoder *decoder;
+   const struct relocationEntry *reloc;
+
+   struct relocationEntry *relocations;
+   union symbol_union symbol;
+
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+
+   // Locate the linked symbol table and its names
+   if (section->data.Struct.sh_link != 0 && section->data.Struct.sh_link < (uint32_t)secTable->count) {
+      symSection = &secTable->sections[section->data.Struct.sh_link];
+      symEntSize = symSection->data.Struct.sh_entsize;
+      if (symEntSize >= decoder->symbolSize) {
+         symCount = symSection->data.Struct.sh_size / symEntSize;
+         symbols  = imageAt(image, symSection->data.Struct.sh_offset, symCount * symEntSize);
+         strtab   = findStringTable(secTable, symSection, image, &strtabSize);
+         shndxTable = findSymbolShndx(secTable, symSection, image, &shndxCount);
+      }
+      if (symbols == NULL) {
+         symCount = 0;
+      }
+   }
+
+   // Print formatting info
+   if (bit32) {
+      writeText(out, " Offset     Info    Type                Sym. Value  Symbol's Name");
+   } else {
+      writeText(out, "    Offset             Info             Type               Symbol's Value  Symbol's Name");
+   }
+   writeText(out, rela ? " + Addend\n" : "\n");
+
+   relocations = malloc(RELOC_CHUNK * sizeof(struct relocationEntry));
+
+   // Decode and print a chunk at a time
+   for (first=0; first < count; first += chunkSize) {
+
+      chunkSize = (count - first > RELOC_CHUNK) ? RELOC_CHUNK : count - first;
+      decoder->decodeRelocations(table + first * section->data.Struct.sh_entsize, chunkSize,
+            section->data.Struct.sh_entsize, rela, relocations);
+
+      for (iter=0; iter < chunkSize; iter++) {
+
+         reloc = &relocations[iter];
+
+         // Print r_offset and r_info
+         writeHex(out, reloc->offset, bit32 ? 8 : 16);
+         writeText(out, "  ");
+         writeHex(out, reloc->info, bit32 ? 8 : 16);
+         writeChar(out, ' ');
+
+         // Print the type
+         typeName = relocationTypeName(fileHeader->Struct.e_machine, reloc->type);
+         if (typeName == NULL) {
+            writeText(out, "unrecognized: ");
+            writeHexPadded(out, reloc->type, -7);
+         } else {
+            writeTextPadded(out, typeName, -22);
+         }
+
+         // Print the symbol's value and name
+         if (reloc->symbol != 0) {
+            if (reloc->symbol >= symCount) {
+               writeText(out, " bad symbol index: ");
+               writeHex(out, reloc->symbol, 8);
+               writeText(out, " in reloc");
+            } else {
+               decoder->decodeSymbols(symbols + (uint64_t)reloc->symbol * symEntSize, 1, symEntSize, &symbol);
+               writeChar(out, ' ');
+               writeHex(out, symbol.Struct.st_value, bit32 ? 8 : 16);
+               writeText(out, bit32 ? "   " : " ");
+               writeText(out, symbolName(strtab, strtabSize, secTable, &symbol.Struct,
+                     symbolSection(&symbol.Struct, reloc->symbol, shndxTable, shndxCount, decoder)));
+            }
+            if (rela) {
+               addend = reloc->addend;
+               writeText(out, (reloc->addend < 0) ? " - " : " + ");
+               writeHex(out, (reloc->addend < 0) ? -addend : addend, 1);
+            }
+         }
+
+         // Relocations without a symbol only have an addend
+         else if (rela) {
+            addend = reloc->addend;
+            writeTextPadded(out, "", bit32 ? 12 : 20);
+            writeText(out, (reloc->addend < 0) ? "-" : "");
+            writeHex(out, (reloc->addend < 0) ? -addend : addend, 1);
+         }
+
+         writeChar(out, '\n');
+      }
+   }
+
+   free(relocations);
+}
+
+/**
+ * A function that prints how many relocations of each type a section
+ * holds.  Entries are decoded a chunk at a time and only counted, so
+ * nothing is formatted per entry.  Small type numbers are counted in
+ * a flat array; any others go in a short list.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the relocation section
+ *          pointer to the entries in the image
+ *          number of entries
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printRelocationSummary(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const unsigned char *table, uint64_t count, struct outputBuffer *out) {
+
+   int iter;
+   int pos;
+   int chunkSize;
+   int otherCount = 0;
+   int otherSize = 0;
+   int listCount = 0;
+   uint32_t type;
+   uint64_t first;
+
+   uint64_t directCounts[RELOC_DIRECT_TYPES] = {0};
+
+   const char *typeName;
+   const struct elfDecoder *decoder;
+
+   struct relocationCount *others = NULL;
+   struct relocationCount *list;
+   struct relocationEntry *relocations;
+
+   bool rela = (section->data.Struct.sh_type == SHT_RELA);
+
+   decoder     = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   relocations = malloc(RELOC_CHUNK * sizeof(struct relocationEntry));
+
+   // Decode and count a chunk at a time
+   for (first=0; first < count; first += chunkSize) {
+
+      chunkSize = (count - first > RELOC_CHUNK) ? RELOC_CHUNK : count - first;
+      decoder->decodeRelocations(table + first * section->data.Struct.sh_entsize, chunkSize,
+            section->data.Struct.sh_entsize, rela, relocations);
+
+      for (iter=0; iter < chunkSize; iter++) {
+
+         type = relocations[iter].type;
+
+         // Count the common types directly
+         if (type < RELOC_DIRECT_TYPES) {
+            directCounts[type]++;
+            continue;
+         }
+
+         // Find the type in the list, or add it
+         pos = 0;
+         while (pos < otherCount && others[pos].type != type) {
+            pos++;
+         }
+         if (pos == otherCount) {
+            if (otherCount == otherSize) {
+               otherSize = (otherSize == 0) ? 16 : otherSize * 2;
+               others    = realloc(others, otherSize * sizeof(struct relocationCount));
+            }
+            others[otherCount].type  = type;
+            others[otherCount].count = 0;
+            otherCount++;
+         }
+         others[pos].count++;
+      }
+   }
+
+   free(relocations);
+
+   // Gather every type that turned up, in type order
+   list = malloc((RELOC_DIRECT_TYPES + otherCount) * sizeof(struct relocationCount));
+   for (type=0; type < RELOC_DIRECT_TYPES; type++) {
+      if (directCounts[type] != 0) {
+         list[listCount].type  = type;
+         list[listCount].count = directCounts[type];
+         listCount++;
+      }
+   }
+   qsort(others, otherCount, sizeof(struct relocationCount), compareRelocationCounts);
+   for (pos=0; pos < otherCount; pos++) {
+      list[listCount++] = others[pos];
+   }
+
+   // Print the counts
+   writeText(out, "  Type                          Count\n");
+   for (pos=0; pos < listCount; pos++) {
+      typeName = relocationTypeName(fileHeader->Struct.e_machine, list[pos].type);
+      if (typeName == NULL) {
+         writeText(out, "  unrecognized: ");
+         writeHexPadded(out, list[pos].type, -10);
+      } else {
+         writeText(out, "  ");
+         writeTextPadded(out, typeName, -24);
+      }
+      writeChar(out, ' ');
+      writeUnsignedPadded(out, list[pos].count, 10);
+      writeChar(out, '\n');
+   }
+
+   free(list);
+   free(others);
+}
+
+/**
+ * A utility function that names a relocation type for a machine.
+ *
+ * INPUT:   e_machine of the file
+ *          relocation type
+ *
+ * OUTPUT:  name of the type
+ *          NULL if the type isn't known
+ */
+const char *relocationTypeName(uint16_t machine, uint32_t type) {
+
+   switch(machine) {
+      case EM_X86_64:
+         if (type < sizeof(x86_64RelocNames) / sizeof(x86_64RelocNames[0])) {
+            return x86_64RelocNames[type];
+         }
+         break;
+      case EM_386:
+         if (type < sizeof(i386RelocNames) / sizeof(i386RelocNames[0])) {
+            return i386RelocNames[type];
+         }
+         break;
+   }
+
+   return NULL;
+}
+
+/**
+ * A utility function that sorts a relocation type into the kind of
+ * work the dynamic loader does for it: adding the load address
+ * (relative), filling a PLT slot (which can be done lazily), or
+ * looking a symbol up (symbolic).
+ *
+ * INPUT:   e_machine of the file
+ *          relocation type
+ *
+ * OUTPUT:  RELOC_CLASS_* value
+ */
+int relocationClass(uint16_t machine, uint32_t type) {
+
+   switch(machine) {
+      case EM_X86_64:
+         if (type == R_X86_64_RELATIVE || type == R_X86_64_IRELATIVE || type == R_X86_64_RELATIVE64) {
+            return RELOC_CLASS_RELATIVE;
+         }
+         if (type == R_X86_64_JUMP_SLOT) {
+            return RELOC_CLASS_PLT;
+         }
+         break;
+      case EM_386:
+         if (type == R_386_RELATIVE || type == R_386_IRELATIVE) {
+            return RELOC_CLASS_RELATIVE;
+         }
+         if (type == R_386_JUMP_SLOT) {
+            return RELOC_CLASS_PLT;
+         }
+         break;
+   }
+
+   return (type == 0) ? RELOC_CLASS_NONE : RELOC_CLASS_SYMBOLIC;
+}
+
+/**
+ * A qsort comparator for relocation counts, ordering by type.
+ */
+int compareRelocationCounts(const void *a, const void *b) {
+
+   const struct relocationCount *left  = a;
+   const struct relocationCount *right = b;
+
+   if (left->type != right->type) {
+      return (left->type < right->type) ? -1 : 1;
+   }
+   return 0;
+}
@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file relocations.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+void printRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, bool summary, struct outputBuffer *out);
+void printRelocationSection(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, bool summary, struct outputBuffer *out);
+void printRelocationEntries(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, const unsigned char *table, uint64_t count, struct outputBuffer *out);
+void printRelocationSummary(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const unsigned char *table, uint64_t count, struct outputBuffer *out);
+const char *relocationTypeName(uint16_t machine, uint32_t type);
+int relocationClass(uint16_t machine, uint32_t type);
+int compareRelocationCounts(const void *a, const void *b);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+const unsigned char *findSymbolShndx(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *shndxCount);
+uint32_t symbolSection(const struct symbol_struct64 *symbol, uint64_t number, const unsigned char *shndxTable, uint64_t shndxCount, const struct elfDecoder *decoder);
+const char *symbolName(const char *strtab, uint64_t strtabSize, const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx);
+
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
+void writeUnsignedPadded(struct outputBuffer *buffer, uint64_t value, int width);
+void writeHexPadded(struct outputBuffer *buffer, uint64_t value, int width);
+// Defines
+#define BIT32 1
+#define BIT64 2
+
+#define SHT_RELA 4
+#define SHT_REL  9
+
+#define EM_386    3
+#define EM_X86_64 0x3e
+
+#define R_X86_64_JUMP_SLOT  7
+#define R_X86_64_RELATIVE   8
+#define R_X86_64_IRELATIVE  37
+#define R_X86_64_RELATIVE64 38
+#define R_386_JUMP_SLOT     7
+#define R_386_RELATIVE      8
+#define R_386_IRELATIVE     42
+
+#define RELOC_CLASS_NONE     0
+#define RELOC_CLASS_RELATIVE 1
+#define RELOC_CLASS_PLT      2
+#define RELOC_CLASS_SYMBOLIC 3
+
+#define RELOC_CHUNK (1 << 12)
+#define RELOC_DIRECT_TYPES 256
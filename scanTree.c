@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file scanTree.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "scanTree.h"
+
+/**
+ * A function that processes every regular file under the -R
+ * directories, plus any files named on the command line, then prints a
+ * summary of how each file fared.  Files are checked and processed on
+ * the worker pool.  Files without the ELF magic bytes are skipped as
+ * soon as the prefetcher has read their first bytes, without being
+ * mapped, and files that fail are reported without stopping the scan.
+ * Since scanning waits on the disk more than the CPU, the pool runs
+ * several workers per core unless -j says otherwise.
+ *
+ * INPUT:   array of directories to scan
+ *          number of directories
+ *          array of file names from the command line
+ *          number of file names
+ *          boolean array for hex dump args one-hot-encoding
+ *          number of args
+ *          args (pointer to string arr)
+ *
+ * OUTPUT:  true if every ELF file was processed
+ *          false if any file failed
+ */
+bool processTrees(char *scanDirs[], int scanDirCount, char *fileNames[], int fileCount, bool *hexDumpArgs, int argc, char *argv[]) {
+
+   int iter;
+   int workers;
+   long cpuCount;
+   bool success;
+   FILE *report;
+
+   struct scanList list = {0};
+   struct scanSummary summary = {0};
+
+   // Gather the files to check
+   for (iter=0; iter < fileCount; iter++) {
+      addScanPath(&list, strdup(fileNames[iter]));
+   }
+   for (iter=0; iter < scanDirCount; iter++) {
+      scanDirectory(scanDirs[iter], &list);
+   }
+
+   // Keep the disk busy with several workers per core
+   cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+   workers  = (workerCount > 0) ? workerCount : SCAN_WORKERS_PER_CPU * (cpuCount > 1 ? cpuCount : 1);
+   if (workers > SCAN_MAX_WORKERS) {
+      workers = SCAN_MAX_WORKERS;
+   }
+
+   summary.failed = malloc((list.count > 0 ? list.count : 1) * sizeof(char *));
+
+   success = processFilesParallel(list.paths, list.count, workers, &summary, hexDumpArgs, argc, argv);
+
+   // Print how each file fared, out of the way of structured output
+   report = (outputFormat == OUTPUT_TEXT) ? stdout : stderr;
+   fprintf(report, "\n");
+   fprintf(report, "Scan summary:\n");
+   fprintf(report, "  %-22s %d\n", "ELF files processed", summary.elfCount);
+   fprintf(report, "  %-22s %d\n", "Not ELF, skipped", summary.skippedCount);
+   fprintf(report, "  %-22s %d\n", "Failed", summary.failedCount);
+   for (iter=0; iter < summary.failedCount; iter++) {
+      fprintf(report, "    %s\n", summary.failed[iter]);
+   }
+
+   // Free the file list
+   for (iter=0; iter < list.count; iter++) {
+      free(list.paths[iter]);
+   }
+   free(list.paths);
+   free(summary.failed);
+
+   return success;
+}
+
+/**
+ * A function that adds every regular file under a directory to the
+ * list, recursing into subdirectories.  The entry type from readdir is
+ * used where the filesystem gives one, so most files are never
+ * stat'ed.  Symbolic links are not followed, which keeps each file
+ * from being listed twice and stops link loops.  Directories that
+ * can't be opened are reported and skipped.
+ *
+ * INPUT:   path of the directory
+ *          pointer to the list to add to
+ *
+ * OUTPUT:  none
+ */
+void scanDirectory(const char *dirName, struct scanList *list) {
+
+   DIR *dir;
+   int type;
+   size_t length;
+   char *path;
+   struct dirent *entry;
+   struct stat info;
+
+   if ( (dir = opendir(dirName)) == NULL ) {
+      fprintf(stderr, "%s: %s: Warning: Cannot open directory\n", programName, dirName);
+      return;
+   }
+
+   while ( (entry = readdir(dir)) != NULL ) {
+
+      // Skip this directory and its parent
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+         continue;
+      }
+
+      // Join the names, without doubling a trailing slash
+      length = strlen(dirName);
+      path   = malloc(length + strlen(entry->d_name) + 2);
+      sprintf(path, "%s%s%s", dirName, (length > 0 && dirName[length - 1] == '/') ? "" : "/", entry->d_name);
+
+      // Only stat entries whose type readdir didn't give
+      type = entry->d_type;
+      if (type == DT_UNKNOWN) {
+         if (lstat(path, &info) == 0) {
+            type = S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+         }
+      }
+
+      if (type == DT_DIR) {
+         scanDirectory(path, list);
+         free(path);
+      } else if (type == DT_REG) {
+         addScanPath(list, path);
+      } else {
+         free(path);
+      }
+   }
+
+   closedir(dir);
+}
+
+/**
+ * A utility function that appends a path to a scan list, which takes
+ * ownership of it.
+ *
+ * INPUT:   pointer to the list
+ *          path to add
+ *
+ * OUTPUT:  none
+ */
+void addScanPath(struct scanList *list, char *path) {
+
+   if (list->count == list->capacity) {
+      list->capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+      list->paths    = realloc(list->paths, list->capacity * sizeof(char *));
+   }
+
+   list->paths[list->count++] = path;
+}
@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file scanTree.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern char *programName;
+extern int workerCount;
+extern int outputFormat;
+
+// Local Prototypes
+bool processTrees(char *scanDirs[], int scanDirCount, char *fileNames[], int fileCount, bool *hexDumpArgs, int argc, char *argv[]);
+void scanDirectory(const char *dirName, struct scanList *list);
+void addScanPath(struct scanList *list, char *path);
+
+// Other Prototypes
+bool processFilesParallel(char *fileNames[], int fileCount, int workers, struct scanSummary *summary, bool *hexDumpArgs, int argc, char *argv[]);
+
+// Defines
+#define SCAN_WORKERS_PER_CPU 4
+#define SCAN_MAX_WORKERS 64
+
+#define OUTPUT_TEXT 0
@@ -13,301 +13,570 @@
 #include "sectionHeaders.h"
 
 /**
- * A function that scans each section header in a given file and allocates
- * memory for a linked list node to store the section data.  It then
- * updates the head of the linked list.
+ * A function that scans each section header in a given file and stores
+ * the section data in one contiguous table.  The whole table is decoded
+ * in one call by the decoder for the file's class and endianness.  A
+ * hash index over the section names is built once the names are known.
+ * Files with extended section numbering (more than 65,279 sections)
+ * have an e_shnum of 0, and the real count is read from section 0.
  *
  * INPUT:   pointer to the fileHeader for this file
- *          pointer to a pointer to the LL head
- *          pointer to the file
+ *          pointer to the section table to fill in
+ *          pointer to the image of the file
  *
- * OUTPUT:  none
+ * OUTPUT:  true if the section headers were read
+ *          false if the table is truncated or corrupt, or there
+ *          wasn't memory to hold it
  */
-void readSectionHeaders(union fileHeader_union *fileHeader, struct sectionNode **startSecLL, FILE *file) {
-
-   int i;
-   int iter;
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image) {
 
    int headerSize;
    int headerCount;
-   long int start;
+   uint64_t extendedCount;
 
-   char buffer[64] = {0};
+   const unsigned char *table;
+   const struct elfDecoder *decoder;
 
-   struct sectionNode *currNode = *startSecLL;
-   struct sectionNode *newNode;
+   // Start from an empty table
+   secTable->sections    = NULL;
+   secTable->count       = 0;
+   secTable->nameIndex   = NULL;
+   secTable->bucketCount = 0;
 
    // Update section variables
    headerSize  = fileHeader->Struct.e_shentsize;
    headerCount = fileHeader->Struct.e_shnum;
-   start       = fileHeader->Struct.e_shoff;
 
-   // Set file pointer to section header start
-   fseek(file, start, SEEK_SET);
+   // Pick the decoder once for the whole table
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
 
-   // Iterate over each header
-   for (iter=0; iter < headerCount; iter++) {
+   // Headers must be at least as large as the ELF class says
+   if ((headerCount > 0 || fileHeader->Struct.e_shoff != 0) && headerSize < decoder->sectionHeaderSize) {
+      return false;
+   }
 
-      // Re-initialize buffer
-      for (i=0; i < headerSize; i++) {
-        buffer[i] = 0;
+   // Take the count from section 0 under extended numbering
+   if (headerCount == 0 && fileHeader->Struct.e_shoff != 0) {
+      if (!readExtendedCount(fileHeader, image, decoder, &extendedCount) ||
+          extendedCount > INT_MAX || extendedCount > image->size / headerSize) {
+         return false;
       }
+      headerCount = extendedCount;
+   }
 
-      // Populate buffer with section header
-      for (i=0; i < headerSize; i++) {
-        buffer[i] = fgetc(file);
-      }
+   // Locate the section header table in the image
+   table = imageAt(image, fileHeader->Struct.e_shoff, (uint64_t)headerSize * headerCount);
+   if (table == NULL) {
+      return false;
+   }
 
-      // Allocate memory for section header
-      newNode = malloc(sizeof(struct sectionNode));
+   // Allocate memory for every section at once
+   secTable->sections = calloc(headerCount > 0 ? headerCount : 1, sizeof(struct sectionEntry));
+   if (secTable->sections == NULL) {
+      return false;
+   }
+   secTable->count = headerCount;
 
-      // Add node to LL
-      if (currNode == NULL) {
-         currNode = newNode;        // create head node
-         *startSecLL = currNode;    // update head pointer
-      } else {
-         currNode->next = newNode;  // update previous node's .next
-         currNode = newNode;        // update current node
-      }
+   // Decode the table into 64bit, local endian format
+   decoder->decodeSectionHeaders(table, headerCount, headerSize, secTable->sections);
 
-      // Update currNode values
-      currNode->index = iter;
-      currNode->next = NULL;
-      memcpy(currNode->data.arr, buffer, 64);
+   // Update names of each section and index them
+   if (secTable->count > 0) {
+      readSectionNames(fileHeader, secTable, image);
+      return buildSectionIndex(secTable);
+   }
 
-      // Make sure union is in 64bit format
-      if (fileHeader->arr[4] == BIT32) {
-         sectionHeader32to64(&(currNode->data));
-      }
+   return true;
+}
 
-      // Make sure file endian matches local endian
-      if (!checkSameEndian(fileHeader->arr[5])) {
-         sectionHeaderEndianSwap(&(currNode->data));
-      }
+/**
+ * A function that reads the section count of a file that uses extended
+ * section numbering, which is kept in the sh_size of section 0.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the image of the file
+ *          decoder for the file's class and endianness
+ *          pointer to store the count in
+ *
+ * OUTPUT:  true if section 0 was read
+ *          false if it lies outside the file
+ */
+bool readExtendedCount(const union fileHeader_union *fileHeader, const struct fileImage *image, const struct elfDecoder *decoder, uint64_t *count) {
+
+   const unsigned char *raw;
+   struct sectionEntry first;
+
+   raw = imageAt(image, fileHeader->Struct.e_shoff, decoder->sectionHeaderSize);
+   if (raw == NULL) {
+      return false;
    }
 
-   // Update names of each section
-   readSectionNames(*startSecLL, file);
+   decoder->decodeSectionHeaders(raw, 1, decoder->sectionHeaderSize, &first);
+   *count = first.data.Struct.sh_size;
+
+   return true;
 }
 
 /**
- * A function that iterates over the LL and copies the section name
- * to the node name.
+ * A function that points each section's name into the section name
+ * string table, found through the file header's e_shstrndx.  Names
+ * are not copied, so they stay valid for as long as the image does.
+ * Sections whose name runs outside the string table get "<corrupt>".
  *
- * INPUT:   pointer to the linked list head
- *          pointer to the file
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
  *
  * OUTPUT:  none
  */
-void readSectionNames(struct sectionNode *startSecLL, FILE *file) {
+void readSectionNames(const union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image) {
+
+   int iter;
+   uint64_t strtabSize = 0;
+   uint32_t nameOffset;
+   uint32_t strIndex;
 
-   uint64_t shstrndx;
+   const char *strtab = NULL;
+   const union sectionHeader_union *strHeader;
 
-   struct sectionNode *node = startSecLL;
+   struct sectionEntry *section;
 
-   // Find the shstrndx header (end of LL)
-   while (node->next != NULL) {
-      node = node->next;
+   // Locate the section name string table
+   strIndex = sectionNameIndex(fileHeader, secTable);
+   if (strIndex != 0 && strIndex < (uint32_t)secTable->count) {
+      strHeader  = &secTable->sections[strIndex].data;
+      strtab     = (const char *)imageAt(image, strHeader->Struct.sh_offset, strHeader->Struct.sh_size);
+      strtabSize = strHeader->Struct.sh_size;
    }
 
-   // Set shstrndx offset
-   shstrndx = node->data.Struct.sh_offset;
+   // Iterate over each section
+   for (iter=0; iter < secTable->count; iter++) {
 
-   // Reset node variable
-   node = startSecLL;
+      section    = &secTable->sections[iter];
+      nameOffset = section->data.Struct.sh_name;
 
-   // Iterate over each node
-   while (node != NULL) {
+      // Files without a string table have no names
+      if (strtab == NULL) {
+         section->name = "";
+      }
 
-      // Move file pointer to start of section name
-      fseek(file, shstrndx + node->data.Struct.sh_name, SEEK_SET);
+      // Point at the name if it ends inside the string table
+      else if (nameOffset < strtabSize && memchr(strtab + nameOffset, '\0', strtabSize - nameOffset) != NULL) {
+         section->name = strtab + nameOffset;
+      }
 
-      // Copy name to node
-      fgets(node->name, 128, file);
-      
-      // Increment node
-      node = node->next;
+      else {
+         section->name = "<corrupt>";
+      }
    }
 }
 
 /**
- * A utility function that converts a sectionHeader's content from
- * 32bit to 64bit.  All other functions rely on the sectionHeader info
- * to be in 64bit format.
+ * A utility function that gives the index of the section name string
+ * table.  Under extended numbering e_shstrndx is SHN_XINDEX and the
+ * real index is the sh_link of section 0.
  *
- * INPUT:   pointer to the section header to update
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
  *
- * OUTPUT:  none
+ * OUTPUT:  index of the section name string table
  */
-void sectionHeader32to64(union sectionHeader_union *secHeader) {
+uint32_t sectionNameIndex(const union fileHeader_union *fileHeader, const struct sectionTable *secTable) {
+
+   if (fileHeader->Struct.e_shstrndx == SHN_XINDEX && secTable->count > 0) {
+      return secTable->sections[0].data.Struct.sh_link;
+   }
 
-   // Copy fields from 32struct to 64struct in reverse order
-   secHeader->Struct.sh_entsize   = (uint64_t)secHeader->Struct32.sh_entsize;
-   secHeader->Struct.sh_addralign = (uint64_t)secHeader->Struct32.sh_addralign;
+   return fileHeader->Struct.e_shstrndx;
+}
+
+/**
+ * A utility function that gives the number of sections.  Under
+ * extended numbering e_shnum is 0 and the count read from section 0's
+ * sh_size is the real one.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *
+ * OUTPUT:  number of sections
+ */
+uint32_t sectionCount(const union fileHeader_union *fileHeader, const struct sectionTable *secTable) {
 
-   secHeader->Struct.sh_info      = secHeader->Struct32.sh_info;
-   secHeader->Struct.sh_link      = secHeader->Struct32.sh_link;
+   if (fileHeader->Struct.e_shnum == 0 && secTable->count > 0) {
+      return secTable->count;
+   }
 
-   secHeader->Struct.sh_size      = (uint64_t)secHeader->Struct32.sh_size;
-   secHeader->Struct.sh_offset    = (uint64_t)secHeader->Struct32.sh_offset;
-   secHeader->Struct.sh_addr      = (uint64_t)secHeader->Struct32.sh_addr;
-   secHeader->Struct.sh_flags     = (uint64_t)secHeader->Struct32.sh_flags;
+   return fileHeader->Struct.e_shnum;
 }
 
 /**
- * A utility function that converts a sectionHeader's content to
- * the same endianness as this program. All other functions rely
- * on the sectionHeader info to be the same endianness as the 
- * machine this is running on.
+ * A function that builds an open-addressing hash index from section
+ * names to section indexes.  The bucket count is a power of two at
+ * least twice the section count, so probes stay short.  When several
+ * sections share a name, the first one wins.
  *
- * INPUT:   pointer to the sectionHeader to update
+ * INPUT:   pointer to the section table
  *
- * OUTPUT:  none
+ * OUTPUT:  true if the index was built
+ *          false if there wasn't memory for it
  */
-void sectionHeaderEndianSwap(union sectionHeader_union *secHeader) {
+bool buildSectionIndex(struct sectionTable *secTable) {
+
+   int iter;
+   uint32_t bucket;
+   uint32_t mask;
+   int *slot;
+
+   // Size the index
+   secTable->bucketCount = 16;
+   while (secTable->bucketCount < 2 * secTable->count) {
+      secTable->bucketCount *= 2;
+   }
+   mask = secTable->bucketCount - 1;
 
-   // Swap endianness
-   secHeader->Struct.sh_name      = endianSwap32Bit(secHeader->Struct.sh_name);
-   secHeader->Struct.sh_type      = endianSwap32Bit(secHeader->Struct.sh_type);
+   // Mark every bucket empty
+   if ( (secTable->nameIndex = malloc(secTable->bucketCount * sizeof(int))) == NULL ) {
+      secTable->bucketCount = 0;
+      return false;
+   }
+   for (iter=0; iter < secTable->bucketCount; iter++) {
+      secTable->nameIndex[iter] = -1;
+   }
 
-   secHeader->Struct.sh_flags     = endianSwap64Bit(secHeader->Struct.sh_flags);
-   secHeader->Struct.sh_addr      = endianSwap64Bit(secHeader->Struct.sh_addr);
-   secHeader->Struct.sh_offset    = endianSwap64Bit(secHeader->Struct.sh_offset);
-   secHeader->Struct.sh_size      = endianSwap64Bit(secHeader->Struct.sh_size);
+   // Insert each section, probing linearly
+   for (iter=0; iter < secTable->count; iter++) {
 
-   secHeader->Struct.sh_link      = endianSwap32Bit(secHeader->Struct.sh_link);
-   secHeader->Struct.sh_info      = endianSwap32Bit(secHeader->Struct.sh_info);
+      bucket = hashName(secTable->sections[iter].name) & mask;
 
-   secHeader->Struct.sh_addralign = endianSwap64Bit(secHeader->Struct.sh_addralign);
-   secHeader->Struct.sh_entsize   = endianSwap64Bit(secHeader->Struct.sh_entsize);
+      while (true) {
+         slot = &secTable->nameIndex[bucket];
+
+         // Claim an empty bucket
+         if (*slot == -1) {
+            *slot = iter;
+            break;
+         }
+
+         // Keep the earlier section on a duplicate name
+         if (strcmp(secTable->sections[*slot].name, secTable->sections[iter].name) == 0) {
+            break;
+         }
+
+         bucket = (bucket + 1) & mask;
+      }
+   }
+
+   return true;
+}
+
+/**
+ * A function that looks up a section by name through the hash index.
+ *
+ * INPUT:   pointer to the section table
+ *          name of the section to find
+ *
+ * OUTPUT:  index of the section
+ *          -1 if no section has that name
+ */
+int findSection(const struct sectionTable *secTable, const char *secName) {
+
+   uint32_t bucket;
+   uint32_t mask;
+   int index;
+
+   // Empty tables have no index
+   if (secTable->nameIndex == NULL) {
+      return -1;
+   }
+
+   mask   = secTable->bucketCount - 1;
+   bucket = hashName(secName) & mask;
+
+   // Probe until the name or an empty bucket turns up
+   while ( (index = secTable->nameIndex[bucket]) != -1 ) {
+      if (strcmp(secTable->sections[index].name, secName) == 0) {
+         return index;
+      }
+      bucket = (bucket + 1) & mask;
+   }
+
+   return -1;
+}
+
+/**
+ * A function that finds the next section of a given type, in section
+ * order.  Passing the last index found plus one continues the search.
+ *
+ * INPUT:   pointer to the section table
+ *          sh_type to look for
+ *          index to start searching from
+ *
+ * OUTPUT:  index of the section
+ *          -1 if no later section has that type
+ */
+int findSectionByType(const struct sectionTable *secTable, uint32_t type, int start) {
+
+   int iter;
+
+   for (iter=start; iter < secTable->count; iter++) {
+      if (secTable->sections[iter].data.Struct.sh_type == type) {
+         return iter;
+      }
+   }
+
+   return -1;
 }
 
 /**
  * A function that prints general section header data before printing
  * the actual sectionHeader.  This is only done if the [-h] opt is not
- * called, since that prints the same data.
+ * called, since that prints the same data.  The count comes from the
+ * section table, so extended numbering shows the real count.
  *
  * INPUT:   pointer to the fileHeader
+ *          pointer to the section table
+ *          output buffer to print to
  *
  * OUTPUT:  none
  */
-void printSectionInfo(const union fileHeader_union *fileHeader) {
+void printSectionInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out) {
    // Print general information for headers
-   printf("There are %d section headers, starting at offset 0x%lx:",
-         fileHeader->Struct.e_shnum, fileHeader->Struct.e_shoff);
-   printf("\n");
+   writeText(out, "There are ");
+   writeUnsigned(out, secTable->count);
+   writeText(out, " section headers, starting at offset 0x");
+   writeHex(out, fileHeader->Struct.e_shoff, 1);
+   writeText(out, ":\n");
 }
 
 /**
- * A function that iterates over the section header linked list,
- * printing each node's data as it goes.
+ * A function that iterates over the section table, printing each
+ * section's data as it goes.  Fields are formatted straight into the
+ * output buffer at the widths printf would give them.  Compressed
+ * sections get a fifth line with the compression type and their
+ * compressed and uncompressed sizes.
  *
- * INPUT:   pointer to the section LL head
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          output buffer to print to
  *
  * OUTPUT:  none
  */
-void printSectionHeaders(struct sectionNode *startSecLL) {
-
-   struct sectionNode *node = startSecLL;
-   union sectionHeader_union *secHeader;
-
-   // Find the shstrndx header (end of LL)
-   while (node->next != NULL) {
-      node = node->next;
-   }
+void printSectionHeaders(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out) {
 
-   // Reset node variable
-   node = startSecLL;
+   int iter;
+   const char *typeName;
+   const struct sectionEntry *section;
+   const union sectionHeader_union *secHeader;
+   struct compressionHeader chdr;
 
    // Print formatting info
-   printf("\n");
-   printf("Section Headers:\n");
-   printf("  [Nr] Name\n");
+   writeText(out, "\n");
+   writeText(out, "Section Headers:\n");
+   writeText(out, "  [Nr] Name\n");
 
-   printf("       Type\t\tAddress\t\t  Offset\t    Link\n");
-   printf("       Size\t\tEntSize\t\t  Info\t\t    Align\n");
-   printf("       Flags\n");
+   writeText(out, "       Type\t\tAddress\t\t  Offset\t    Link\n");
+   writeText(out, "       Size\t\tEntSize\t\t  Info\t\t    Align\n");
+   writeText(out, "       Flags\n");
 
-   // Iterate over each node
-   while (node != NULL) {
+   // Iterate over each section
+   for (iter=0; iter < secTable->count; iter++) {
 
-      // Set union pointer to current node's union
-      secHeader = &(node->data);
+      // Set union pointer to current section's union
+      section   = &secTable->sections[iter];
+      secHeader = &(section->data);
 
       // === LINE ONE ===
 
       // Print header number
-      printf("  [%2d] ", node->index);
+      writeText(out, "  [");
+      writeSignedPadded(out, section->index, 2);
+      writeText(out, "] ");
 
       // Print sh_name 
-      printf("%s\n", node->name);
+      writeText(out, section->name);
+      writeChar(out, '\n');
 
       // === LINE TWO ===
-      printf("       ");
+      writeText(out, "       ");
 
-      // Print sh_type
-      switch(secHeader->Struct.sh_type) {
-         case 0:
-            printf("NULL\t\t");
-            break;
-         case 1:
-            printf("PROGBITS\t\t");
-            break;
-         case 2:
-            printf("SYMTAB\t\t");
-            break;
-         case 3:
-            printf("STRTAB\t\t");
-            break;
-         case 4:
-            printf("RELA\t\t");
-            break;
-         case 5:
-            printf("HASH\t\t");
-            break;
-         case 6:
-            printf("DYNAMIC\t\t");
-            break;
-         case 7:
-            printf("NOTE\t\t");
-            break;
-         default:
-            printf("???\t\t");
-      }
+      // Print sh_type, with one tab less for names that reach the next tab stop
+      typeName = sectionTypeName(secHeader->Struct.sh_type);
+      writeText(out, typeName);
+      writeText(out, (strlen(typeName) > 8) ? "\t" : "\t\t");
 
       // Print sh_addr
-      printf("%016lx  ", secHeader->Struct.sh_addr);
+      writeHex(out, secHeader->Struct.sh_addr, 16);
+      writeText(out, "  ");
 
       // Print sh_offset
-      printf("%016lx  ", secHeader->Struct.sh_offset);
+      writeHex(out, secHeader->Struct.sh_offset, 16);
+      writeText(out, "  ");
 
       // Print sh_link
-      printf("%d\n", secHeader->Struct.sh_link);
+      writeSigned(out, (int32_t)secHeader->Struct.sh_link);
+      writeChar(out, '\n');
 
       // === LINE THREE ===
-      printf("       ");
+      writeText(out, "       ");
 
       // Print sh_size
-      printf("%016lx ", secHeader->Struct.sh_size);
+      writeHex(out, secHeader->Struct.sh_size, 16);
+      writeChar(out, ' ');
 
       // Print sh_entsize
-      printf("%016lx  ", secHeader->Struct.sh_entsize);
+      writeHex(out, secHeader->Struct.sh_entsize, 16);
+      writeText(out, "  ");
 
       // Print sh_info
-      printf("%-16d  ", secHeader->Struct.sh_info);
+      writeSignedPadded(out, (int32_t)secHeader->Struct.sh_info, -16);
+      writeText(out, "  ");
 
       // Print sh_addralign
-      printf("%-16ld\n", secHeader->Struct.sh_addralign);
+      writeSignedPadded(out, (int64_t)secHeader->Struct.sh_addralign, -16);
+      writeChar(out, '\n');
 
       // === LINE FOUR ===
-      printf("       ");
+      writeText(out, "       ");
 
       // Print sh_flags
-      printf("[%016lx]", secHeader->Struct.sh_flags);
-      printf("\n");
+      writeChar(out, '[');
+      writeHex(out, secHeader->Struct.sh_flags, 16);
+      writeText(out, "]\n");
 
-      // Update node
-      node = node->next;
+      // === LINE FIVE ===
+      if ((secHeader->Struct.sh_flags & SHF_COMPRESSED) == 0) {
+         continue;
+      }
+      writeText(out, "       ");
+
+      // Print the compression type and both sizes
+      if (!readCompressionHeader(fileHeader, section, image, &chdr)) {
+         writeText(out, "[<corrupt compression header>]\n");
+         continue;
+      }
+      writeChar(out, '[');
+      writeText(out, compressionTypeName(chdr.type));
+      writeText(out, "] compressed ");
+      writeHex(out, secHeader->Struct.sh_size, 16);
+      writeText(out, " uncompressed ");
+      writeHex(out, chdr.size, 16);
+      writeText(out, " align ");
+      writeUnsigned(out, chdr.align);
+      writeChar(out, '\n');
+   }
+}
+
+/**
+ * A function that reads the compression header at the start of a
+ * section with SHF_COMPRESSED set.  The header's layout follows the
+ * file's class: Elf32_Chdr is 12 bytes and Elf64_Chdr is 24.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the compressed section
+ *          pointer to the image of the file
+ *          pointer to store the header in
+ *
+ * OUTPUT:  true if the header was read
+ *          false if it doesn't fit in the section or the file
+ */
+bool readCompressionHeader(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const struct fileImage *image, struct compressionHeader *chdr) {
+
+   int addrSize;
+   const unsigned char *raw;
+   const struct elfDecoder *decoder;
+
+   decoder   = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   addrSize  = (fileHeader->arr[4] == BIT32) ? 4 : 8;
+
+   // ch_type, then ch_reserved on 64bit, then ch_size and ch_addralign
+   chdr->headerSize = (addrSize == 4) ? 12 : 24;
+   if (section->data.Struct.sh_size < (uint64_t)chdr->headerSize) {
+      return false;
+   }
+   raw = imageAt(image, section->data.Struct.sh_offset, chdr->headerSize);
+   if (raw == NULL) {
+      return false;
    }
+
+   chdr->type  = decoder->decodeWord(raw);
+   chdr->size  = decoder->decodeAddress(raw + chdr->headerSize - 2 * addrSize);
+   chdr->align = decoder->decodeAddress(raw + chdr->headerSize - addrSize);
+
+   return true;
 }
 
+/**
+ * A utility function that names a compression type.
+ *
+ * INPUT:   ch_type value
+ *
+ * OUTPUT:  name of the compression type
+ */
+const char *compressionTypeName(uint32_t type) {
+
+   switch(type) {
+      case ELFCOMPRESS_ZLIB:
+         return "ZLIB";
+      case ELFCOMPRESS_ZSTD:
+         return "ZSTD";
+      default:
+         return "<unknown>";
+   }
+}
+
+/**
+ * A utility function that names a section type for the section
+ * header printer.
+ *
+ * INPUT:   sh_type value
+ *
+ * OUTPUT:  name of the section type
+ */
+const char *sectionTypeName(uint32_t type) {
+
+   switch(type) {
+      case 0:
+         return "NULL";
+      case 1:
+         return "PROGBITS";
+      case 2:
+         return "SYMTAB";
+      case 3:
+         return "STRTAB";
+      case 4:
+         return "RELA";
+      case 5:
+         return "HASH";
+      case 6:
+         return "DYNAMIC";
+      case 7:
+         return "NOTE";
+      case 8:
+         return "NOBITS";
+      case 9:
+         return "REL";
+      case 10:
+         return "SHLIB";
+      case 11:
+         return "DYNSYM";
+      case 14:
+         return "INIT_ARRAY";
+      case 15:
+         return "FINI_ARRAY";
+      case 16:
+         return "PREINIT_ARRAY";
+      case 17:
+         return "GROUP";
+      case 18:
+         return "SYMTAB_SHNDX";
+      case 19:
+         return "RELR";
+      case 0x6ffffff6:
+         return "GNU_HASH";
+      case 0x6fffffff:
+         return "VERSYM";
+      default:
+         return "???";
+   }
+}
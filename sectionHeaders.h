@@ -14,22 +14,35 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 
 #include "customDataTypes.h"
 
 // Local Prototypes
-void readSectionHeaders(union fileHeader_union *fileHeader, struct sectionNode **startSecLL, FILE *file);
-void readSectionNames(struct sectionNode *startSecLL, FILE *file);
-void sectionHeader32to64(union sectionHeader_union *secHeader);
-void sectionHeaderEndianSwap(union sectionHeader_union *secHeader);
-void printSectionInfo(const union fileHeader_union *fileHeader);
-void printSectionHeaders(struct sectionNode *startSecLL);
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+bool readExtendedCount(const union fileHeader_union *fileHeader, const struct fileImage *image, const struct elfDecoder *decoder, uint64_t *count);
+void readSectionNames(const union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+uint32_t sectionNameIndex(const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+uint32_t sectionCount(const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+bool buildSectionIndex(struct sectionTable *secTable);
+int findSection(const struct sectionTable *secTable, const char *secName);
+int findSectionByType(const struct sectionTable *secTable, uint32_t type, int start);
+void printSectionInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+void printSectionHeaders(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+bool readCompressionHeader(const union fileHeader_union *fileHeader, const struct sectionEntry *section, const struct fileImage *image, struct compressionHeader *chdr);
+const char *compressionTypeName(uint32_t type);
+const char *sectionTypeName(uint32_t type);
 
 // Other Prototyptes
-bool checkSameEndian(const int programEndian);
-uint16_t endianSwap16Bit(const uint16_t input);
-uint32_t endianSwap32Bit(const uint32_t input);
-uint64_t endianSwap64Bit(const uint64_t input);
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+uint32_t hashName(const char *name);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+void writeSignedPadded(struct outputBuffer *buffer, int64_t value, int width);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
 
 // Defines
 #define BIT32 1
@@ -37,3 +50,9 @@ uint64_t endianSwap64Bit(const uint64_t input);
 #define ENDIAN_LITTLE 1
 #define ENDIAN_BIG 2
 
+#define SHN_XINDEX 0xffff
+
+#define SHF_COMPRESSED 0x800
+#define ELFCOMPRESS_ZLIB 1
+#define ELFCOMPRESS_ZSTD 2
+
@@ -0,0 +1,349 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file serializer.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "serializer.h"
+
+/**
+ * A function that writes one file's header, sections and hex dumps in
+ * a structured format for other programs to read.  Everything goes
+ * through the file's output buffer, which is flushed as it fills, so
+ * memory use does not grow with the size or number of files.
+ *
+ * INPUT:   name of the file
+ *          pointer to the fileHeader
+ *          pointer to the section table
+ *          true to include the section headers
+ *          array of hex dump slices, one per section (NULL for none)
+ *          pointer to the image of the file
+ *          OUTPUT_JSON or OUTPUT_BIN
+ *          output buffer to write to
+ *
+ * OUTPUT:  none
+ */
+void serializeFile(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, bool sections,
+                   const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image, int format, struct outputBuffer *out) {
+
+   if (format == OUTPUT_JSON) {
+      serializeJson(out, fileName, fileHeader, secTable, sections, hexDumpSlices, image);
+   } else {
+      serializeBinary(out, fileName, fileHeader, secTable, sections, hexDumpSlices, image);
+   }
+}
+
+/**
+ * A function that writes a file as one JSON object on a single line,
+ * so a run over many files gives one object per line.  Hex dump bytes
+ * are written as a string of hex digit pairs.
+ *
+ * INPUT:   pointer to the output buffer
+ *          the rest as for serializeFile
+ *
+ * OUTPUT:  none
+ */
+void serializeJson(struct outputBuffer *buffer, const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable,
+                   bool sections, const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image) {
+
+   int iter;
+   int status;
+   bool first;
+   uint64_t start;
+   uint64_t length;
+   const struct sectionEntry *section;
+   const union sectionHeader_union *secHeader;
+
+   // === FILE HEADER ===
+   writeText(buffer, "{\"file\":");
+   writeJsonString(buffer, fileName);
+
+   writeText(buffer, ",\"header\":{\"class\":");
+   writeUnsigned(buffer, fileHeader->arr[4]);
+   writeJsonField(buffer, "data",       fileHeader->arr[5]);
+   writeJsonField(buffer, "version",    fileHeader->arr[6]);
+   writeJsonField(buffer, "osabi",      fileHeader->arr[7]);
+   writeJsonField(buffer, "abiversion", fileHeader->arr[8]);
+   writeJsonField(buffer, "type",       fileHeader->Struct.e_type);
+   writeJsonField(buffer, "machine",    fileHeader->Struct.e_machine);
+   writeJsonField(buffer, "e_version",  fileHeader->Struct.e_version);
+   writeJsonField(buffer, "entry",      fileHeader->Struct.e_entry);
+   writeJsonField(buffer, "phoff",      fileHeader->Struct.e_phoff);
+   writeJsonField(buffer, "shoff",      fileHeader->Struct.e_shoff);
+   writeJsonField(buffer, "flags",      fileHeader->Struct.e_flags);
+   writeJsonField(buffer, "ehsize",     fileHeader->Struct.e_ehsize);
+   writeJsonField(buffer, "phentsize",  fileHeader->Struct.e_phentsize);
+   writeJsonField(buffer, "phnum",      fileHeader->Struct.e_phnum);
+   writeJsonField(buffer, "shentsize",  fileHeader->Struct.e_shentsize);
+   writeJsonField(buffer, "shnum",      sectionCount(fileHeader, secTable));
+   writeJsonField(buffer, "shstrndx",   sectionNameIndex(fileHeader, secTable));
+   writeText(buffer, "}");
+
+   // === SECTION HEADERS ===
+   if (sections) {
+      writeText(buffer, ",\"sections\":[");
+      for (iter=0; iter < secTable->count; iter++) {
+
+         section   = &secTable->sections[iter];
+         secHeader = &section->data;
+
+         writeText(buffer, (iter == 0) ? "{\"index\":" : ",{\"index\":");
+         writeUnsigned(buffer, section->index);
+         writeText(buffer, ",\"name\":");
+         writeJsonString(buffer, section->name);
+         writeJsonField(buffer, "type",      secHeader->Struct.sh_type);
+         writeJsonField(buffer, "flags",     secHeader->Struct.sh_flags);
+         writeJsonField(buffer, "addr",      secHeader->Struct.sh_addr);
+         writeJsonField(buffer, "offset",    secHeader->Struct.sh_offset);
+         writeJsonField(buffer, "size",      secHeader->Struct.sh_size);
+         writeJsonField(buffer, "link",      secHeader->Struct.sh_link);
+         writeJsonField(buffer, "info",      secHeader->Struct.sh_info);
+         writeJsonField(buffer, "addralign", secHeader->Struct.sh_addralign);
+         writeJsonField(buffer, "entsize",   secHeader->Struct.sh_entsize);
+         writeText(buffer, "}");
+      }
+      writeText(buffer, "]");
+   }
+
+   // === HEX DUMPS ===
+   if (hexDumpSlices != NULL) {
+      writeText(buffer, ",\"hexdumps\":[");
+      first = true;
+      for (iter=0; iter < secTable->count; iter++) {
+
+         if (!hexDumpSlices[iter].selected) {
+            continue;
+         }
+
+         section = &secTable->sections[iter];
+         status  = resolveHexSlice(section, &hexDumpSlices[iter], image, &start, &length);
+
+         writeText(buffer, first ? "{\"section\":" : ",{\"section\":");
+         writeJsonString(buffer, section->name);
+         writeJsonField(buffer, "index",  iter);
+         writeJsonField(buffer, "offset", start);
+
+         // Say why a slice has no bytes
+         if (status != HEX_SLICE_OK) {
+            writeText(buffer, ",\"error\":");
+            writeJsonString(buffer, hexSliceError(status));
+         } else {
+            writeJsonField(buffer, "size", length);
+            writeText(buffer, ",\"data\":\"");
+            streamSectionBytes(buffer, image, section->data.Struct.sh_offset + start, length, true);
+            writeText(buffer, "\"");
+         }
+
+         writeText(buffer, "}");
+         first = false;
+      }
+      writeText(buffer, "]");
+   }
+
+   writeText(buffer, "}\n");
+}
+
+/**
+ * A function that writes a file as a run of length-prefixed records.
+ * Each record is a little endian u32 type and u64 payload length,
+ * followed by the payload, so a reader can skip records it doesn't
+ * know.  The records are laid out in README.md.
+ *
+ * INPUT:   pointer to the output buffer
+ *          the rest as for serializeFile
+ *
+ * OUTPUT:  none
+ */
+void serializeBinary(struct outputBuffer *buffer, const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable,
+                     bool sections, const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image) {
+
+   int iter;
+   int status;
+   size_t size;
+   uint64_t start;
+   uint64_t length;
+   const char *message;
+   const struct sectionEntry *section;
+   const union sectionHeader_union *secHeader;
+
+   // === FILE BEGIN ===
+   size = strlen(fileName);
+   writeRecord(buffer, RECORD_FILE_BEGIN, 4 + size);
+   writeLE32(buffer, SERIAL_VERSION);
+   writeBytes(buffer, fileName, size);
+
+   // === FILE HEADER ===
+   writeRecord(buffer, RECORD_HEADER, RECORD_HEADER_SIZE);
+   writeBytes(buffer, fileHeader->arr, 16);
+   writeLE16(buffer, fileHeader->Struct.e_type);
+   writeLE16(buffer, fileHeader->Struct.e_machine);
+   writeLE32(buffer, fileHeader->Struct.e_version);
+   writeLE64(buffer, fileHeader->Struct.e_entry);
+   writeLE64(buffer, fileHeader->Struct.e_phoff);
+   writeLE64(buffer, fileHeader->Struct.e_shoff);
+   writeLE32(buffer, fileHeader->Struct.e_flags);
+   writeLE16(buffer, fileHeader->Struct.e_ehsize);
+   writeLE16(buffer, fileHeader->Struct.e_phentsize);
+   writeLE16(buffer, fileHeader->Struct.e_phnum);
+   writeLE16(buffer, fileHeader->Struct.e_shentsize);
+   writeLE32(buffer, sectionCount(fileHeader, secTable));
+   writeLE32(buffer, sectionNameIndex(fileHeader, secTable));
+
+   // === SECTION HEADERS ===
+   for (iter=0; sections && iter < secTable->count; iter++) {
+
+      section   = &secTable->sections[iter];
+      secHeader = &section->data;
+      size      = strlen(section->name);
+
+      writeRecord(buffer, RECORD_SECTION, RECORD_SECTION_SIZE + size);
+      writeLE32(buffer, section->index);
+      writeLE32(buffer, secHeader->Struct.sh_name);
+      writeLE32(buffer, secHeader->Struct.sh_type);
+      writeLE32(buffer, secHeader->Struct.sh_link);
+      writeLE32(buffer, secHeader->Struct.sh_info);
+      writeLE64(buffer, secHeader->Struct.sh_flags);
+      writeLE64(buffer, secHeader->Struct.sh_addr);
+      writeLE64(buffer, secHeader->Struct.sh_offset);
+      writeLE64(buffer, secHeader->Struct.sh_size);
+      writeLE64(buffer, secHeader->Struct.sh_addralign);
+      writeLE64(buffer, secHeader->Struct.sh_entsize);
+      writeBytes(buffer, section->name, size);
+   }
+
+   // === HEX DUMPS ===
+   for (iter=0; hexDumpSlices != NULL && iter < secTable->count; iter++) {
+
+      if (!hexDumpSlices[iter].selected) {
+         continue;
+      }
+
+      section = &secTable->sections[iter];
+      status  = resolveHexSlice(section, &hexDumpSlices[iter], image, &start, &length);
+
+      // Say why a slice has no bytes
+      if (status != HEX_SLICE_OK) {
+         message = hexSliceError(status);
+         size    = strlen(message);
+         writeRecord(buffer, RECORD_ERROR, 16 + size);
+         writeLE32(buffer, iter);
+         writeLE32(buffer, status);
+         writeLE64(buffer, start);
+         writeBytes(buffer, message, size);
+         continue;
+      }
+
+      writeRecord(buffer, RECORD_HEXDUMP, 12 + length);
+      writeLE32(buffer, iter);
+      writeLE64(buffer, start);
+      streamSectionBytes(buffer, image, section->data.Struct.sh_offset + start, length, false);
+   }
+
+   // === FILE END ===
+   writeRecord(buffer, RECORD_FILE_END, 0);
+}
+
+/**
+ * A utility function that writes a JSON member holding a number,
+ * after the first member of an object.
+ *
+ * INPUT:   pointer to the output buffer
+ *          name of the member
+ *          the number
+ *
+ * OUTPUT:  none
+ */
+void writeJsonField(struct outputBuffer *buffer, const char *name, uint64_t value) {
+
+   writeText(buffer, ",\"");
+   writeText(buffer, name);
+   writeText(buffer, "\":");
+   writeUnsigned(buffer, value);
+}
+
+/**
+ * A utility function that writes the type and payload length that
+ * start a binary record.
+ *
+ * INPUT:   pointer to the output buffer
+ *          RECORD_* type
+ *          number of payload bytes that follow
+ *
+ * OUTPUT:  none
+ */
+void writeRecord(struct outputBuffer *buffer, uint32_t type, uint64_t length) {
+
+   writeLE32(buffer, type);
+   writeLE64(buffer, length);
+}
+
+/**
+ * A function that copies a range of the image to the output, as raw
+ * bytes or as hex digit pairs.  The range is streamed in chunks like
+ * the hex dump printer: the next chunk is read ahead, and each chunk
+ * is dropped once written, so large sections keep memory flat.
+ *
+ * INPUT:   pointer to the output buffer
+ *          pointer to the image of the file
+ *          offset of the first byte in the file
+ *          number of bytes
+ *          true to write hex digits, false for raw bytes
+ *
+ * OUTPUT:  none
+ */
+void streamSectionBytes(struct outputBuffer *buffer, const struct fileImage *image, uint64_t offset, uint64_t size, bool hex) {
+
+   uint64_t chunkStart;
+   uint64_t chunkSize;
+   const unsigned char *bytes = imageAt(image, offset, size);
+
+   imageAdvise(image, offset, size, MADV_SEQUENTIAL);
+
+   for (chunkStart=0; chunkStart < size; chunkStart += chunkSize) {
+
+      chunkSize = (size - chunkStart > SERIAL_CHUNK) ? SERIAL_CHUNK : size - chunkStart;
+
+      // Read the next chunk ahead
+      if (chunkStart + chunkSize < size) {
+         imageAdvise(image, offset + chunkStart + chunkSize,
+                     (size - chunkStart - chunkSize > SERIAL_CHUNK) ? SERIAL_CHUNK : size - chunkStart - chunkSize, MADV_WILLNEED);
+      }
+
+      if (hex) {
+         writeHexBytes(buffer, bytes + chunkStart, chunkSize);
+      } else {
+         writeBytes(buffer, bytes + chunkStart, chunkSize);
+      }
+
+      // Drop the chunk now it has been written
+      imageAdvise(image, offset + chunkStart, chunkSize, MADV_DONTNEED);
+   }
+}
+
+/**
+ * A utility function that describes why a hex dump slice has no
+ * bytes, matching the text printer's messages.
+ *
+ * INPUT:   HEX_SLICE_* status
+ *
+ * OUTPUT:  description of the status
+ */
+const char *hexSliceError(int status) {
+
+   switch(status) {
+      case HEX_SLICE_EMPTY:
+         return "section has no data";
+      case HEX_SLICE_OFFSET:
+         return "offset is past the end of the section";
+      case HEX_SLICE_TRUNCATED:
+         return "section extends past the end of the file";
+      default:
+         return "unknown error";
+   }
+}
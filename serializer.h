@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file serializer.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+void serializeFile(const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable, bool sections,
+                   const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image, int format, struct outputBuffer *out);
+void serializeJson(struct outputBuffer *buffer, const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable,
+                   bool sections, const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image);
+void serializeBinary(struct outputBuffer *buffer, const char *fileName, const union fileHeader_union *fileHeader, const struct sectionTable *secTable,
+                     bool sections, const struct hexDumpSlice *hexDumpSlices, const struct fileImage *image);
+void writeJsonField(struct outputBuffer *buffer, const char *name, uint64_t value);
+void writeRecord(struct outputBuffer *buffer, uint32_t type, uint64_t length);
+void streamSectionBytes(struct outputBuffer *buffer, const struct fileImage *image, uint64_t offset, uint64_t size, bool hex);
+const char *hexSliceError(int status);
+
+// Other Prototypes
+uint32_t sectionCount(const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+uint32_t sectionNameIndex(const union fileHeader_union *fileHeader, const struct sectionTable *secTable);
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeHexBytes(struct outputBuffer *buffer, const unsigned char *bytes, size_t size);
+void writeJsonString(struct outputBuffer *buffer, const char *text);
+void writeLE16(struct outputBuffer *buffer, uint16_t value);
+void writeLE32(struct outputBuffer *buffer, uint32_t value);
+void writeLE64(struct outputBuffer *buffer, uint64_t value);
+
+int resolveHexSlice(const struct sectionEntry *section, const struct hexDumpSlice *slice, const struct fileImage *image, uint64_t *start, uint64_t *length);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice);
+
+// Defines
+#define OUTPUT_TEXT 0
+#define OUTPUT_JSON 1
+#define OUTPUT_BIN  2
+
+#define HEX_SLICE_OK        0
+#define HEX_SLICE_EMPTY     1
+#define HEX_SLICE_OFFSET    2
+#define HEX_SLICE_TRUNCATED 3
+
+#define SERIAL_CHUNK (1 << 20)
+#define SERIAL_VERSION 2
+
+#define RECORD_FILE_BEGIN 1
+#define RECORD_HEADER     2
+#define RECORD_SECTION    3
+#define RECORD_HEXDUMP    4
+#define RECORD_ERROR      5
+#define RECORD_FILE_END   6
+
+#define RECORD_HEADER_SIZE  68
+#define RECORD_SECTION_SIZE 68
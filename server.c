@@ -0,0 +1,598 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file server.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "server.h"
+
+// The server's cache, shared by every connection
+static struct serverCache serverCache;
+
+/**
+ * A function that runs the query server.  It listens on a Unix domain
+ * socket and serves each connection on its own thread, up to
+ * SERVER_MAX_CLIENTS at once, so tools can ask about the same files
+ * over and over without starting a new process or parsing the files
+ * again.  Parsed files stay in an LRU cache bounded
+ * by --serve-memory.  Each request is one line and each reply is
+ * either "OK <length>" followed by that many bytes of the same text the
+ * command line options print, or a single "ERR <message>" line.  The
+ * requests are:
+ *
+ *    header <file>              as -h
+ *    sections <file>            as -t
+ *    symbols <file>             as -s
+ *    lookup <file> <name>       as --lookup-symbol
+ *    hex <file> <name>[@o+len]  as -x
+ *    stats                      cache counters
+ *    quit                       close the connection
+ *
+ * Any client that can connect may read every file the server can, so
+ * the socket is created with mode 0600 for the server's own user.
+ *
+ * INPUT:   path of the socket to listen on
+ *
+ * OUTPUT:  false if the socket couldn't be set up (it never returns otherwise)
+ */
+bool runServer(const char *socketPath) {
+
+   int listener;
+   int *client;
+   mode_t oldMask;
+   pthread_t thread;
+   struct sockaddr_un address;
+
+   // Set up the cache
+   serverCache.bucketCount = SERVER_BUCKETS;
+   serverCache.buckets     = calloc(SERVER_BUCKETS, sizeof(struct serverFile *));
+   serverCache.limit       = serverMemoryLimit;
+   if (serverCache.buckets == NULL) {
+      fprintf(stderr, "%s: Error: Out of memory\n", programName);
+      return false;
+   }
+   pthread_mutex_init(&serverCache.lock, NULL);
+   pthread_cond_init(&serverCache.clientLeft, NULL);
+
+   // Clients that hang up mid-reply shouldn't kill the server
+   signal(SIGPIPE, SIG_IGN);
+
+   // Listen on the socket, replacing a stale one
+   if (strlen(socketPath) >= sizeof(address.sun_path)) {
+      fprintf(stderr, "%s: %s: Error: Socket path is too long\n", programName, socketPath);
+      return false;
+   }
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strcpy(address.sun_path, socketPath);
+
+   if ( (listener = socket(AF_UNIX, SOCK_STREAM, 0)) == -1 ) {
+      fprintf(stderr, "%s: %s: Error: Cannot create socket\n", programName, socketPath);
+      return false;
+   }
+   unlink(socketPath);
+
+   // Only the server's user may connect
+   oldMask = umask(0177);
+   if (bind(listener, (struct sockaddr *)&address, sizeof(address)) == -1) {
+      umask(oldMask);
+      fprintf(stderr, "%s: %s: Error: Cannot listen on socket\n", programName, socketPath);
+      close(listener);
+      return false;
+   }
+   umask(oldMask);
+   if (listen(listener, SOMAXCONN) == -1) {
+      fprintf(stderr, "%s: %s: Error: Cannot listen on socket\n", programName, socketPath);
+      close(listener);
+      return false;
+   }
+
+   // Serve each connection on its own thread
+   while (true) {
+
+      // Wait for a free place before taking another connection
+      pthread_mutex_lock(&serverCache.lock);
+      while (serverCache.clients >= SERVER_MAX_CLIENTS) {
+         pthread_cond_wait(&serverCache.clientLeft, &serverCache.lock);
+      }
+      pthread_mutex_unlock(&serverCache.lock);
+
+      if ( (client = malloc(sizeof(int))) == NULL || (*client = accept(listener, NULL, NULL)) == -1 ) {
+
+         // Out of descriptors or memory won't clear at once, so don't spin on it
+         if (client == NULL || (errno != EINTR && errno != ECONNABORTED)) {
+            usleep(SERVER_ACCEPT_BACKOFF_US);
+         }
+         free(client);
+         continue;
+      }
+
+      // Only this thread adds clients, so the place is still free
+      pthread_mutex_lock(&serverCache.lock);
+      serverCache.clients++;
+      pthread_mutex_unlock(&serverCache.lock);
+
+      if (pthread_create(&thread, NULL, serveConnection, client) != 0) {
+         close(*client);
+         free(client);
+         leaveServer(&serverCache);
+         usleep(SERVER_ACCEPT_BACKOFF_US);
+         continue;
+      }
+      pthread_detach(thread);
+   }
+
+   return true;
+}
+
+/**
+ * The thread function for one connection.  It answers requests line by
+ * line until the client hangs up or sends quit.
+ *
+ * INPUT:   pointer to the connection's socket (freed here)
+ *
+ * OUTPUT:  NULL
+ */
+void *serveConnection(void *arg) {
+
+   int fd = *(int *)arg;
+   size_t capacity = 0;
+   ssize_t length;
+   char *line = NULL;
+
+   FILE *in;
+   FILE *reply;
+
+   free(arg);
+
+   in    = fdopen(fd, "r");
+   reply = fdopen(dup(fd), "w");
+   if (in == NULL || reply == NULL) {
+      if (in != NULL) {
+         fclose(in);
+      } else {
+         close(fd);
+      }
+      if (reply != NULL) {
+         fclose(reply);
+      }
+      leaveServer(&serverCache);
+      return NULL;
+   }
+
+   while ( (length = getline(&line, &capacity, in)) != -1 ) {
+
+      // Strip the line ending
+      while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+         line[--length] = '\0';
+      }
+
+      if (strcmp(line, "quit") == 0) {
+         break;
+      }
+
+      answerRequest(&serverCache, line, reply);
+      if (fflush(reply) != 0) {
+         break;
+      }
+   }
+
+   free(line);
+   fclose(reply);
+   fclose(in);
+
+   leaveServer(&serverCache);
+
+   return NULL;
+}
+
+/**
+ * A utility function that gives up a client's place, letting the
+ * server accept another connection.
+ *
+ * INPUT:   pointer to the cache
+ *
+ * OUTPUT:  none
+ */
+void leaveServer(struct serverCache *cache) {
+
+   pthread_mutex_lock(&cache->lock);
+   cache->clients--;
+   pthread_cond_signal(&cache->clientLeft);
+   pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * A function that answers one request line.  The command is run once
+ * to count its output, so the reply can start with its length, then
+ * again straight into the reply stream.  No reply is held in memory,
+ * so replies don't need room beyond the --serve-memory budget.
+ *
+ * INPUT:   pointer to the cache
+ *          the request, which is split up in place
+ *          stream to the client
+ *
+ * OUTPUT:  none
+ */
+void answerRequest(struct serverCache *cache, char *request, FILE *reply) {
+
+   bool answered;
+   char *command;
+   char *fileName;
+   char *argument;
+   char *text = NULL;
+   size_t textSize = 0;
+   uint64_t length;
+   const char *error = NULL;
+
+   FILE *out;
+   struct outputBuffer buffer;
+   struct serverFile *file;
+
+   command  = strtok(request, " \t");
+   fileName = strtok(NULL, " \t");
+   argument = strtok(NULL, " \t");
+
+   __atomic_fetch_add(&cache->requests, 1, __ATOMIC_RELAXED);
+
+   if (command == NULL) {
+      fprintf(reply, "ERR Empty request\n");
+      return;
+   }
+
+   // Report the cache counters
+   if (strcmp(command, "stats") == 0) {
+      pthread_mutex_lock(&cache->lock);
+      out = open_memstream(&text, &textSize);
+      fprintf(out, "requests %lu\nclients %d\nfiles %d\nmemory %lu\nlimit %lu\nhits %lu\nmisses %lu\nevicted %lu\n",
+            cache->requests, cache->clients, cache->count, cache->memory, cache->limit, cache->hits, cache->misses, cache->evicted);
+      pthread_mutex_unlock(&cache->lock);
+      fclose(out);
+      fprintf(reply, "OK %zu\n", textSize);
+      fwrite(text, 1, textSize, reply);
+      free(text);
+      return;
+   }
+
+   if (fileName == NULL) {
+      fprintf(reply, "ERR Missing file name\n");
+      return;
+   }
+
+   // Get the parsed file, then run the command on it
+   if ( (file = acquireServerFile(cache, fileName, &error)) == NULL ) {
+      fprintf(reply, "ERR %s\n", error);
+      return;
+   }
+
+   // Count the output, then send it
+   if (!openOutputBuffer(&buffer, NULL)) {
+      releaseServerFile(cache, file);
+      fprintf(reply, "ERR Out of memory\n");
+      return;
+   }
+   answered = runQuery(file, command, argument, &buffer, &error);
+   closeOutputBuffer(&buffer);
+   length = buffer.written;
+
+   if (!answered) {
+      fprintf(reply, "ERR %s\n", error);
+   } else if (!openOutputBuffer(&buffer, reply)) {
+      fprintf(reply, "ERR Out of memory\n");
+   } else {
+      fprintf(reply, "OK %lu\n", length);
+      runQuery(file, command, argument, &buffer, &error);
+      closeOutputBuffer(&buffer);
+   }
+
+   releaseServerFile(cache, file);
+}
+
+/**
+ * A function that runs one query on a parsed file, printing what the
+ * matching command line option prints.
+ *
+ * INPUT:   pointer to the parsed file
+ *          the command
+ *          the command's argument, or NULL
+ *          output buffer to print to
+ *          pointer to store an error message
+ *
+ * OUTPUT:  true if the query was answered
+ *          false with an error message otherwise
+ */
+bool runQuery(struct serverFile *file, const char *command, const char *argument, struct outputBuffer *out, const char **error) {
+
+   struct hexDumpSlice *hexDumpSlices;
+
+   if (strcmp(command, "header") == 0) {
+      printFileHeader(&file->fileHeader, &file->secTable, out);
+      return true;
+   }
+   if (strcmp(command, "sections") == 0) {
+      printSectionInfo(&file->fileHeader, &file->secTable, out);
+      printSectionHeaders(&file->fileHeader, &file->secTable, &file->image, out);
+      return true;
+   }
+   if (strcmp(command, "symbols") == 0) {
+      printSymbolTables(&file->fileHeader, &file->secTable, &file->image, out);
+      return true;
+   }
+
+   // The remaining commands need an argument
+   if (strcmp(command, "lookup") != 0 && strcmp(command, "hex") != 0) {
+      *error = "Unknown request";
+      return false;
+   }
+   if (argument == NULL) {
+      *error = "Missing argument";
+      return false;
+   }
+
+   if (strcmp(command, "lookup") == 0) {
+      printSymbolLookup(&file->fileHeader, &file->secTable, &file->image, argument, out);
+      return true;
+   }
+
+   // Dump one section, or a slice of it
+   if ( (hexDumpSlices = calloc(file->secTable.count + 1, sizeof(struct hexDumpSlice))) == NULL ) {
+      *error = "Out of memory";
+      return false;
+   }
+   if (!findNode(&file->secTable, argument, hexDumpSlices)) {
+      free(hexDumpSlices);
+      *error = "No such section";
+      return false;
+   }
+   printHexDump(&file->secTable, &file->image, hexDumpSlices, out);
+   free(hexDumpSlices);
+
+   return true;
+}
+
+/**
+ * A function that returns a parsed file from the cache, parsing it if
+ * it isn't there or has changed on disk since (by device, inode, size
+ * and modification time).  The file is parsed outside the lock so one
+ * slow file doesn't hold up other requests.  Adding a file evicts the
+ * least recently used ones until the cache fits its memory limit.
+ * Files in use are only unlinked; the last request using them frees
+ * them.
+ *
+ * INPUT:   pointer to the cache
+ *          path of the file
+ *          pointer to store an error message
+ *
+ * OUTPUT:  pointer to the parsed file, to be released after use
+ *          NULL with an error message if it couldn't be parsed
+ */
+struct serverFile *acquireServerFile(struct serverCache *cache, const char *path, const char **error) {
+
+   uint32_t bucket;
+   struct stat info;
+   struct serverFile *file;
+   struct serverFile *loaded;
+
+   if (stat(path, &info) != 0) {
+      *error = "No such file";
+      return NULL;
+   }
+
+   bucket = hashName(path) & (cache->bucketCount - 1);
+
+   // Look for a current copy
+   pthread_mutex_lock(&cache->lock);
+   for (file = cache->buckets[bucket]; file != NULL && strcmp(file->path, path) != 0; file = file->hashNext);
+
+   if (file != NULL && file->device == (uint64_t)info.st_dev && file->inode == (uint64_t)info.st_ino &&
+       file->size == (uint64_t)info.st_size && file->mtimeSec == info.st_mtim.tv_sec && file->mtimeNsec == info.st_mtim.tv_nsec) {
+
+      // Move it to the front of the LRU list
+      if (file != cache->head) {
+         file->prev->next = file->next;
+         if (file->next != NULL) {
+            file->next->prev = file->prev;
+         } else {
+            cache->tail = file->prev;
+         }
+         file->prev = NULL;
+         file->next = cache->head;
+         cache->head->prev = file;
+         cache->head = file;
+      }
+      file->users++;
+      cache->hits++;
+      pthread_mutex_unlock(&cache->lock);
+      return file;
+   }
+
+   // Drop a copy that has gone stale
+   if (file != NULL) {
+      unlinkServerFile(cache, file);
+   }
+   cache->misses++;
+   pthread_mutex_unlock(&cache->lock);
+
+   // Parse the file
+   if ( (loaded = loadServerFile(path, &info, error)) == NULL ) {
+      return NULL;
+   }
+
+   pthread_mutex_lock(&cache->lock);
+
+   // Another request may have parsed it meanwhile; replace that copy
+   for (file = cache->buckets[bucket]; file != NULL && strcmp(file->path, path) != 0; file = file->hashNext);
+   if (file != NULL) {
+      unlinkServerFile(cache, file);
+   }
+
+   // Add it to the front
+   loaded->users    = 1;
+   loaded->cached   = true;
+   loaded->hashNext = cache->buckets[bucket];
+   loaded->next     = cache->head;
+   cache->buckets[bucket] = loaded;
+   if (cache->head != NULL) {
+      cache->head->prev = loaded;
+   } else {
+      cache->tail = loaded;
+   }
+   cache->head    = loaded;
+   cache->memory += loaded->memory;
+   cache->count++;
+
+   // Evict from the back until it fits, always keeping this file
+   while (cache->memory > cache->limit && cache->tail != loaded) {
+      unlinkServerFile(cache, cache->tail);
+      cache->evicted++;
+   }
+
+   pthread_mutex_unlock(&cache->lock);
+
+   return loaded;
+}
+
+/**
+ * A function that hands a file back after a request, freeing it if it
+ * left the cache while in use.
+ *
+ * INPUT:   pointer to the cache
+ *          pointer to the file
+ *
+ * OUTPUT:  none
+ */
+void releaseServerFile(struct serverCache *cache, struct serverFile *file) {
+
+   bool unused;
+
+   pthread_mutex_lock(&cache->lock);
+   file->users--;
+   unused = (file->users == 0 && !file->cached);
+   pthread_mutex_unlock(&cache->lock);
+
+   if (unused) {
+      freeServerFile(file);
+   }
+}
+
+/**
+ * A function that opens and parses a file for the server: its image,
+ * ELF header and section table.
+ *
+ * INPUT:   path of the file
+ *          the file's stat, kept to spot changes
+ *          pointer to store an error message
+ *
+ * OUTPUT:  pointer to the parsed file
+ *          NULL with an error message if it couldn't be parsed
+ */
+struct serverFile *loadServerFile(const char *path, const struct stat *info, const char **error) {
+
+   struct serverFile *file = calloc(1, sizeof(struct serverFile));
+
+   if (file == NULL) {
+      *error = "Out of memory";
+      return NULL;
+   }
+   if (!openFileImage(path, &file->image)) {
+      free(file);
+      *error = "No such file";
+      return NULL;
+   }
+   if (!readFileHeader(&file->fileHeader, &file->image)) {
+      closeFileImage(&file->image);
+      free(file);
+      *error = "Not an ELF file - it has the wrong magic bytes at the start";
+      return NULL;
+   }
+   if (!readSectionHeaders(&file->fileHeader, &file->secTable, &file->image)) {
+      freeSectionTable(&file->secTable);
+      closeFileImage(&file->image);
+      free(file);
+      *error = "The section header table is truncated or corrupt";
+      return NULL;
+   }
+
+   if ( (file->path = strdup(path)) == NULL ) {
+      freeSectionTable(&file->secTable);
+      closeFileImage(&file->image);
+      free(file);
+      *error = "Out of memory";
+      return NULL;
+   }
+   file->device    = info->st_dev;
+   file->inode     = info->st_ino;
+   file->size      = info->st_size;
+   file->mtimeSec  = info->st_mtim.tv_sec;
+   file->mtimeNsec = info->st_mtim.tv_nsec;
+
+   // The image counts in full, since queries may touch any of it
+   file->memory = sizeof(struct serverFile) + file->image.size +
+                  file->secTable.count * sizeof(struct sectionEntry) +
+                  file->secTable.bucketCount * sizeof(int);
+
+   return file;
+}
+
+/**
+ * A utility function that takes a file out of the cache's hash chain
+ * and LRU list.  It is freed now if no request is using it, otherwise
+ * by the last request to release it.  The lock must be held.
+ *
+ * INPUT:   pointer to the cache
+ *          pointer to the file
+ *
+ * OUTPUT:  none
+ */
+void unlinkServerFile(struct serverCache *cache, struct serverFile *file) {
+
+   struct serverFile **link;
+
+   // Out of the hash chain
+   link = &cache->buckets[hashName(file->path) & (cache->bucketCount - 1)];
+   while (*link != file) {
+      link = &(*link)->hashNext;
+   }
+   *link = file->hashNext;
+
+   // Out of the LRU list
+   if (file->prev != NULL) {
+      file->prev->next = file->next;
+   } else {
+      cache->head = file->next;
+   }
+   if (file->next != NULL) {
+      file->next->prev = file->prev;
+   } else {
+      cache->tail = file->prev;
+   }
+
+   cache->memory -= file->memory;
+   cache->count--;
+   file->cached = false;
+
+   if (file->users == 0) {
+      freeServerFile(file);
+   }
+}
+
+/**
+ * A utility function that frees a parsed file.
+ *
+ * INPUT:   pointer to the file
+ *
+ * OUTPUT:  none
+ */
+void freeServerFile(struct serverFile *file) {
+
+   freeSectionTable(&file->secTable);
+   closeFileImage(&file->image);
+   free(file->path);
+   free(file);
+}
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file server.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern char *programName;
+extern uint64_t serverMemoryLimit;
+
+// Local Prototypes
+bool runServer(const char *socketPath);
+void *serveConnection(void *arg);
+void leaveServer(struct serverCache *cache);
+void answerRequest(struct serverCache *cache, char *request, FILE *reply);
+bool runQuery(struct serverFile *file, const char *command, const char *argument, struct outputBuffer *out, const char **error);
+struct serverFile *acquireServerFile(struct serverCache *cache, const char *path, const char **error);
+void releaseServerFile(struct serverCache *cache, struct serverFile *file);
+struct serverFile *loadServerFile(const char *path, const struct stat *info, const char **error);
+void unlinkServerFile(struct serverCache *cache, struct serverFile *file);
+void freeServerFile(struct serverFile *file);
+
+// Other Prototypes
+bool openFileImage(const char *fileName, struct fileImage *image);
+void closeFileImage(struct fileImage *image);
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+void printFileHeader(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void printSectionInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, struct outputBuffer *out);
+void printSectionHeaders(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+void printSymbolTables(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+void printSymbolLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *symName, struct outputBuffer *out);
+bool findNode(const struct sectionTable *secTable, const char *secName, struct hexDumpSlice *hexDumpSlices);
+void printHexDump(const struct sectionTable *secTable, const struct fileImage *image, struct hexDumpSlice *hexDumpSlices, struct outputBuffer *out);
+void freeSectionTable(struct sectionTable *secTable);
+uint32_t hashName(const char *name);
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out);
+void closeOutputBuffer(struct outputBuffer *buffer);
+
+// Defines
+#define SERVER_BUCKETS 4096
+#define SERVER_DEFAULT_MEMORY_MB 512
+#define SERVER_MAX_CLIENTS 64
+#define SERVER_ACCEPT_BACKOFF_US 100000
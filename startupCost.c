@@ -0,0 +1,467 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file startupCost.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "startupCost.h"
+
+/**
+ * A function that estimates how much work the dynamic loader does to
+ * start a file, and prints a report of it.  The report is built from
+ * the dynamic section, the loaded relocation sections, the dynamic
+ * symbol and hash sections and the RELRO segment, and ends with one
+ * cost figure that can be used to rank files against each other.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printStartupCost(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out) {
+
+   int index;
+   uint32_t type;
+   const char *typeName;
+
+   struct startupCost cost = {0};
+
+   writeText(out, "\n");
+   writeText(out, "Startup cost report:\n");
+
+   // Read the dynamic section, printing the needed libraries
+   if (!readDynamicInfo(fileHeader, secTable, image, &cost, out)) {
+      writeText(out, "  This file is not dynamically linked.\n");
+      return;
+   }
+
+   // Find the hash section used for symbol lookups
+   cost.hashName = "none";
+   if ( (index = findSectionByType(secTable, SHT_GNU_HASH, 0)) != -1 ||
+        (index = findSectionByType(secTable, SHT_HASH, 0)) != -1 ) {
+      cost.hashName = secTable->sections[index].name;
+   }
+
+   // Count the dynamic symbols
+   if ( (index = findSectionByType(secTable, SHT_DYNSYM, 0)) != -1 &&
+        secTable->sections[index].data.Struct.sh_entsize != 0 ) {
+      cost.dynsymCount = secTable->sections[index].data.Struct.sh_size /
+                         secTable->sections[index].data.Struct.sh_entsize;
+   }
+
+   countLoadRelocations(fileHeader, secTable, image, &cost);
+   countRelrRelocations(fileHeader, secTable, image, &cost);
+   countRelroSize(fileHeader, image, &cost);
+
+   // Print the report
+   printCostLabel(out, "Binding:", false);
+   writeText(out, cost.bindNow ? "immediate (BIND_NOW)\n" : "lazy\n");
+   printCostLabel(out, "Hash section:", false);
+   writeText(out, cost.hashName);
+   writeChar(out, '\n');
+   printCostLine(out, "Dynamic symbols:", cost.dynsymCount, false);
+   printCostLine(out, "Load-time relocations:", cost.relocCount, false);
+
+   for (type=0; type < STARTUP_DIRECT_TYPES; type++) {
+      if (cost.typeCounts[type] != 0) {
+         typeName = relocationTypeName(fileHeader->Struct.e_machine, type);
+         if (typeName == NULL) {
+            writeText(out, "    unrecognized: ");
+            writeHexPadded(out, type, -12);
+            writeChar(out, ' ');
+            writeUnsigned(out, cost.typeCounts[type]);
+            writeChar(out, '\n');
+         } else {
+            printCostLine(out, typeName, cost.typeCounts[type], true);
+         }
+      }
+   }
+   if (cost.relrCount != 0) {
+      printCostLine(out, "RELR (packed relative)", cost.relrCount, true);
+   }
+   if (cost.otherTypes != 0) {
+      printCostLine(out, "other types", cost.otherTypes, true);
+   }
+
+   printCostLine(out, "Relative relocations:", cost.relativeCount, false);
+   printCostLine(out, "Symbolic relocations:", cost.symbolicCount, false);
+   printCostLabel(out, "PLT relocations:", false);
+   writeUnsigned(out, cost.pltCount);
+   writeText(out, cost.bindNow ? " (bound at load)\n" : " (bound on first call)\n");
+   printCostLine(out, "Symbol lookups at load:", cost.lookupCount, false);
+   printCostLabel(out, "RELRO data:", false);
+   writeText(out, "0x");
+   writeHex(out, cost.relroSize, 1);
+   writeText(out, " bytes (");
+   writeUnsigned(out, (cost.relroSize + STARTUP_PAGE_SIZE - 1) / STARTUP_PAGE_SIZE);
+   writeText(out, " pages)\n");
+   printCostLine(out, "Estimated startup cost:", estimateStartupCost(&cost), false);
+}
+
+/**
+ * Utility functions that print a line of the startup cost report: a
+ * label in a fixed-width column, then its count.  Nested lines break a
+ * count down and are indented further, keeping the counts aligned.
+ *
+ * INPUT:   output buffer to print to
+ *          the label
+ *          the count (printCostLine only)
+ *          true for a nested line
+ *
+ * OUTPUT:  none
+ */
+void printCostLine(struct outputBuffer *out, const char *label, uint64_t value, bool nested) {
+
+   printCostLabel(out, label, nested);
+   writeUnsigned(out, value);
+   writeChar(out, '\n');
+}
+
+void printCostLabel(struct outputBuffer *out, const char *label, bool nested) {
+
+   writeText(out, nested ? "    " : "  ");
+   writeTextPadded(out, label, nested ? -28 : -30);
+   writeChar(out, ' ');
+}
+
+/**
+ * A function that reads the dynamic section: the libraries the file
+ * needs (printed as they are found) and whether symbols are bound when
+ * the file is loaded rather than on first use.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          pointer to the report to fill in
+ *          output buffer to print to
+ *
+ * OUTPUT:  true if the file has a dynamic section
+ *          false otherwise
+ */
+bool readDynamicInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost, struct outputBuffer *out) {
+
+   int index;
+   int entSize;
+   uint64_t iter;
+   uint64_t count;
+   uint64_t strtabSize;
+
+   const char *strtab;
+   const unsigned char *table;
+   const struct sectionEntry *section;
+   const struct elfDecoder *decoder;
+
+   union dynamic_union *entries;
+   struct dynamic_struct64 *entry;
+
+   // Locate the dynamic section
+   if ( (index = findSectionByType(secTable, SHT_DYNAMIC, 0)) == -1 ) {
+      return false;
+   }
+   section = &secTable->sections[index];
+
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   entSize = section->data.Struct.sh_entsize;
+   if (entSize < decoder->dynamicSize) {
+      return false;
+   }
+   count = section->data.Struct.sh_size / entSize;
+   table = imageAt(image, section->data.Struct.sh_offset, count * entSize);
+   if (table == NULL) {
+      return false;
+   }
+   strtab = findStringTable(secTable, section, image, &strtabSize);
+
+   // Decode the whole section; it is always small
+   entries = malloc((count > 0 ? count : 1) * sizeof(union dynamic_union));
+   decoder->decodeDynamic(table, count, entSize, entries);
+
+   writeText(out, "  Needed libraries:\n");
+
+   // Iterate up to the DT_NULL entry
+   for (iter=0; iter < count && entries[iter].Struct.d_tag != DT_NULL; iter++) {
+
+      entry = &entries[iter].Struct;
+
+      switch(entry->d_tag) {
+         case DT_NEEDED:
+            cost->neededCount++;
+            if (strtab != NULL && entry->d_val < strtabSize &&
+                memchr(strtab + entry->d_val, '\0', strtabSize - entry->d_val) != NULL) {
+               writeText(out, "    ");
+               writeText(out, strtab + entry->d_val);
+               writeChar(out, '\n');
+            } else {
+               writeText(out, "    <corrupt>\n");
+            }
+            break;
+         case DT_BIND_NOW:
+            cost->bindNow = true;
+            break;
+         case DT_FLAGS:
+            cost->bindNow |= (entry->d_val & DF_BIND_NOW) != 0;
+            break;
+         case DT_FLAGS_1:
+            cost->bindNow |= (entry->d_val & DF_1_NOW) != 0;
+            break;
+      }
+   }
+
+   printCostLine(out, "Needed library count:", cost->neededCount, false);
+
+   free(entries);
+
+   return true;
+}
+
+/**
+ * A function that counts the relocations the loader applies: those in
+ * every loaded (SHF_ALLOC) REL and RELA section.  Each one is counted
+ * by type and by the kind of work it needs, and the distinct symbols
+ * that must be looked up at load time are marked in a bitmap so each
+ * symbol is only counted once.  There is one bitmap per symbol table,
+ * shared by every relocation section linked to it, so a symbol used by
+ * both .rela.dyn and .rela.plt is one lookup.  PLT relocations only
+ * need a lookup at load time when binding is immediate.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          pointer to the report to fill in
+ *
+ * OUTPUT:  none
+ */
+void countLoadRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost) {
+
+   int iter;
+   int chunkSize;
+   int entSize;
+   int kind;
+   bool rela;
+   uint64_t first;
+   uint64_t count;
+   uint64_t symCount;
+   uint64_t word;
+
+   const unsigned char *table;
+   const struct sectionEntry *section;
+   const struct sectionEntry *symSection;
+   const struct elfDecoder *decoder;
+   const struct relocationEntry *reloc;
+
+   struct relocationEntry *relocations;
+   uint64_t **lookups;
+   uint64_t *bitmap;
+
+   decoder     = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   relocations = malloc(RELOC_CHUNK * sizeof(struct relocationEntry));
+   lookups     = calloc(secTable->count > 0 ? secTable->count : 1, sizeof(uint64_t *));
+   if (relocations == NULL || lookups == NULL) {
+      free(relocations);
+      free(lookups);
+      return;
+   }
+
+   // Iterate over the loaded relocation sections
+   for (iter=0; iter < secTable->count; iter++) {
+
+      section = &secTable->sections[iter];
+
+      if ((section->data.Struct.sh_type != SHT_REL && section->data.Struct.sh_type != SHT_RELA) ||
+          (section->data.Struct.sh_flags & SHF_ALLOC) == 0) {
+         continue;
+      }
+
+      rela    = (section->data.Struct.sh_type == SHT_RELA);
+      entSize = section->data.Struct.sh_entsize;
+      if (entSize < (rela ? decoder->relaSize : decoder->relSize)) {
+         continue;
+      }
+      count = section->data.Struct.sh_size / entSize;
+      table = imageAt(image, section->data.Struct.sh_offset, count * entSize);
+      if (table == NULL) {
+         continue;
+      }
+
+      // One bit per symbol of the linked symbol table, kept for the whole count
+      symCount = 0;
+      bitmap   = NULL;
+      if (section->data.Struct.sh_link < (uint32_t)secTable->count) {
+         symSection = &secTable->sections[section->data.Struct.sh_link];
+         symCount   = symbolCount(symSection);
+         if (lookups[section->data.Struct.sh_link] == NULL) {
+            lookups[section->data.Struct.sh_link] = calloc(symCount / 64 + 1, sizeof(uint64_t));
+         }
+         bitmap = lookups[section->data.Struct.sh_link];
+      }
+
+      // Decode and count a chunk at a time
+      for (first=0; first < count; first += chunkSize) {
+
+         chunkSize = (count - first > RELOC_CHUNK) ? RELOC_CHUNK : count - first;
+         decoder->decodeRelocations(table + first * entSize, chunkSize, entSize, rela, relocations);
+
+         for (reloc = relocations; reloc < relocations + chunkSize; reloc++) {
+
+            cost->relocCount++;
+            if (reloc->type < STARTUP_DIRECT_TYPES) {
+               cost->typeCounts[reloc->type]++;
+            } else {
+               cost->otherTypes++;
+            }
+
+            kind = relocationClass(fileHeader->Struct.e_machine, reloc->type);
+            if (kind == RELOC_CLASS_RELATIVE) {
+               cost->relativeCount++;
+            } else if (kind == RELOC_CLASS_PLT) {
+               cost->pltCount++;
+            } else if (kind == RELOC_CLASS_SYMBOLIC) {
+               cost->symbolicCount++;
+            }
+
+            // Mark the symbols looked up at load time
+            if (bitmap != NULL && reloc->symbol != 0 && reloc->symbol < symCount &&
+                (kind == RELOC_CLASS_SYMBOLIC || (kind == RELOC_CLASS_PLT && cost->bindNow))) {
+               bitmap[reloc->symbol / 64] |= (uint64_t)1 << (reloc->symbol % 64);
+            }
+         }
+      }
+   }
+
+   // Count the marked symbols of each symbol table
+   for (iter=0; iter < secTable->count; iter++) {
+      if (lookups[iter] != NULL) {
+         symCount = symbolCount(&secTable->sections[iter]);
+         for (word=0; word <= symCount / 64; word++) {
+            cost->lookupCount += __builtin_popcountll(lookups[iter][word]);
+         }
+         free(lookups[iter]);
+      }
+   }
+
+   free(lookups);
+   free(relocations);
+}
+
+/**
+ * A utility function that gives the number of entries in a symbol
+ * table section.
+ *
+ * INPUT:   pointer to the section
+ *
+ * OUTPUT:  number of symbols (0 if the entry size is 0)
+ */
+uint64_t symbolCount(const struct sectionEntry *section) {
+
+   if (section->data.Struct.sh_entsize == 0) {
+      return 0;
+   }
+
+   return section->data.Struct.sh_size / section->data.Struct.sh_entsize;
+}
+
+/**
+ * A function that counts the relative relocations packed into RELR
+ * sections.  An even word is one address to relocate; an odd word is
+ * a bitmap of the words after the previous address, one bit each
+ * past the marker bit.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          pointer to the report to fill in
+ *
+ * OUTPUT:  none
+ */
+void countRelrRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost) {
+
+   int index;
+   int wordSize;
+   uint64_t iter;
+   uint64_t count;
+   uint64_t entry;
+
+   const unsigned char *table;
+   const struct sectionEntry *section;
+   const struct elfDecoder *decoder;
+
+   decoder  = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   wordSize = (fileHeader->arr[4] == BIT32) ? 4 : 8;
+
+   // Iterate over the RELR sections
+   for (index = findSectionByType(secTable, SHT_RELR, 0); index != -1;
+        index = findSectionByType(secTable, SHT_RELR, index + 1)) {
+
+      section = &secTable->sections[index];
+      count   = section->data.Struct.sh_size / wordSize;
+      table   = imageAt(image, section->data.Struct.sh_offset, count * wordSize);
+      if (table == NULL) {
+         continue;
+      }
+
+      for (iter=0; iter < count; iter++) {
+         entry = decoder->decodeAddress(table + iter * wordSize);
+         cost->relrCount += (entry & 1) ? __builtin_popcountll(entry) - 1 : 1;
+      }
+   }
+
+   cost->relocCount    += cost->relrCount;
+   cost->relativeCount += cost->relrCount;
+}
+
+/**
+ * A function that adds up the size of the RELRO segments: data the
+ * loader relocates and then write-protects, so every page of it is
+ * touched and copied at startup.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the image of the file
+ *          pointer to the report to fill in
+ *
+ * OUTPUT:  none
+ */
+void countRelroSize(const union fileHeader_union *fileHeader, const struct fileImage *image, struct startupCost *cost) {
+
+   int iter;
+   struct segmentTable segTable;
+
+   if (!readProgramHeaders(fileHeader, &segTable, image)) {
+      return;
+   }
+
+   for (iter=0; iter < segTable.count; iter++) {
+      if (segTable.segments[iter].Struct.p_type == PT_GNU_RELRO) {
+         cost->relroSize += segTable.segments[iter].Struct.p_memsz;
+      }
+   }
+
+   freeSegmentTable(&segTable);
+}
+
+/**
+ * A function that turns a report into one figure for ranking files.
+ * The unit is roughly the cost of applying one relative relocation;
+ * a symbol lookup, loading a needed library and copying a RELRO page
+ * are weighted as many times that.
+ *
+ * INPUT:   pointer to the report
+ *
+ * OUTPUT:  the estimated cost
+ */
+uint64_t estimateStartupCost(const struct startupCost *cost) {
+
+   return cost->relativeCount +
+          cost->symbolicCount +
+          cost->pltCount +
+          cost->lookupCount * STARTUP_LOOKUP_COST +
+          cost->neededCount * STARTUP_NEEDED_COST +
+          (cost->relroSize + STARTUP_PAGE_SIZE - 1) / STARTUP_PAGE_SIZE * STARTUP_PAGE_COST;
+}
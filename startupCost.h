@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file startupCost.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+void printStartupCost(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+bool readDynamicInfo(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost, struct outputBuffer *out);
+void countLoadRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost);
+uint64_t symbolCount(const struct sectionEntry *section);
+void countRelrRelocations(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct startupCost *cost);
+void countRelroSize(const union fileHeader_union *fileHeader, const struct fileImage *image, struct startupCost *cost);
+uint64_t estimateStartupCost(const struct startupCost *cost);
+void printCostLine(struct outputBuffer *out, const char *label, uint64_t value, bool nested);
+void printCostLabel(struct outputBuffer *out, const char *label, bool nested);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+int findSectionByType(const struct sectionTable *secTable, uint32_t type, int start);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+bool readProgramHeaders(const union fileHeader_union *fileHeader, struct segmentTable *segTable, const struct fileImage *image);
+void freeSegmentTable(struct segmentTable *segTable);
+const char *relocationTypeName(uint16_t machine, uint32_t type);
+int relocationClass(uint16_t machine, uint32_t type);
+
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeTextPadded(struct outputBuffer *buffer, const char *text, int width);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+void writeHex(struct outputBuffer *buffer, uint64_t value, int digits);
+void writeHexPadded(struct outputBuffer *buffer, uint64_t value, int width);
+// Defines
+#define BIT32 1
+#define BIT64 2
+
+#define SHT_RELA     4
+#define SHT_HASH     5
+#define SHT_DYNAMIC  6
+#define SHT_REL      9
+#define SHT_DYNSYM   11
+#define SHT_RELR     19
+#define SHT_GNU_HASH 0x6ffffff6
+
+#define SHF_ALLOC 0x2
+
+#define PT_GNU_RELRO 0x6474e552
+
+#define DT_NULL     0
+#define DT_NEEDED   1
+#define DT_BIND_NOW 24
+#define DT_FLAGS    30
+#define DT_FLAGS_1  0x6ffffffb
+
+#define DF_BIND_NOW 0x8
+#define DF_1_NOW    0x1
+
+#define RELOC_CLASS_NONE     0
+#define RELOC_CLASS_RELATIVE 1
+#define RELOC_CLASS_PLT      2
+#define RELOC_CLASS_SYMBOLIC 3
+
+#define RELOC_CHUNK (1 << 12)
+#define STARTUP_DIRECT_TYPES 256
+
+#define STARTUP_PAGE_SIZE   4096
+#define STARTUP_LOOKUP_COST 50
+#define STARTUP_NEEDED_COST 5000
+#define STARTUP_PAGE_COST   100
@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file symbolLookup.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "symbolLookup.h"
+
+/**
+ * A function that looks a symbol up by name through the file's own
+ * hash section and prints it.  Only the hash chain for the name is
+ * read, so the answer doesn't depend on the size of the symbol table.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          name of the symbol to look up
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printSymbolLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *symName, struct outputBuffer *out) {
+
+   int64_t symIndex;
+   int length;
+   uint32_t shndx;
+   uint64_t shndxCount;
+   char *line;
+
+   const unsigned char *shndxTable;
+
+   struct hashLookup lookup;
+   union symbol_union symbol;
+
+   // Find the hash section and the symbols it covers
+   if (!openHashLookup(fileHeader, secTable, image, &lookup)) {
+      writeText(out, "\n");
+      writeText(out, "There is no usable .gnu.hash or .hash section in this file.\n");
+      return;
+   }
+
+   symIndex = lookupSymbolName(&lookup, symName, &symbol);
+
+   // Report names that aren't defined here
+   if (symIndex == -1) {
+      writeText(out, "\n");
+      writeText(out, "Symbol '");
+      writeText(out, symName);
+      writeText(out, "' is not exported by this file.\n");
+      return;
+   }
+   if (symbol.Struct.st_shndx == SHN_UNDEF) {
+      writeText(out, "\n");
+      writeText(out, "Symbol '");
+      writeText(out, symName);
+      writeText(out, "' is used but not defined by this file.\n");
+      return;
+   }
+
+   // Print formatting info
+   writeText(out, "\n");
+   writeText(out, "Symbol '");
+   writeText(out, symName);
+   writeText(out, "' found in '");
+   writeText(out, lookup.symSection->name);
+   writeText(out, "' through '");
+   writeText(out, lookup.hashSection->name);
+   writeText(out, "':\n");
+   if (fileHeader->arr[4] == BIT32) {
+      writeText(out, "   Num:    Value  Size Type    Bind   Vis      Ndx Name\n");
+   } else {
+      writeText(out, "   Num:    Value          Size Type    Bind   Vis      Ndx Name\n");
+   }
+
+   // Print the symbol like -s does
+   shndxTable = findSymbolShndx(secTable, lookup.symSection, image, &shndxCount);
+   shndx  = symbolSection(&symbol.Struct, symIndex, shndxTable, shndxCount, lookup.decoder);
+   line   = malloc(SYMBOL_LINE_MAX + strlen(symName));
+   length = formatSymbolLine(line, symIndex, (fileHeader->arr[4] == BIT32) ? 8 : 16, &symbol.Struct, shndx, symName);
+   writeBytes(out, line, length);
+   free(line);
+}
+
+/**
+ * A function that finds a file's hash section by section type and the
+ * symbol and string tables it is linked to.  .gnu.hash is preferred
+ * over .hash when both are present.  Every table is bounds checked
+ * once here, so lookups only check indexes.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          pointer to the lookup to fill in
+ *
+ * OUTPUT:  true if a usable hash section was found
+ *          false otherwise
+ */
+bool openHashLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct hashLookup *lookup) {
+
+   int iter;
+   uint32_t link;
+   const union sectionHeader_union *hashHeader;
+   const union sectionHeader_union *symHeader;
+
+   lookup->hashSection = NULL;
+   lookup->secTable    = secTable;
+   lookup->decoder     = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   lookup->wordSize    = (fileHeader->arr[4] == BIT32) ? 4 : 8;
+
+   // Prefer .gnu.hash over .hash
+   for (iter=0; iter < secTable->count; iter++) {
+      if (secTable->sections[iter].data.Struct.sh_type == SHT_GNU_HASH) {
+         lookup->hashSection = &secTable->sections[iter];
+         break;
+      }
+      if (secTable->sections[iter].data.Struct.sh_type == SHT_HASH && lookup->hashSection == NULL) {
+         lookup->hashSection = &secTable->sections[iter];
+      }
+   }
+   if (lookup->hashSection == NULL) {
+      return false;
+   }
+   hashHeader  = &lookup->hashSection->data;
+   lookup->gnu = (hashHeader->Struct.sh_type == SHT_GNU_HASH);
+
+   // Locate the hash words
+   lookup->words     = imageAt(image, hashHeader->Struct.sh_offset, hashHeader->Struct.sh_size);
+   lookup->wordCount = hashHeader->Struct.sh_size / 4;
+   if (lookup->words == NULL) {
+      return false;
+   }
+
+   // Locate the symbols the hash section is linked to
+   link = hashHeader->Struct.sh_link;
+   if (link == 0 || link >= (uint32_t)secTable->count) {
+      return false;
+   }
+   lookup->symSection = &secTable->sections[link];
+   symHeader          = &lookup->symSection->data;
+   lookup->entSize    = symHeader->Struct.sh_entsize;
+   if (lookup->entSize < lookup->decoder->symbolSize) {
+      return false;
+   }
+   lookup->symbolCount = symHeader->Struct.sh_size / lookup->entSize;
+   lookup->symbols     = imageAt(image, symHeader->Struct.sh_offset, lookup->symbolCount * lookup->entSize);
+   if (lookup->symbols == NULL) {
+      return false;
+   }
+
+   // Locate the symbol names
+   lookup->strtab = findStringTable(secTable, lookup->symSection, image, &lookup->strtabSize);
+
+   return true;
+}
+
+/**
+ * A function that looks up a symbol through whichever hash section
+ * was opened.
+ *
+ * INPUT:   pointer to the opened lookup
+ *          name of the symbol
+ *          pointer to store the decoded symbol
+ *
+ * OUTPUT:  index of the symbol in its table
+ *          -1 if the name isn't in the table
+ */
+int64_t lookupSymbolName(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol) {
+
+   if (lookup->gnu) {
+      return lookupGnuHash(lookup, symName, symbol);
+   }
+   return lookupSysvHash(lookup, symName, symbol);
+}
+
+/**
+ * A function that looks up a symbol through a .gnu.hash section.  The
+ * bloom filter turns most missing names away after one word; otherwise
+ * the name's bucket gives the first symbol of its chain, and the chain
+ * holds each symbol's hash (low bit marking the end), so names are
+ * only compared when the hashes match.
+ *
+ * INPUT:   pointer to the opened lookup
+ *          name of the symbol
+ *          pointer to store the decoded symbol
+ *
+ * OUTPUT:  index of the symbol in its table
+ *          -1 if the name isn't in the table
+ */
+int64_t lookupGnuHash(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol) {
+
+   uint32_t hash;
+   uint32_t bucketCount;
+   uint32_t symOffset;
+   uint32_t bloomSize;
+   uint32_t bloomShift;
+   uint32_t chainHash;
+   uint64_t bloomWord;
+   uint64_t bloomMask;
+   uint64_t symIndex;
+   uint64_t bucketStart;
+   uint64_t chainStart;
+
+   int bits = lookup->wordSize * 8;
+   const unsigned char *words = lookup->words;
+   const struct elfDecoder *decoder = lookup->decoder;
+
+   // Read the header
+   if (lookup->wordCount < 4) {
+      return -1;
+   }
+   bucketCount = decoder->decodeWord(words);
+   symOffset   = decoder->decodeWord(words + 4);
+   bloomSize   = decoder->decodeWord(words + 8);
+   bloomShift  = decoder->decodeWord(words + 12);
+
+   // The bloom words and buckets must fit in the section
+   bucketStart = 16 + (uint64_t)bloomSize * lookup->wordSize;
+   chainStart  = bucketStart + (uint64_t)bucketCount * 4;
+   if (bucketCount == 0 || bloomSize == 0 || chainStart > lookup->wordCount * 4) {
+      return -1;
+   }
+
+   hash = gnuHash(symName);
+
+   // Check the bloom filter
+   bloomWord = (lookup->wordSize == 4) ? decoder->decodeWord(words + 16 + (hash / bits % bloomSize) * 4)
+                                       : decoder->decodeAddress(words + 16 + (hash / bits % bloomSize) * 8);
+   bloomMask = ((uint64_t)1 << (hash % bits)) | ((uint64_t)1 << ((hash >> bloomShift) % bits));
+   if ((bloomWord & bloomMask) != bloomMask) {
+      return -1;
+   }
+
+   // Find the start of the name's chain
+   symIndex = decoder->decodeWord(words + bucketStart + (hash % bucketCount) * 4);
+   if (symIndex < symOffset) {
+      return -1;
+   }
+
+   // Walk the chain
+   while (chainStart + (symIndex - symOffset) * 4 + 4 <= lookup->wordCount * 4) {
+
+      chainHash = decoder->decodeWord(words + chainStart + (symIndex - symOffset) * 4);
+
+      if ((chainHash | 1) == (hash | 1) && matchSymbol(lookup, symIndex, symName, symbol)) {
+         return symIndex;
+      }
+
+      // The low bit marks the end of the chain
+      if (chainHash & 1) {
+         break;
+      }
+      symIndex++;
+   }
+
+   return -1;
+}
+
+/**
+ * A function that looks up a symbol through a SysV .hash section.  The
+ * name's bucket gives the first symbol to check and each symbol's chain
+ * entry gives the next, until index 0 ends the chain.
+ *
+ * INPUT:   pointer to the opened lookup
+ *          name of the symbol
+ *          pointer to store the decoded symbol
+ *
+ * OUTPUT:  index of the symbol in its table
+ *          -1 if the name isn't in the table
+ */
+int64_t lookupSysvHash(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol) {
+
+   uint32_t bucketCount;
+   uint32_t chainCount;
+   uint64_t symIndex;
+   uint64_t steps = 0;
+
+   const unsigned char *words = lookup->words;
+   const struct elfDecoder *decoder = lookup->decoder;
+
+   // Read the header
+   if (lookup->wordCount < 2) {
+      return -1;
+   }
+   bucketCount = decoder->decodeWord(words);
+   chainCount  = decoder->decodeWord(words + 4);
+
+   // The buckets and chains must fit in the section
+   if (bucketCount == 0 || 2 + (uint64_t)bucketCount + chainCount > lookup->wordCount) {
+      return -1;
+   }
+
+   symIndex = decoder->decodeWord(words + 8 + (sysvHash(symName) % bucketCount) * 4);
+
+   // Walk the chain, giving up on loops
+   while (symIndex != 0 && symIndex < chainCount && steps++ < chainCount) {
+
+      if (matchSymbol(lookup, symIndex, symName, symbol)) {
+         return symIndex;
+      }
+      symIndex = decoder->decodeWord(words + 8 + ((uint64_t)bucketCount + symIndex) * 4);
+   }
+
+   return -1;
+}
+
+/**
+ * A utility function that decodes one symbol and checks its name.
+ *
+ * INPUT:   pointer to the opened lookup
+ *          index of the symbol
+ *          name to compare against
+ *          pointer to store the decoded symbol
+ *
+ * OUTPUT:  true if the symbol has that name
+ *          false otherwise, or if the index is out of range
+ */
+bool matchSymbol(const struct hashLookup *lookup, uint64_t symIndex, const char *symName, union symbol_union *symbol) {
+
+   if (symIndex >= lookup->symbolCount) {
+      return false;
+   }
+
+   lookup->decoder->decodeSymbols(lookup->symbols + symIndex * lookup->entSize, 1, lookup->entSize, symbol);
+
+   return strcmp(symbolName(lookup->strtab, lookup->strtabSize, lookup->secTable, &symbol->Struct, symbol->Struct.st_shndx), symName) == 0;
+}
+
+/**
+ * Utility functions that hash a name the way .gnu.hash (DJB, h*33+c)
+ * and SysV .hash (the ELF hash) do.
+ *
+ * INPUT:   name to hash
+ *
+ * OUTPUT:  the hash
+ */
+uint32_t gnuHash(const char *name) {
+
+   uint32_t hash = 5381;
+
+   while (*name != '\0') {
+      hash = hash * 33 + (unsigned char)*name++;
+   }
+
+   return hash;
+}
+
+uint32_t sysvHash(const char *name) {
+
+   uint32_t hash = 0;
+   uint32_t high;
+
+   while (*name != '\0') {
+      hash = (hash << 4) + (unsigned char)*name++;
+      if ( (high = hash & 0xf0000000) != 0 ) {
+         hash ^= high >> 24;
+      }
+      hash &= ~high;
+   }
+
+   return hash;
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file symbolLookup.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "customDataTypes.h"
+
+// Local Prototypes
+void printSymbolLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, const char *symName, struct outputBuffer *out);
+bool openHashLookup(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct hashLookup *lookup);
+int64_t lookupSymbolName(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol);
+int64_t lookupGnuHash(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol);
+int64_t lookupSysvHash(const struct hashLookup *lookup, const char *symName, union symbol_union *symbol);
+bool matchSymbol(const struct hashLookup *lookup, uint64_t symIndex, const char *symName, union symbol_union *symbol);
+uint32_t gnuHash(const char *name);
+uint32_t sysvHash(const char *name);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+const unsigned char *findSymbolShndx(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *shndxCount);
+uint32_t symbolSection(const struct symbol_struct64 *symbol, uint64_t number, const unsigned char *shndxTable, uint64_t shndxCount, const struct elfDecoder *decoder);
+const char *symbolName(const char *strtab, uint64_t strtabSize, const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx);
+int formatSymbolLine(char *line, uint64_t number, int addrDigits, const struct symbol_struct64 *symbol, uint32_t shndx, const char *name);
+
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+// Defines
+#define BIT32 1
+#define BIT64 2
+
+#define SHT_HASH     5
+#define SHT_GNU_HASH 0x6ffffff6
+
+#define SHN_UNDEF 0
+
+#define SYMBOL_LINE_MAX 96
@@ -0,0 +1,700 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file symbols.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "symbols.h"
+
+/**
+ * A function that finds every symbol table in the section table, by
+ * section type, and prints each one.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printSymbolTables(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out) {
+
+   int iter;
+   const struct sectionEntry *section;
+
+   // Iterate over the section table
+   for (iter=0; iter < secTable->count; iter++) {
+
+      section = &secTable->sections[iter];
+
+      if (section->data.Struct.sh_type == SHT_SYMTAB || section->data.Struct.sh_type == SHT_DYNSYM) {
+         printSymbolTable(fileHeader, secTable, section, image, out);
+      }
+   }
+}
+
+/**
+ * A function that prints one symbol table.  The table is split into
+ * fixed-size chunks that a group of threads decode and format in
+ * rounds: each thread takes one chunk per round into its own buffers,
+ * then the calling thread writes the round's text out in order.  The
+ * symbols are read straight from the image and their names point into
+ * the linked string table, so memory use stays the same however many
+ * symbols the table holds.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the symbol table's section
+ *          pointer to the image of the file
+ *          output buffer to print to
+ *
+ * OUTPUT:  none
+ */
+void printSymbolTable(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, struct outputBuffer *out) {
+
+   int iter;
+   int workerTotal;
+   long cpuCount;
+
+   pthread_t *threads;
+   struct symbolWorker *workers;
+   struct symbolDump dump;
+
+   dump.decoder    = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   dump.entSize    = section->data.Struct.sh_entsize;
+   dump.secTable   = secTable;
+   dump.addrDigits = (fileHeader->arr[4] == BIT32) ? 8 : 16;
+   dump.out        = out;
+
+   // Entries must be at least as large as the ELF class says
+   if (dump.entSize < dump.decoder->symbolSize) {
+      writeText(out, "\nSymbol table '");
+      writeText(out, section->name);
+      writeText(out, "' has a sh_entsize of zero or an invalid size!\n");
+      return;
+   }
+   dump.count = section->data.Struct.sh_size / dump.entSize;
+
+   // Locate the symbols in the image
+   dump.table = imageAt(image, section->data.Struct.sh_offset, dump.count * dump.entSize);
+   if (dump.table == NULL) {
+      writeText(out, "\nSymbol table '");
+      writeText(out, section->name);
+      writeText(out, "' extends past the end of the file.\n");
+      return;
+   }
+
+   // Locate the linked string table, and the extended section indexes
+   dump.strtab = findStringTable(secTable, section, image, &dump.strtabSize);
+   dump.shndxTable = findSymbolShndx(secTable, section, image, &dump.shndxCount);
+
+   // Print formatting info
+   writeText(out, "\n");
+   writeText(out, "Symbol table '");
+   writeText(out, section->name);
+   writeText(out, "' contains ");
+   writeUnsigned(out, dump.count);
+   writeText(out, " entries:\n");
+   if (dump.addrDigits == 8) {
+      writeText(out, "   Num:    Value  Size Type    Bind   Vis      Ndx Name\n");
+   } else {
+      writeText(out, "   Num:    Value          Size Type    Bind   Vis      Ndx Name\n");
+   }
+
+   // One thread per core, unless files are already spread over pool or scan workers
+   cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+   dump.chunkCount  = (dump.count + SYMBOL_CHUNK - 1) / SYMBOL_CHUNK;
+   dump.threadCount = (workerCount > 1 || poolWorkerCount > 1 || cpuCount < 1) ? 1 : cpuCount;
+   if (dump.threadCount > SYMBOL_MAX_THREADS) {
+      dump.threadCount = SYMBOL_MAX_THREADS;
+   }
+   if ((uint64_t)dump.threadCount > dump.chunkCount) {
+      dump.threadCount = (dump.chunkCount > 0) ? dump.chunkCount : 1;
+   }
+
+   // The symbols are read front to back
+   imageAdvise(image, section->data.Struct.sh_offset, dump.count * dump.entSize, MADV_SEQUENTIAL);
+
+   // Give each thread its own buffers, falling back to this thread alone if memory is short
+   workerTotal = dump.threadCount;
+   workers = calloc(workerTotal, sizeof(struct symbolWorker));
+   threads = malloc(workerTotal * sizeof(pthread_t));
+   if (workers == NULL || threads == NULL) {
+      free(workers);
+      free(threads);
+      workerTotal = 1;
+      workers = calloc(1, sizeof(struct symbolWorker));
+      threads = NULL;
+   }
+   for (iter=0; workers != NULL && iter < workerTotal; iter++) {
+      workers[iter].dump    = &dump;
+      workers[iter].id      = iter;
+      workers[iter].symbols = malloc(SYMBOL_CHUNK * sizeof(union symbol_union));
+      if (workers[iter].symbols == NULL) {
+         break;
+      }
+   }
+
+   // Only the workers with buffers take part
+   workerTotal = (workers != NULL) ? iter : 0;
+   if (workerTotal == 0) {
+      writeText(out, "Symbol table '");
+      writeText(out, section->name);
+      writeText(out, "' can't be printed: out of memory.\n");
+      free(workers);
+      return;
+   }
+
+   // Start the helpers, held at the start lock until the count is final
+   pthread_mutex_init(&dump.start, NULL);
+   pthread_mutex_lock(&dump.start);
+   for (iter=1; iter < workerTotal; iter++) {
+      if (pthread_create(&threads[iter], NULL, symbolWorker, &workers[iter]) != 0) {
+         break;
+      }
+   }
+
+   // Size the rounds and barriers to the threads that did start
+   dump.threadCount = iter;
+   pthread_barrier_init(&dump.formatted, NULL, dump.threadCount);
+   pthread_barrier_init(&dump.written, NULL, dump.threadCount);
+   pthread_mutex_unlock(&dump.start);
+
+   // Work as thread 0
+   symbolWorker(&workers[0]);
+   for (iter=1; iter < dump.threadCount; iter++) {
+      pthread_join(threads[iter], NULL);
+   }
+
+   // Say if any chunk was cut short, then release the buffers
+   for (iter=0; iter < workerTotal; iter++) {
+      if (workers[iter].failed) {
+         writeText(out, "Symbol table '");
+         writeText(out, section->name);
+         writeText(out, "' is incomplete: out of memory.\n");
+         break;
+      }
+   }
+   for (iter=0; iter < workerTotal; iter++) {
+      free(workers[iter].symbols);
+      free(workers[iter].text);
+   }
+   free(threads);
+   free(workers);
+
+   pthread_barrier_destroy(&dump.formatted);
+   pthread_barrier_destroy(&dump.written);
+   pthread_mutex_destroy(&dump.start);
+}
+
+/**
+ * The loop run by each thread printing a symbol table.  In round r,
+ * thread i formats chunk r * threadCount + i.  Once every thread has
+ * formatted its chunk, thread 0 writes the text out in chunk order
+ * while the others wait to start the next round.
+ *
+ * INPUT:   pointer to this thread's symbolWorker
+ *
+ * OUTPUT:  NULL
+ */
+void *symbolWorker(void *arg) {
+
+   int iter;
+   uint64_t round;
+   uint64_t chunk;
+   uint64_t roundCount;
+
+   struct symbolWorker *worker = arg;
+   struct symbolDump *dump = worker->dump;
+
+   // Wait until every helper is started and the barriers are set up
+   pthread_mutex_lock(&dump->start);
+   pthread_mutex_unlock(&dump->start);
+
+   roundCount = (dump->chunkCount + dump->threadCount - 1) / dump->threadCount;
+
+   for (round=0; round < roundCount; round++) {
+
+      // Format this thread's chunk of the round
+      chunk = round * dump->threadCount + worker->id;
+      worker->textUsed = 0;
+      if (chunk < dump->chunkCount) {
+         formatSymbolChunk(worker, chunk);
+      }
+
+      // Wait for the whole round
+      pthread_barrier_wait(&dump->formatted);
+
+      // Thread 0 writes the round out in order
+      if (worker->id == 0) {
+         for (iter=0; iter < dump->threadCount; iter++) {
+            writeBytes(dump->out, worker[iter].text, worker[iter].textUsed);
+         }
+      }
+
+      // Keep the buffers until they are written
+      pthread_barrier_wait(&dump->written);
+   }
+
+   return NULL;
+}
+
+/**
+ * A function that decodes one chunk of a symbol table into the
+ * thread's symbol buffer and formats its lines into the thread's
+ * text buffer.
+ *
+ * INPUT:   pointer to this thread's symbolWorker
+ *          number of the chunk to format
+ *
+ * OUTPUT:  none
+ */
+void formatSymbolChunk(struct symbolWorker *worker, uint64_t chunk) {
+
+   int iter;
+   int count;
+   int length;
+   uint64_t first;
+   uint32_t shndx;
+
+   const char *name;
+   char *line;
+
+   const struct symbol_struct64 *symbol;
+   const struct symbolDump *dump = worker->dump;
+
+   // Decode the chunk into 64bit, local endian format
+   first = chunk * SYMBOL_CHUNK;
+   count = (dump->count - first > SYMBOL_CHUNK) ? SYMBOL_CHUNK : dump->count - first;
+   dump->decoder->decodeSymbols(dump->table + first * dump->entSize, count, dump->entSize, worker->symbols);
+
+   // Iterate over each symbol
+   for (iter=0; iter < count; iter++) {
+
+      symbol = &worker->symbols[iter].Struct;
+      shndx  = symbolSection(symbol, first + iter, dump->shndxTable, dump->shndxCount, dump->decoder);
+      name   = symbolName(dump->strtab, dump->strtabSize, dump->secTable, symbol, shndx);
+
+      // Make room for the line, then format it
+      line   = reserveSymbolText(worker, SYMBOL_LINE_MAX + strlen(name));
+      if (line == NULL) {
+         worker->failed = true;
+         return;
+      }
+      length = formatSymbolLine(line, first + iter, dump->addrDigits, symbol, shndx, name);
+
+      worker->textUsed += length;
+   }
+}
+
+/**
+ * A function that formats one symbol the way readelf -s prints it.
+ * The buffer must hold SYMBOL_LINE_MAX bytes plus the name.
+ *
+ * INPUT:   pointer to where the line should be written
+ *          number of the symbol in its table
+ *          number of hex digits in an address
+ *          pointer to the symbol
+ *          the symbol's section index, from symbolSection
+ *          the symbol's name
+ *
+ * OUTPUT:  length of the line
+ */
+int formatSymbolLine(char *line, uint64_t number, int addrDigits, const struct symbol_struct64 *symbol, uint32_t shndx, const char *name) {
+
+   char *cursor;
+   const char *shndxName;
+   char shndxText[16];
+
+   // Name the special section indexes
+   switch(symbol->st_shndx) {
+      case SHN_UNDEF:
+         shndxName = "UND";
+         break;
+      case SHN_ABS:
+         shndxName = "ABS";
+         break;
+      case SHN_COMMON:
+         shndxName = "COM";
+         break;
+      default:
+         *formatUnsigned(shndxText, shndx) = '\0';
+         shndxName = shndxText;
+   }
+
+   // Same fields as "%6lu: %0*lx %5lu %-7s %-6s %-7s %4s %s\n"
+   cursor    = formatUnsignedPadded(line, number, 6);
+   *cursor++ = ':';
+   *cursor++ = ' ';
+   cursor    = formatHex(cursor, symbol->st_value, addrDigits);
+   *cursor++ = ' ';
+   cursor    = formatUnsignedPadded(cursor, symbol->st_size, 5);
+   *cursor++ = ' ';
+   cursor    = formatTextPadded(cursor, symbolTypeName(symbol->st_info & 0xf), -7);
+   *cursor++ = ' ';
+   cursor    = formatTextPadded(cursor, symbolBindName(symbol->st_info >> 4), -6);
+   *cursor++ = ' ';
+   cursor    = formatTextPadded(cursor, symbolVisibilityName(symbol->st_other & 0x3), -7);
+   *cursor++ = ' ';
+   cursor    = formatTextPadded(cursor, shndxName, 4);
+   *cursor++ = ' ';
+   cursor    = formatTextPadded(cursor, name, 0);
+   *cursor++ = '\n';
+
+   return cursor - line;
+}
+
+/**
+ * A utility function that makes sure the thread's text buffer has
+ * room for some more bytes, growing it if needed.  The buffer is left
+ * as it was if it can't be grown.
+ *
+ * INPUT:   pointer to this thread's symbolWorker
+ *          number of bytes needed
+ *
+ * OUTPUT:  pointer to where the bytes go
+ *          NULL if there is no memory for them
+ */
+char *reserveSymbolText(struct symbolWorker *worker, size_t size) {
+
+   size_t grownSize;
+   char *grown;
+
+   if (worker->textSize - worker->textUsed < size) {
+      grownSize = worker->textSize;
+      while (grownSize - worker->textUsed < size) {
+         grownSize = (grownSize == 0) ? SYMBOL_CHUNK * SYMBOL_LINE_MAX : grownSize * 2;
+      }
+      if ( (grown = realloc(worker->text, grownSize)) == NULL ) {
+         return NULL;
+      }
+      worker->text     = grown;
+      worker->textSize = grownSize;
+   }
+
+   return worker->text + worker->textUsed;
+}
+
+/**
+ * A function that reads the function symbols of a file into a table,
+ * for looking symbols up by address.  The full symbol table is used
+ * when there is one, and the dynamic symbol table otherwise.  Symbols
+ * are decoded a chunk at a time and only defined functions are kept;
+ * their names point into the image.
+ *
+ * INPUT:   pointer to the fileHeader for this file
+ *          pointer to the section table
+ *          pointer to the image of the file
+ *          pointer to the symbol table to fill in
+ *
+ * OUTPUT:  true if a symbol table was read
+ *          false if the file has no usable symbol table
+ */
+bool readFunctionSymbols(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct symbolTable *symTable) {
+
+   int iter;
+   int count;
+   int entSize;
+   int type;
+   uint32_t shndx;
+   uint64_t first;
+   uint64_t total;
+   uint64_t strtabSize;
+   uint64_t shndxCount;
+
+   const char *strtab;
+   const unsigned char *table;
+   const unsigned char *shndxTable;
+   const struct sectionEntry *section = NULL;
+   const struct elfDecoder *decoder;
+   const struct symbol_struct64 *symbol;
+
+   union symbol_union *symbols;
+   struct symbolEntry *entry;
+
+   // Start from an empty table
+   symTable->symbols = NULL;
+   symTable->count   = 0;
+
+   // Prefer the full symbol table over the dynamic one
+   for (iter=0; iter < secTable->count; iter++) {
+      if (secTable->sections[iter].data.Struct.sh_type == SHT_SYMTAB) {
+         section = &secTable->sections[iter];
+         break;
+      }
+      if (secTable->sections[iter].data.Struct.sh_type == SHT_DYNSYM && section == NULL) {
+         section = &secTable->sections[iter];
+      }
+   }
+   if (section == NULL) {
+      return false;
+   }
+
+   // Entries must be at least as large as the ELF class says
+   decoder = selectElfDecoder(fileHeader->arr[4], fileHeader->arr[5]);
+   entSize = section->data.Struct.sh_entsize;
+   if (entSize < decoder->symbolSize) {
+      return false;
+   }
+   total = section->data.Struct.sh_size / entSize;
+
+   // Locate the symbols and their names in the image
+   table = imageAt(image, section->data.Struct.sh_offset, total * entSize);
+   if (table == NULL) {
+      return false;
+   }
+   strtab = findStringTable(secTable, section, image, &strtabSize);
+   shndxTable = findSymbolShndx(secTable, section, image, &shndxCount);
+
+   // There are never more functions than symbols
+   symTable->symbols = malloc((total > 0 ? total : 1) * sizeof(struct symbolEntry));
+   symbols = malloc(SYMBOL_CHUNK * sizeof(union symbol_union));
+
+   // Decode a chunk at a time, keeping the defined functions
+   for (first=0; first < total; first += count) {
+
+      count = (total - first > SYMBOL_CHUNK) ? SYMBOL_CHUNK : total - first;
+      decoder->decodeSymbols(table + first * entSize, count, entSize, symbols);
+
+      for (iter=0; iter < count; iter++) {
+
+         symbol = &symbols[iter].Struct;
+         type   = symbol->st_info & 0xf;
+
+         if ((type != STT_FUNC && type != STT_GNU_IFUNC) || symbol->st_shndx == SHN_UNDEF) {
+            continue;
+         }
+
+         shndx        = symbolSection(symbol, first + iter, shndxTable, shndxCount, decoder);
+         entry        = &symTable->symbols[symTable->count++];
+         entry->value = symbol->st_value;
+         entry->size  = symbol->st_size;
+         entry->limit = symbolLimit(secTable, symbol, shndx);
+         entry->name  = symbolName(strtab, strtabSize, secTable, symbol, shndx);
+      }
+   }
+
+   free(symbols);
+
+   return true;
+}
+
+/**
+ * A utility function that gives the end address of the section a
+ * symbol is defined in, so a symbol without a size never reaches past
+ * its section.  Symbols outside every section (such as SHN_ABS) only
+ * cover their own address.
+ *
+ * INPUT:   pointer to the section table
+ *          pointer to the symbol
+ *          the symbol's section index, from symbolSection
+ *
+ * OUTPUT:  the first address past the symbol's section
+ */
+uint64_t symbolLimit(const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx) {
+
+   const union sectionHeader_union *secHeader;
+
+   if (symbol->st_shndx != SHN_ABS && symbol->st_shndx != SHN_COMMON && shndx < (uint32_t)secTable->count) {
+      secHeader = &secTable->sections[shndx].data;
+      if (symbol->st_value >= secHeader->Struct.sh_addr &&
+          symbol->st_value - secHeader->Struct.sh_addr < secHeader->Struct.sh_size) {
+         return secHeader->Struct.sh_addr + secHeader->Struct.sh_size;
+      }
+   }
+
+   return symbol->st_value + 1;
+}
+
+/**
+ * A utility function that finds the string table linked to a symbol
+ * table section.
+ *
+ * INPUT:   pointer to the section table
+ *          pointer to the symbol table's section
+ *          pointer to the image of the file
+ *          pointer to store the string table's size
+ *
+ * OUTPUT:  pointer to the string table in the image
+ *          NULL if there is no usable string table
+ */
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize) {
+
+   const char *strtab = NULL;
+   const union sectionHeader_union *strHeader;
+
+   *strtabSize = 0;
+
+   if (section->data.Struct.sh_link != 0 && section->data.Struct.sh_link < (uint32_t)secTable->count) {
+      strHeader = &secTable->sections[section->data.Struct.sh_link].data;
+      strtab    = (const char *)imageAt(image, strHeader->Struct.sh_offset, strHeader->Struct.sh_size);
+      if (strtab != NULL) {
+         *strtabSize = strHeader->Struct.sh_size;
+      }
+   }
+
+   return strtab;
+}
+
+/**
+ * A utility function that finds the SHT_SYMTAB_SHNDX section linked
+ * to a symbol table.  It holds one 32-bit section index per symbol,
+ * for symbols whose st_shndx is SHN_XINDEX.
+ *
+ * INPUT:   pointer to the section table
+ *          pointer to the symbol table's section
+ *          pointer to the image of the file
+ *          pointer to store the number of entries
+ *
+ * OUTPUT:  pointer to the entries in the image
+ *          NULL if the symbol table has no usable index section
+ */
+const unsigned char *findSymbolShndx(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *shndxCount) {
+
+   int iter;
+   const unsigned char *table;
+   const union sectionHeader_union *shndxHeader;
+
+   *shndxCount = 0;
+
+   for (iter=0; iter < secTable->count; iter++) {
+
+      shndxHeader = &secTable->sections[iter].data;
+
+      if (shndxHeader->Struct.sh_type == SHT_SYMTAB_SHNDX && shndxHeader->Struct.sh_link == (uint32_t)section->index) {
+         table = imageAt(image, shndxHeader->Struct.sh_offset, shndxHeader->Struct.sh_size);
+         if (table != NULL) {
+            *shndxCount = shndxHeader->Struct.sh_size / 4;
+         }
+         return table;
+      }
+   }
+
+   return NULL;
+}
+
+/**
+ * A utility function that gives the section index of a symbol.  An
+ * st_shndx of SHN_XINDEX means the real index is the symbol's entry
+ * in the SHT_SYMTAB_SHNDX section.
+ *
+ * INPUT:   pointer to the symbol
+ *          number of the symbol in its table
+ *          pointer to the extended index entries (may be NULL)
+ *          number of extended index entries
+ *          decoder for the file
+ *
+ * OUTPUT:  the symbol's section index
+ */
+uint32_t symbolSection(const struct symbol_struct64 *symbol, uint64_t number, const unsigned char *shndxTable, uint64_t shndxCount, const struct elfDecoder *decoder) {
+
+   if (symbol->st_shndx == SHN_XINDEX && number < shndxCount) {
+      return decoder->decodeWord(shndxTable + number * 4);
+   }
+
+   return symbol->st_shndx;
+}
+
+/**
+ * A utility function that finds a symbol's name in a string table
+ * without copying it.  Section symbols without a name take the name
+ * of their section, and names that run outside the string table get
+ * "<corrupt>".
+ *
+ * INPUT:   pointer to the string table (may be NULL)
+ *          size of the string table
+ *          pointer to the section table
+ *          pointer to the symbol
+ *          the symbol's section index, from symbolSection
+ *
+ * OUTPUT:  the symbol's name
+ */
+const char *symbolName(const char *strtab, uint64_t strtabSize, const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx) {
+
+   // Section symbols are named after their section
+   if (symbol->st_name == 0 && (symbol->st_info & 0xf) == STT_SECTION &&
+       shndx < (uint32_t)secTable->count) {
+      return secTable->sections[shndx].name;
+   }
+
+   // Files without a string table have no names
+   if (strtab == NULL) {
+      return "";
+   }
+
+   // Point at the name if it ends inside the string table
+   if (symbol->st_name < strtabSize &&
+       memchr(strtab + symbol->st_name, '\0', strtabSize - symbol->st_name) != NULL) {
+      return strtab + symbol->st_name;
+   }
+
+   return "<corrupt>";
+}
+
+/**
+ * Utility functions that name a symbol's type, binding and visibility
+ * the way readelf does.
+ *
+ * INPUT:   STT_*, STB_* or STV_* value
+ *
+ * OUTPUT:  name of the value
+ */
+const char *symbolTypeName(int type) {
+
+   switch(type) {
+      case 0:
+         return "NOTYPE";
+      case 1:
+         return "OBJECT";
+      case 2:
+         return "FUNC";
+      case 3:
+         return "SECTION";
+      case 4:
+         return "FILE";
+      case 5:
+         return "COMMON";
+      case 6:
+         return "TLS";
+      case 10:
+         return "IFUNC";
+      default:
+         return "<unknown>";
+   }
+}
+
+const char *symbolBindName(int bind) {
+
+   switch(bind) {
+      case 0:
+         return "LOCAL";
+      case 1:
+         return "GLOBAL";
+      case 2:
+         return "WEAK";
+      case 10:
+         return "UNIQUE";
+      default:
+         return "<unknown>";
+   }
+}
+
+const char *symbolVisibilityName(int visibility) {
+
+   switch(visibility) {
+      case 0:
+         return "DEFAULT";
+      case 1:
+         return "INTERNAL";
+      case 2:
+         return "HIDDEN";
+      default:
+         return "PROTECTED";
+   }
+}
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file symbols.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern int workerCount;
+extern int poolWorkerCount;
+
+// Local Prototypes
+void printSymbolTables(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct outputBuffer *out);
+void printSymbolTable(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, struct outputBuffer *out);
+void *symbolWorker(void *arg);
+void formatSymbolChunk(struct symbolWorker *worker, uint64_t chunk);
+int formatSymbolLine(char *line, uint64_t number, int addrDigits, const struct symbol_struct64 *symbol, uint32_t shndx, const char *name);
+char *reserveSymbolText(struct symbolWorker *worker, size_t size);
+bool readFunctionSymbols(const union fileHeader_union *fileHeader, const struct sectionTable *secTable, const struct fileImage *image, struct symbolTable *symTable);
+uint64_t symbolLimit(const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+const unsigned char *findSymbolShndx(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *shndxCount);
+uint32_t symbolSection(const struct symbol_struct64 *symbol, uint64_t number, const unsigned char *shndxTable, uint64_t shndxCount, const struct elfDecoder *decoder);
+const char *symbolName(const char *strtab, uint64_t strtabSize, const struct sectionTable *secTable, const struct symbol_struct64 *symbol, uint32_t shndx);
+const char *symbolTypeName(int type);
+const char *symbolBindName(int bind);
+const char *symbolVisibilityName(int visibility);
+
+// Other Prototypes
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+void imageAdvise(const struct fileImage *image, uint64_t offset, uint64_t size, int advice);
+
+void writeBytes(struct outputBuffer *buffer, const void *bytes, size_t size);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeUnsigned(struct outputBuffer *buffer, uint64_t value);
+char *formatUnsigned(char *out, uint64_t value);
+char *formatHex(char *out, uint64_t value, int digits);
+char *formatUnsignedPadded(char *out, uint64_t value, int width);
+char *formatTextPadded(char *out, const char *text, int width);
+// Defines
+#define BIT32 1
+#define BIT64 2
+
+#define SHT_SYMTAB 2
+#define SHT_DYNSYM 11
+#define SHT_SYMTAB_SHNDX 18
+
+#define STT_FUNC      2
+#define STT_SECTION   3
+#define STT_GNU_IFUNC 10
+
+#define SHN_UNDEF  0
+#define SHN_ABS    0xfff1
+#define SHN_COMMON 0xfff2
+#define SHN_XINDEX 0xffff
+
+#define SYMBOL_CHUNK (1 << 12)
+#define SYMBOL_MAX_THREADS 8
+#define SYMBOL_LINE_MAX 96
@@ -0,0 +1,548 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file unresolved.c
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Header file
+#include "unresolved.h"
+
+/**
+ * A function that checks a set of files as a whole, printing each
+ * undefined dynamic symbol that no file in the set exports.  This is a
+ * hash join: every file's .dynsym is read in parallel, the exports of
+ * all files go into one global hash index, and each file's imports are
+ * then probed against it, again in parallel.  The index is split into
+ * partitions on the top bits of the mixed hash so threads can build it
+ * without locks.  Threads that fail to start are left out; the rest
+ * share their work.
+ *
+ * INPUT:   array of file names to check
+ *          number of file names
+ *          stream to print results to
+ *          stream to print warnings to
+ *
+ * OUTPUT:  true if every import is provided by the set
+ *          false if any import is missing, or memory ran out
+ */
+bool printUnresolvedSymbols(char *fileNames[], int fileCount, FILE *out, FILE *err) {
+
+   int i;
+   int j;
+   int threadCount;
+   int missingTotal = 0;
+   int missingFiles = 0;
+   long cpuCount;
+
+   pthread_t *threads;
+   struct linkFile *file;
+   struct linkCheck check = {0};
+   struct outputBuffer buffer;
+
+   // One thread per core, or as many as -j asks for
+   cpuCount    = sysconf(_SC_NPROCESSORS_ONLN);
+   threadCount = (workerCount > 1) ? workerCount : (cpuCount > 1 ? cpuCount : 1);
+   if (threadCount > UNRESOLVED_MAX_THREADS) {
+      threadCount = UNRESOLVED_MAX_THREADS;
+   }
+
+   // Set up the shared state, with a partition per thread
+   check.files     = calloc(fileCount > 0 ? fileCount : 1, sizeof(struct linkFile));
+   check.fileCount = fileCount;
+   threads         = malloc(threadCount * sizeof(pthread_t));
+   if (check.files == NULL || threads == NULL) {
+      fprintf(err, "%s: Error: Out of memory\n", programName);
+      free(check.files);
+      free(threads);
+      return false;
+   }
+   while ((1 << check.partitionBits) < threadCount) {
+      check.partitionBits++;
+   }
+   for (i=0; i < fileCount; i++) {
+      check.files[i].fileName = fileNames[i];
+   }
+
+   pthread_mutex_init(&check.lock, NULL);
+   pthread_mutex_init(&check.start, NULL);
+
+   // Start the helpers, holding them until the barrier counts those that started
+   pthread_mutex_lock(&check.start);
+   for (i=1; i < threadCount; i++) {
+      if (pthread_create(&threads[i], NULL, linkWorker, &check) != 0) {
+         break;
+      }
+   }
+   check.threadCount = i;
+   pthread_barrier_init(&check.phase, NULL, check.threadCount);
+   pthread_mutex_unlock(&check.start);
+
+   // Run the join, with this thread as one of the workers
+   linkWorker(&check);
+   for (i=1; i < check.threadCount; i++) {
+      pthread_join(threads[i], NULL);
+   }
+   for (i=0; i < fileCount; i++) {
+      if (check.files[i].missing == NULL) {
+         check.failed = true;
+      }
+   }
+
+   // A check that ran out of memory has nothing reliable to print
+   if (check.failed) {
+      fprintf(err, "%s: Error: Out of memory\n", programName);
+   }
+
+   // Print the missing symbols in argument order
+   openOutputBuffer(&buffer, out);
+   for (i=0; i < fileCount; i++) {
+
+      file = &check.files[i];
+
+      if (check.failed) {
+         // Only free the file
+      } else if (!file->loaded) {
+         flushOutputBuffer(&buffer);
+         fprintf(err, "%s: %s: Warning: Skipped, it is not a readable ELF file\n", programName, file->fileName);
+      } else if (file->missingCount > 0) {
+         writeText(&buffer, "\n");
+         writeText(&buffer, "File: ");
+         writeText(&buffer, file->fileName);
+         writeChar(&buffer, '\n');
+         for (j=0; j < file->missingCount; j++) {
+            writeText(&buffer, "  ");
+            writeText(&buffer, file->strings + file->imports[file->missing[j]].name);
+            writeChar(&buffer, '\n');
+         }
+         missingTotal += file->missingCount;
+         missingFiles++;
+      }
+
+      free(file->strings);
+      free(file->exports);
+      free(file->imports);
+      free(file->missing);
+   }
+
+   // Print totals
+   if (!check.failed) {
+      writeText(&buffer, "\n");
+      writeSigned(&buffer, missingTotal);
+      writeText(&buffer, " unresolved symbols in ");
+      writeSigned(&buffer, missingFiles);
+      writeText(&buffer, " of ");
+      writeSigned(&buffer, fileCount);
+      writeText(&buffer, " files\n");
+   }
+   closeOutputBuffer(&buffer);
+
+   pthread_barrier_destroy(&check.phase);
+   pthread_mutex_destroy(&check.start);
+   pthread_mutex_destroy(&check.lock);
+
+   free(threads);
+   free(check.slots);
+   free(check.partitionStart);
+   free(check.partitionSize);
+   free(check.files);
+
+   return !check.failed && missingTotal == 0;
+}
+
+/**
+ * The thread function for each worker of a check.  Workers load files,
+ * then build partitions of the export index, then probe files, with a
+ * barrier between each phase.  The thread that leaves the first barrier
+ * with PTHREAD_BARRIER_SERIAL_THREAD sizes the index.  If memory runs
+ * out loading files or sizing the index, the later phases are skipped;
+ * failed only changes before a barrier, so it is read safely after.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *
+ * OUTPUT:  NULL
+ */
+void *linkWorker(void *arg) {
+
+   int index;
+   struct linkCheck *check = arg;
+
+   // Wait until every thread that could be started is counted
+   pthread_mutex_lock(&check->start);
+   pthread_mutex_unlock(&check->start);
+
+   // Build phase, part one: read every file's symbols
+   while ( (index = claimLinkWork(check, &check->nextLoad, check->fileCount)) != -1 ) {
+      if (!loadLinkFile(&check->files[index])) {
+         failLinkCheck(check);
+      }
+   }
+
+   // Size the index
+   if (pthread_barrier_wait(&check->phase) == PTHREAD_BARRIER_SERIAL_THREAD && !check->failed) {
+      sizeExportIndex(check);
+   }
+   pthread_barrier_wait(&check->phase);
+
+   // Build phase, part two: fill the index a partition at a time
+   while ( !check->failed && (index = claimLinkWork(check, &check->nextPartition, 1 << check->partitionBits)) != -1 ) {
+      buildExportPartition(check, index);
+   }
+   pthread_barrier_wait(&check->phase);
+
+   // Probe phase: look up every file's imports
+   while ( !check->failed && (index = claimLinkWork(check, &check->nextProbe, check->fileCount)) != -1 ) {
+      probeLinkFile(check, &check->files[index]);
+   }
+
+   return NULL;
+}
+
+/**
+ * A utility function that marks a check as out of memory.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *
+ * OUTPUT:  none
+ */
+void failLinkCheck(struct linkCheck *check) {
+
+   pthread_mutex_lock(&check->lock);
+   check->failed = true;
+   pthread_mutex_unlock(&check->lock);
+}
+
+/**
+ * A function that sizes each partition of the export index from the
+ * number of exports that fall in it, at no more than half full, so
+ * every partition keeps empty slots to end its probes.  The partitions
+ * are laid out end to end in one allocation.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *
+ * OUTPUT:  none
+ */
+void sizeExportIndex(struct linkCheck *check) {
+
+   int i;
+   int j;
+   int partitionCount = 1 << check->partitionBits;
+   uint64_t size;
+   uint64_t total = 0;
+
+   check->partitionStart = calloc(partitionCount, sizeof(uint64_t));
+   check->partitionSize  = calloc(partitionCount, sizeof(uint64_t));
+   if (check->partitionStart == NULL || check->partitionSize == NULL) {
+      check->failed = true;
+      return;
+   }
+
+   // Count each partition's exports, in place of its size for now
+   for (i=0; i < check->fileCount; i++) {
+      for (j=0; j < check->files[i].exportCount; j++) {
+         check->partitionSize[exportPartition(check, check->files[i].exports[j].hash)]++;
+      }
+   }
+
+   // Then size the partitions and place them
+   for (i=0; i < partitionCount; i++) {
+      size = 16;
+      while (size < 2 * check->partitionSize[i]) {
+         size *= 2;
+      }
+      check->partitionStart[i] = total;
+      check->partitionSize[i]  = size;
+      total += size;
+   }
+
+   if ( (check->slots = calloc(total, sizeof(struct exportSlot))) == NULL ) {
+      check->failed = true;
+   }
+}
+
+/**
+ * A utility function that gives the partition a hash belongs to.  The
+ * hash is mixed first, since the top bits of short names' hashes are
+ * all zero.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *          hash of the name
+ *
+ * OUTPUT:  index of the partition
+ */
+uint64_t exportPartition(const struct linkCheck *check, uint32_t hash) {
+
+   if (check->partitionBits == 0) {
+      return 0;
+   }
+
+   return (uint32_t)(hash * UNRESOLVED_HASH_MIX) >> (32 - check->partitionBits);
+}
+
+/**
+ * A utility function that hands out the next piece of work from one of
+ * the check's counters.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *          pointer to the counter
+ *          number of pieces of work
+ *
+ * OUTPUT:  index of the piece to do
+ *          -1 once every piece is taken
+ */
+int claimLinkWork(struct linkCheck *check, int *next, int limit) {
+
+   int index = -1;
+
+   pthread_mutex_lock(&check->lock);
+   if (*next < limit) {
+      index = (*next)++;
+   }
+   pthread_mutex_unlock(&check->lock);
+
+   return index;
+}
+
+/**
+ * A function that reads a file's dynamic symbol table, sorting the
+ * symbols into exports and imports.  The dynamic string table is
+ * copied so the file can be closed straight away, which keeps tens of
+ * thousands of files from all being mapped at once.  A file without a
+ * dynamic symbol table loads with no symbols.
+ *
+ * INPUT:   pointer to the file to load
+ *
+ * OUTPUT:  true unless memory ran out
+ */
+bool loadLinkFile(struct linkFile *file) {
+
+   int index;
+   uint64_t iter;
+   uint64_t count;
+   uint64_t entSize;
+   uint64_t strtabSize;
+
+   const char *strtab;
+   const unsigned char *table;
+   const struct sectionEntry *section;
+   const struct elfDecoder *decoder;
+
+   struct fileImage image;
+   union fileHeader_union fileHeader;
+   struct sectionTable secTable = {0};
+   union symbol_union *symbols;
+   struct symbol_struct64 *symbol;
+   struct linkSymbol kept;
+
+   if (!openFileImage(file->fileName, &image)) {
+      return true;
+   }
+   if (!readFileHeader(&fileHeader, &image) || !readSectionHeaders(&fileHeader, &secTable, &image)) {
+      freeSectionTable(&secTable);
+      closeFileImage(&image);
+      return true;
+   }
+   file->loaded = true;
+
+   // Locate the dynamic symbols and their names
+   decoder = selectElfDecoder(fileHeader.arr[4], fileHeader.arr[5]);
+   index   = findSectionByType(&secTable, SHT_DYNSYM, 0);
+   section = (index != -1) ? &secTable.sections[index] : NULL;
+   entSize = (section != NULL) ? section->data.Struct.sh_entsize : 0;
+   count   = (entSize >= (uint64_t)decoder->symbolSize) ? section->data.Struct.sh_size / entSize : 0;
+   table   = (count > 0) ? imageAt(&image, section->data.Struct.sh_offset, count * entSize) : NULL;
+   strtab  = (table != NULL) ? findStringTable(&secTable, section, &image, &strtabSize) : NULL;
+
+   if (strtab != NULL) {
+
+      // Keep a copy of the names
+      file->strings     = malloc(strtabSize);
+      file->stringsSize = strtabSize;
+      symbols           = malloc(count * sizeof(union symbol_union));
+      file->exports     = malloc(count * sizeof(struct linkSymbol));
+      file->imports     = malloc(count * sizeof(struct linkSymbol));
+      if (file->strings == NULL || symbols == NULL || file->exports == NULL || file->imports == NULL) {
+         free(symbols);
+         freeSectionTable(&secTable);
+         closeFileImage(&image);
+         return false;
+      }
+      memcpy(file->strings, strtab, strtabSize);
+      decoder->decodeSymbols(table, count, entSize, symbols);
+
+      // Skip the null symbol at index 0
+      for (iter=1; iter < count; iter++) {
+
+         symbol = &symbols[iter].Struct;
+         if (!keepLinkSymbol(file, symbol, &kept)) {
+            continue;
+         }
+
+         // Global undefined symbols must come from somewhere; weak ones may stay unset
+         if (symbol->st_shndx == SHN_UNDEF) {
+            if ((symbol->st_info >> 4) == STB_GLOBAL) {
+               file->imports[file->importCount++] = kept;
+            }
+         }
+
+         // Defined symbols other modules can bind to
+         else if (((symbol->st_info >> 4) == STB_GLOBAL || (symbol->st_info >> 4) == STB_WEAK ||
+                   (symbol->st_info >> 4) == STB_GNU_UNIQUE) &&
+                  (symbol->st_other & 0x3) != STV_HIDDEN && (symbol->st_other & 0x3) != STV_INTERNAL &&
+                  (symbol->st_info & 0xf) != STT_SECTION && (symbol->st_info & 0xf) != STT_FILE) {
+            file->exports[file->exportCount++] = kept;
+         }
+      }
+
+      free(symbols);
+   }
+
+   freeSectionTable(&secTable);
+   closeFileImage(&image);
+
+   return true;
+}
+
+/**
+ * A utility function that checks a symbol's name lies inside the
+ * file's string table and hashes it.
+ *
+ * INPUT:   pointer to the file
+ *          pointer to the decoded symbol
+ *          pointer to store the kept symbol
+ *
+ * OUTPUT:  true if the symbol has a usable name
+ *          false if the name is empty or runs outside the table
+ */
+bool keepLinkSymbol(const struct linkFile *file, const struct symbol_struct64 *symbol, struct linkSymbol *kept) {
+
+   if (symbol->st_name == 0 || symbol->st_name >= file->stringsSize ||
+       memchr(file->strings + symbol->st_name, '\0', file->stringsSize - symbol->st_name) == NULL) {
+      return false;
+   }
+
+   kept->name = symbol->st_name;
+   kept->hash = gnuHash(file->strings + symbol->st_name);
+
+   return true;
+}
+
+/**
+ * A function that inserts every export whose hash falls in one
+ * partition into that partition of the index, probing linearly.  A
+ * name exported by several files is only kept once.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *          partition to build
+ *
+ * OUTPUT:  none
+ */
+void buildExportPartition(struct linkCheck *check, uint64_t partition) {
+
+   int i;
+   int j;
+   uint64_t mask = check->partitionSize[partition] - 1;
+   uint64_t bucket;
+
+   const struct linkFile *file;
+   const struct linkSymbol *symbol;
+   struct exportSlot *slots = check->slots + check->partitionStart[partition];
+   struct exportSlot *slot;
+
+   for (i=0; i < check->fileCount; i++) {
+
+      file = &check->files[i];
+
+      for (j=0; j < file->exportCount; j++) {
+
+         symbol = &file->exports[j];
+
+         // Skip exports that belong to other partitions
+         if (exportPartition(check, symbol->hash) != partition) {
+            continue;
+         }
+
+         bucket = symbol->hash & mask;
+
+         while (true) {
+            slot = &slots[bucket];
+
+            // Claim an empty slot
+            if (slot->file == 0) {
+               slot->hash = symbol->hash;
+               slot->name = symbol->name;
+               slot->file = i + 1;
+               break;
+            }
+
+            // Keep the first file that exports a name
+            if (slot->hash == symbol->hash &&
+                strcmp(check->files[slot->file - 1].strings + slot->name, file->strings + symbol->name) == 0) {
+               break;
+            }
+
+            bucket = (bucket + 1) & mask;
+         }
+      }
+   }
+}
+
+/**
+ * A function that looks a symbol up in the export index.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *          string table the symbol's name is in
+ *          pointer to the symbol
+ *
+ * OUTPUT:  true if some file exports the name
+ *          false otherwise
+ */
+bool findExport(const struct linkCheck *check, const char *strings, const struct linkSymbol *symbol) {
+
+   uint64_t partition = exportPartition(check, symbol->hash);
+   uint64_t mask = check->partitionSize[partition] - 1;
+   uint64_t bucket = symbol->hash & mask;
+
+   const struct exportSlot *slots = check->slots + check->partitionStart[partition];
+   const struct exportSlot *slot;
+
+   // Probe until the name or an empty slot turns up
+   while ( (slot = &slots[bucket])->file != 0 ) {
+      if (slot->hash == symbol->hash &&
+          strcmp(check->files[slot->file - 1].strings + slot->name, strings + symbol->name) == 0) {
+         return true;
+      }
+      bucket = (bucket + 1) & mask;
+   }
+
+   return false;
+}
+
+/**
+ * A function that probes the export index with each of a file's
+ * imports, recording the ones no file provides.
+ *
+ * INPUT:   pointer to the shared linkCheck
+ *          pointer to the file to probe
+ *
+ * OUTPUT:  none, but the file's missing list stays NULL if memory ran
+ *          out
+ */
+void probeLinkFile(struct linkCheck *check, struct linkFile *file) {
+
+   int iter;
+
+   if ( (file->missing = malloc((file->importCount > 0 ? file->importCount : 1) * sizeof(int))) == NULL ) {
+      return;
+   }
+
+   for (iter=0; iter < file->importCount; iter++) {
+      if (!findExport(check, file->strings, &file->imports[iter])) {
+         file->missing[file->missingCount++] = iter;
+      }
+   }
+}
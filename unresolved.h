@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+/// Software Reverse Engineering
+/// ReadELF
+///
+/// @file unresolved.h
+/// @version 1.0
+///
+/// @author Robert Lemon <rlemon@hawaii.edu>
+/// @date 05_mar_2021
+///////////////////////////////////////////////////////////////////////////////
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "customDataTypes.h"
+
+// Global variables
+extern char *programName;
+extern int workerCount;
+
+// Local Prototypes
+bool printUnresolvedSymbols(char *fileNames[], int fileCount, FILE *out, FILE *err);
+void *linkWorker(void *arg);
+void failLinkCheck(struct linkCheck *check);
+void sizeExportIndex(struct linkCheck *check);
+uint64_t exportPartition(const struct linkCheck *check, uint32_t hash);
+bool loadLinkFile(struct linkFile *file);
+bool keepLinkSymbol(const struct linkFile *file, const struct symbol_struct64 *symbol, struct linkSymbol *kept);
+void buildExportPartition(struct linkCheck *check, uint64_t partition);
+bool findExport(const struct linkCheck *check, const char *strings, const struct linkSymbol *symbol);
+void probeLinkFile(struct linkCheck *check, struct linkFile *file);
+int claimLinkWork(struct linkCheck *check, int *next, int limit);
+
+// Other Prototypes
+bool openFileImage(const char *fileName, struct fileImage *image);
+void closeFileImage(struct fileImage *image);
+bool readFileHeader(union fileHeader_union *fileHeader, const struct fileImage *image);
+bool readSectionHeaders(union fileHeader_union *fileHeader, struct sectionTable *secTable, const struct fileImage *image);
+void freeSectionTable(struct sectionTable *secTable);
+const struct elfDecoder *selectElfDecoder(const int elfClass, const int elfData);
+const unsigned char *imageAt(const struct fileImage *image, uint64_t offset, uint64_t size);
+int findSectionByType(const struct sectionTable *secTable, uint32_t type, int start);
+const char *findStringTable(const struct sectionTable *secTable, const struct sectionEntry *section, const struct fileImage *image, uint64_t *strtabSize);
+uint32_t gnuHash(const char *name);
+
+bool openOutputBuffer(struct outputBuffer *buffer, FILE *out);
+void closeOutputBuffer(struct outputBuffer *buffer);
+void flushOutputBuffer(struct outputBuffer *buffer);
+void writeText(struct outputBuffer *buffer, const char *text);
+void writeChar(struct outputBuffer *buffer, char ch);
+void writeSigned(struct outputBuffer *buffer, int64_t value);
+// Defines
+#define SHT_DYNSYM 11
+
+#define SHN_UNDEF 0
+
+#define STB_GLOBAL     1
+#define STB_WEAK       2
+#define STB_GNU_UNIQUE 10
+
+#define STT_SECTION 3
+#define STT_FILE    4
+
+#define STV_INTERNAL 1
+#define STV_HIDDEN   2
+
+#define UNRESOLVED_MAX_THREADS 8
+#define UNRESOLVED_HASH_MIX 0x9E3779B1u
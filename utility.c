@@ -12,25 +12,6 @@
 // Header file
 #include "utility.h"
 
-/**
- * A utility function that prints the usage of this program.
- * This function is called when given poor user input.
- *
- * INPUT:   string, the program name
- *
- * OUTPUT:  none
- */
-void printUsage(char *programName) {
-   fprintf(stderr, "%s: Warning: Nothing to do.\n", programName);
-   fprintf(stderr, "Usage: %s <option(s)> elf-file(s)\n", programName);
-   fprintf(stderr, " Display information about the contents of ELF format files\n");
-   fprintf(stderr, " Options are:\n");
-   fprintf(stderr, "  -h\t\t\tDisplay the ELF file header\n");
-   fprintf(stderr, "  -t\t\t\tDisplay the section details\n");
-   fprintf(stderr, "  -x <name>");
-   fprintf(stderr, "\t\tDump the contents of the section <name> as bytes\n");
-}
-
 /**
  * A utility function that checks the endianness of the 
  * machine running this program, and compares it to the
@@ -65,22 +46,7 @@ bool checkSameEndian(int programEndian) {
  * OUTPUT:  int with swapped endianness
  */
 uint16_t endianSwap16Bit(uint16_t input) {
-
-   union {
-      uint16_t       machineWord;
-      unsigned char  bytes[2];
-   } overlay;
-
-   overlay.machineWord = input;
-
-   // swap bytes
-   unsigned char temp;
-   temp             = overlay.bytes[0];
-   overlay.bytes[0] = overlay.bytes[1];
-   overlay.bytes[1] = temp;
-
-   // Return swapped word
-   return (uint16_t)overlay.machineWord;
+   return __builtin_bswap16(input);
 }
 
 /**
@@ -92,26 +58,7 @@ uint16_t endianSwap16Bit(uint16_t input) {
  * OUTPUT:  int with swapped endianness
  */
 uint32_t endianSwap32Bit(uint32_t input) {
-
-   union {
-      uint32_t       machineWord;
-      unsigned char  bytes[4];
-   } overlay;
-
-   overlay.machineWord = input;
-
-   // swap bytes
-   unsigned char temp;
-   temp             = overlay.bytes[0];
-   overlay.bytes[0] = overlay.bytes[3];
-   overlay.bytes[3] = temp;
-
-   temp             = overlay.bytes[1];
-   overlay.bytes[1] = overlay.bytes[2];
-   overlay.bytes[2] = temp;
-
-   // Return swapped word
-   return (uint32_t)overlay.machineWord;
+   return __builtin_bswap32(input);
 }
 
 /**
@@ -123,72 +70,76 @@ uint32_t endianSwap32Bit(uint32_t input) {
  * OUTPUT:  int with swapped endianness
  */
 uint64_t endianSwap64Bit(uint64_t input) {
+   return __builtin_bswap64(input);
+}
 
-   union {
-      uint64_t       machineWord;
-      unsigned char  bytes[8];
-   } overlay;
+/**
+ * A utility function that hashes a name with 32bit FNV-1a.
+ * Used to index section names.
+ *
+ * INPUT:   string to hash
+ *
+ * OUTPUT:  32bit hash of the string
+ */
+uint32_t hashName(const char *name) {
 
-   overlay.machineWord = input;
+   uint32_t hash = 2166136261u;
 
-   // swap bytes
-   unsigned char temp;
-   temp             = overlay.bytes[0];
-   overlay.bytes[0] = overlay.bytes[7];
-   overlay.bytes[7] = temp;
+   while (*name != '\0') {
+      hash ^= (unsigned char)*name++;
+      hash *= 16777619u;
+   }
 
-   temp             = overlay.bytes[1];
-   overlay.bytes[1] = overlay.bytes[6];
-   overlay.bytes[6] = temp;
+   return hash;
+}
 
-   temp             = overlay.bytes[2];
-   overlay.bytes[2] = overlay.bytes[5];
-   overlay.bytes[5] = temp;
+/**
+ * A utility function to unallocate the memory used by the
+ * section table and its name index.  The table is left empty.
+ *
+ * INPUT:   pointer to the section table
+ *
+ * OUTPUT:  none
+ */
+void freeSectionTable(struct sectionTable *secTable) {
 
-   temp             = overlay.bytes[3];
-   overlay.bytes[3] = overlay.bytes[4];
-   overlay.bytes[4] = temp;
+   free(secTable->sections);
+   free(secTable->nameIndex);
 
-   // Return swapped word
-   return (uint64_t)overlay.machineWord;
+   secTable->sections    = NULL;
+   secTable->count       = 0;
+   secTable->nameIndex   = NULL;
+   secTable->bucketCount = 0;
 }
 
 /**
- * A utility function to iterate over the section header
- * linked list and unallocate the memory used to store the
- * nodes in the list.  The list's head is then set to NULL.
+ * A utility function to unallocate the memory used by the
+ * segment table.  The table is left empty.
  *
- * INPUT:   pointer to a pointer to the LL head
+ * INPUT:   pointer to the segment table
  *
  * OUTPUT:  none
  */
-void freeSecLL(struct sectionNode **startSecLL) {
-
-   struct sectionNode *currNode = *startSecLL;
-   struct sectionNode *nextNode = currNode->next;
-
-   // Check for empty LL
-   if (currNode == NULL) {
-      return;
-   }
+void freeSegmentTable(struct segmentTable *segTable) {
 
-   // Check for one-long LL
-   if (nextNode == NULL) {
-      free(currNode);            // free node
-      *startSecLL = NULL;        // set start ptr to NULL
-   }
+   free(segTable->segments);
 
-   // Iterate over LL, unallocating each node
-   while (nextNode != NULL) {
-      free(currNode);            // free node
-      currNode = nextNode;       // increment currNode
-      nextNode = currNode->next; // increment nextNode
-   }
+   segTable->segments = NULL;
+   segTable->count    = 0;
+}
 
-   // Unallocate tail node
-   free(currNode);
+/**
+ * A utility function to unallocate the memory used by the
+ * symbol table.  The table is left empty.
+ *
+ * INPUT:   pointer to the symbol table
+ *
+ * OUTPUT:  none
+ */
+void freeSymbolTable(struct symbolTable *symTable) {
 
-   // Set start ptr to NULL
-   *startSecLL = NULL;
-};
+   free(symTable->symbols);
 
+   symTable->symbols = NULL;
+   symTable->count   = 0;
+}
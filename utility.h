@@ -17,16 +17,15 @@
 
 #include "customDataTypes.h"
 
-// Global variables
-extern const char *programName;
-
 // Local Prototypes
-void printUsage(char *programName);
 bool checkSameEndian(const int programEndian);
 uint16_t endianSwap16Bit(const uint16_t input);
 uint32_t endianSwap32Bit(const uint32_t input);
 uint64_t endianSwap64Bit(const uint64_t input);
-void freeSecLL(struct sectionNode **startSecLL);
+uint32_t hashName(const char *name);
+void freeSectionTable(struct sectionTable *secTable);
+void freeSegmentTable(struct segmentTable *segTable);
+void freeSymbolTable(struct symbolTable *symTable);
 
 // Defines
 #define BIT32 1